@@ -0,0 +1,140 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <diagnostic_msgs/DiagnosticStatus.h>
+
+namespace cpp_message
+{
+    class Allocation_Scope;
+
+    /**
+     * @brief Heap use of the scopes of one tag since the previous report
+     */
+    struct Allocation_Stats
+    {
+        uint64_t scopes=0;
+        uint64_t allocations=0;
+        uint64_t bytes=0;
+        // Most bytes any one scope held at once
+        uint64_t peak_bytes=0;
+    };
+
+    /**
+     * @class Allocation_Accounting
+     * @brief Heap allocations attributed to tags, e.g. the decode of a BSM
+     *
+     * An Allocation_Scope tags its thread for its lifetime. The malloc hooks of src/Allocation_Hooks.cpp, linked into
+     * cpp_message_node if it is built with CPP_MESSAGE_ALLOCATION_HOOKS, pass every malloc, calloc, realloc and free
+     * to the scope of their thread. That covers operator new as well as the asn1c allocations. Outside a scope a hook
+     * costs one thread local read. A realloc counts as the free of the old block and a new allocation,
+     * the free only once glibc released the old block.
+     *
+     * Sizes are the usable sizes of the blocks, so they include the rounding of the allocator. Frees of blocks
+     * allocated before the scope lower the bytes it holds but are not counted otherwise. Nested scopes only account
+     * to the innermost one.
+     */
+    class Allocation_Accounting
+    {
+        public:
+        /**
+         * @brief Register a tag
+         * @param message_type E.g. BSM
+         * @param direction E.g. decode
+         * @return The id to open scopes of the tag with
+         */
+        size_t add_tag(const std::string& message_type, const std::string& direction);
+
+        /**
+         * @brief Summarize the tags in one diagnostic status each and start the next period
+         * @param node_name Prefix of the status names
+         * @param status Receives the status of every tag in the order the tags were registered
+         */
+        void report(const std::string& node_name, std::vector<diagnostic_msgs::DiagnosticStatus>& status);
+
+        Allocation_Stats stats(size_t tag) const;
+
+        /**
+         * @brief Account a block allocated by this thread. Called by the malloc hooks
+         */
+        static void allocated(void* ptr);
+
+        /**
+         * @brief Account a block about to be freed by this thread. Called by the malloc hooks
+         */
+        static void freeing(void* ptr);
+
+        /**
+         * @brief Usable size of a block a realloc may free, 0 outside a scope. Called by the realloc hook before the
+         * block is handed to glibc, which only frees it if the realloc succeeds
+         */
+        static size_t held_size(void* ptr);
+
+        /**
+         * @brief Account a block of size held_size freed by a realloc of this thread. Called by the realloc hook
+         */
+        static void freed(size_t size);
+
+        /**
+         * @brief Whether the malloc hooks are linked in, as accounting without them records nothing
+         */
+        static bool hooks_installed();
+        static void set_hooks_installed();
+
+        private:
+        friend class Allocation_Scope;
+
+        struct Tag
+        {
+            std::string message_type;
+            std::string direction;
+            Allocation_Stats stats;
+        };
+
+        void close(const Allocation_Scope& scope);
+
+        mutable std::mutex mutex_;
+        std::vector<Tag> tags_;
+    };
+
+    /**
+     * @class Allocation_Scope
+     * @brief Accounts the allocations of its thread to a tag from construction to destruction
+     */
+    class Allocation_Scope
+    {
+        public:
+        Allocation_Scope(Allocation_Accounting& accounting, size_t tag);
+        ~Allocation_Scope();
+
+        Allocation_Scope(const Allocation_Scope&)=delete;
+        Allocation_Scope& operator=(const Allocation_Scope&)=delete;
+
+        private:
+        friend class Allocation_Accounting;
+
+        Allocation_Accounting& accounting_;
+        size_t tag_;
+        Allocation_Scope* previous_;
+        uint64_t allocations_=0;
+        uint64_t bytes_=0;
+        int64_t held_=0;
+        int64_t peak_=0;
+    };
+}
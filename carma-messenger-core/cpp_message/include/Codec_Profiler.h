@@ -0,0 +1,129 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cpp_message
+{
+    enum class Codec_Counter
+    {
+        CYCLES,
+        INSTRUCTIONS,
+        CACHE_MISSES,
+        BRANCH_MISSES,
+        COUNT
+    };
+
+    typedef std::array<uint64_t,static_cast<size_t>(Codec_Counter::COUNT)> Codec_Counter_Values;
+
+    /**
+     * @brief Counters summed over the profiled calls of one codec
+     */
+    struct Codec_Profile
+    {
+        uint64_t calls=0;
+        // Calls during which the counters were not scheduled on the PMU, not part of the sums
+        uint64_t unmeasured=0;
+        Codec_Counter_Values sums {};
+    };
+
+    /**
+     * @class Codec_Profiler
+     * @brief Hardware performance counters of codec calls, summed per codec, e.g. the decode of a BSM
+     *
+     * A Codec_Profile_Scope reads the cycles, instructions, cache misses and branch misses of its thread with
+     * perf_event_open at construction and destruction, and adds the difference to its codec. The counters of a thread
+     * are opened as one group on the first scope of the thread, so they are read with one system call and scheduled
+     * together. If the PMU is shared with other groups the counts are scaled by the time the group was scheduled.
+     *
+     * Kernel time, e.g. of the system calls of a codec, is counted if perf_event_paranoid allows it, otherwise only user
+     * time. Part of the read at both ends is counted with the codec.
+     */
+    class Codec_Profiler
+    {
+        public:
+        /**
+         * @brief Open the counters of the calling thread
+         * @param error Receives why the counters cannot be opened, e.g. a perf_event_paranoid of 3 or a virtual machine
+         * without PMU
+         * @return false if the counters are not available
+         */
+        static bool open_counters(std::string& error);
+
+        /**
+         * @brief Whether the counters of the calling thread count kernel time, once they are open
+         */
+        static bool counting_kernel();
+
+        /**
+         * @brief Register a codec
+         * @return The id to open scopes of the codec with
+         */
+        size_t add_codec(const std::string& message_type, const std::string& direction);
+
+        /**
+         * @brief Add the counts of one call
+         * @param measured false if the counters were not scheduled during the call
+         */
+        void record(size_t codec, const Codec_Counter_Values& counts, bool measured);
+
+        Codec_Profile profile(size_t codec) const;
+
+        /**
+         * @brief Write the sums and the per call averages of every codec as CSV, one line per codec
+         */
+        void write_csv(std::ostream& out) const;
+
+        private:
+        struct Codec
+        {
+            std::string message_type;
+            std::string direction;
+            Codec_Profile profile;
+        };
+
+        mutable std::mutex mutex_;
+        std::vector<Codec> codecs_;
+    };
+
+    /**
+     * @class Codec_Profile_Scope
+     * @brief Counts the calling thread from construction to destruction for a codec. Does nothing if the counters of
+     * the thread cannot be opened
+     */
+    class Codec_Profile_Scope
+    {
+        public:
+        Codec_Profile_Scope(Codec_Profiler& profiler, size_t codec);
+        ~Codec_Profile_Scope();
+
+        Codec_Profile_Scope(const Codec_Profile_Scope&)=delete;
+        Codec_Profile_Scope& operator=(const Codec_Profile_Scope&)=delete;
+
+        private:
+        Codec_Profiler& profiler_;
+        size_t codec_;
+        bool started_;
+        Codec_Counter_Values start_;
+        uint64_t start_enabled_=0;
+        uint64_t start_running_=0;
+    };
+}
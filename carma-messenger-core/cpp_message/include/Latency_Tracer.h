@@ -0,0 +1,137 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <diagnostic_msgs/DiagnosticStatus.h>
+
+// Kept to C++11 as the header is shared with the j2735_convertor
+namespace cpp_message
+{
+    /**
+     * @class Latency_Histogram
+     * @brief Fixed size histogram of latencies in nanoseconds
+     *
+     * Buckets double in width every 8 buckets, so a percentile is at most 12.5% above the recorded latency. Latencies
+     * from about 18 minutes on share the last bucket. The maximum is kept exactly.
+     */
+    class Latency_Histogram
+    {
+        public:
+        static const int SUB_BUCKETS=8;
+        static const int BUCKETS=304;
+
+        void record(uint64_t latency_ns);
+
+        /**
+         * @brief Latency below which the given fraction of the recorded latencies lie
+         * @param fraction Between 0 and 1
+         * @return The upper bound of the bucket holding the percentile, at most the maximum. 0 if nothing is recorded
+         */
+        uint64_t percentile(double fraction) const;
+
+        uint64_t count() const { return count_; }
+        uint64_t max() const { return max_; }
+
+        void clear();
+
+        private:
+        static int bucket_of(uint64_t latency_ns);
+        static uint64_t bucket_upper(int bucket);
+
+        std::array<uint32_t,BUCKETS> counts_ {};
+        uint64_t count_=0;
+        uint64_t max_=0;
+    };
+
+    /**
+     * @brief Span of one stage of one message, as kept for the trace export
+     */
+    struct Latency_Trace_Event
+    {
+        uint32_t stage=0;
+        uint32_t thread_id=0;
+        uint64_t start_ns=0;
+        uint64_t duration_ns=0;
+    };
+
+    /**
+     * @class Latency_Tracer
+     * @brief Latency histograms of the stages messages pass through, and a trace of the latest stage spans
+     *
+     * A stage is registered once per message type, e.g. the decode of a BSM, and every message passing it records
+     * its start and end. The histograms summarize the stages between two diagnostics reports. The latest spans are kept
+     * in a ring buffer with the thread they ran on and can be written as a Chrome trace, which Perfetto and
+     * chrome://tracing show as a timeline per thread.
+     *
+     * Stamps are nanoseconds since epoch, so stages may start at stamps taken by another node or the radio driver.
+     * Spans ending before their start, e.g. from a radio clock running ahead, are counted but not recorded.
+     *
+     * The tracer is thread safe.
+     */
+    class Latency_Tracer
+    {
+        public:
+        /**
+         * @brief Constructor
+         * @param trace_capacity Number of spans kept for the trace export, 0 to keep only the histograms
+         */
+        explicit Latency_Tracer(size_t trace_capacity);
+
+        /**
+         * @brief Register a stage
+         * @return The id to record spans of the stage with
+         */
+        size_t add_stage(const std::string& message_type, const std::string& stage);
+
+        void record(size_t stage, uint64_t start_ns, uint64_t end_ns);
+
+        /**
+         * @brief Summarize the histograms in one diagnostic status per message type and clear them
+         * @param node_name Prefix of the status names
+         * @param status Receives the status of every message type in the order the types were registered
+         */
+        void report(const std::string& node_name, std::vector<diagnostic_msgs::DiagnosticStatus>& status);
+
+        /**
+         * @brief Write the kept spans in the Chrome trace event format, oldest first
+         * @return false if the stream failed
+         */
+        bool write_chrome_trace(std::ostream& out) const;
+
+        Latency_Histogram histogram(size_t stage) const;
+        uint64_t rejected() const;
+
+        private:
+        struct Stage
+        {
+            std::string message_type;
+            std::string name;
+            Latency_Histogram histogram;
+        };
+
+        mutable std::mutex mutex_;
+        std::vector<Stage> stages_;
+        std::vector<Latency_Trace_Event> events_;
+        size_t trace_capacity_;
+        size_t next_event_=0;
+        uint64_t rejected_=0;
+    };
+}
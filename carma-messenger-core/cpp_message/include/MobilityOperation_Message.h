@@ -15,6 +15,7 @@
  * the License.
  */
 #include "cpp_message.h"
+#include "Strategy_Params_Codec.h"
 
 namespace cpp_message
 {
@@ -28,8 +29,18 @@ namespace cpp_message
             static const int STRATEGY_PARAMS_MAX_LENGTH=1000;
             static const int MOBILITY_OPERATION_TEST_ID=243;
             std::string STRATEGY_PARAMS_STRING_DEFAULT="[]";
+
+            bool compact_strategy_params_=false;
         
         public:
+        Mobility_Operation()=default;
+        /**
+         * @brief Constructor
+         * @param compact_strategy_params encode strategy_params in the compact form of Strategy_Params_Codec when it is shorter.
+         * Compact strategy_params are always decoded.
+         */
+        explicit Mobility_Operation(bool compact_strategy_params) : compact_strategy_params_(compact_strategy_params) {}
+
         /**
          * @brief Mobility Operation message decoding function.
          * @param binary_array Container with binary input.
@@ -15,6 +15,7 @@
  * the License.
  */
 #include "cpp_message.h"
+#include "Trajectory_Simplifier.h"
 
 namespace cpp_message
 {
@@ -34,7 +35,21 @@ namespace cpp_message
         static const int OFFSET_UNAVAILABLE=501;
 
         static const int MOBILITYPATH_TEST_ID=242;
+
+        Trajectory_Simplification simplification_;
+
+        /**
+         * @brief Encode a mobility path message as is.
+         */
+        boost::optional<std::vector<uint8_t>> encode_message(const cav_msgs::MobilityPath& plainMessage);
         public:
+        Mobility_Path()=default;
+        /**
+         * @brief Constructor
+         * @param simplification Simplification applied to the trajectory of encoded messages.
+         */
+        explicit Mobility_Path(const Trajectory_Simplification& simplification) : simplification_(simplification) {}
+
         /**
          * @brief Mobility Path message decoding function.
          * @param binary_array Container with binary input.
@@ -45,6 +60,8 @@ namespace cpp_message
          * @brief Mobility Path message encoding function.
          * @param plainMessage Container with MobilityPath ros message.
          * @return encoded byte array, returns ROS warning and an empty optional if encoding fails. 
+         * If simplification is enabled the trajectory is simplified to the tolerance and at most 60 offsets,
+         * and further until the encoded message fits the target size.
          */
         boost::optional<std::vector<uint8_t>> encode_mobility_path_message(cav_msgs::MobilityPath plainMessage);
 
@@ -14,6 +14,8 @@
  * the License.
  */
 #include "cpp_message.h"
+#include "Trajectory_Simplifier.h"
+#include "Strategy_Params_Codec.h"
 
 namespace cpp_message
 {
@@ -44,7 +46,25 @@ namespace cpp_message
         //a vector of pointers to MobilityECEFOffset messages,for deleting unsafely allocated offset messages while encoding.
         std::vector<MobilityECEFOffset_t*> Offset_ptrs;  
 
+        Trajectory_Simplification simplification_;
+        bool compact_strategy_params_=false;
+
+        /**
+         * @brief Encode a mobility request message as is.
+         */
+        boost::optional<std::vector<uint8_t>> encode_message(const cav_msgs::MobilityRequest& plainMessage);
+
         public:
+        Mobility_Request()=default;
+        /**
+         * @brief Constructor
+         * @param simplification Simplification applied to the trajectory of encoded messages.
+         * @param compact_strategy_params encode strategy_params in the compact form of Strategy_Params_Codec when it is shorter.
+         * Compact strategy_params are always decoded.
+         */
+        explicit Mobility_Request(const Trajectory_Simplification& simplification, bool compact_strategy_params=false)
+            : simplification_(simplification), compact_strategy_params_(compact_strategy_params) {}
+
         /**
          * @brief Mobility Request message decoding function.
          * @param binary_array Container with binary input.
@@ -55,6 +75,8 @@ namespace cpp_message
          * @brief Mobility Request message encoding function.
          * @param plainMessage contains mobility request ros message to be encoded as byte array.
          * @return encoded byte array returns an empty optional if encoding fails. 
+         * If simplification is enabled the trajectory is simplified to the tolerance and at most 60 offsets,
+         * and further until the encoded message fits the target size.
          */
         boost::optional<std::vector<uint8_t>> encode_mobility_request_message(cav_msgs::MobilityRequest plainMessage);
 
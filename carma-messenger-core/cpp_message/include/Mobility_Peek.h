@@ -0,0 +1,61 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "cpp_message.h"
+
+namespace cpp_message
+{
+    /**
+     * @brief Fields read from the front of an encoded mobility message
+     */
+    struct Mobility_Envelope
+    {
+        long message_id=0;
+        std::string sender_id;
+        std::string recipient_id;
+        std::string strategy;  // Empty for messages without a strategy
+    };
+
+    /**
+     * @class Mobility_Peek
+     * @brief Reads the header and strategy of an encoded mobility message without decoding its body
+     *
+     * UPER has no field offsets, so the message frame, header and the strategy at the start of the body are decoded
+     * in order with the descriptors of the asn1c library and decoding stops right after them. Large fields at the end
+     * of the body like strategy params and trajectories are never read.
+     */
+    class Mobility_Peek
+    {
+        public:
+        static const long MOBILITY_REQUEST_ID=240;
+        static const long MOBILITY_RESPONSE_ID=241;
+        static const long MOBILITY_PATH_ID=242;
+        static const long MOBILITY_OPERATION_ID=243;
+
+        /**
+         * @brief Read the header and strategy of an encoded mobility message
+         * @param binary_array The encoded MessageFrame
+         * @param envelope Receives the message id, the header ids and the strategy of requests and operations
+         * @return false if the message is not a mobility message or can not be decoded
+         */
+        static bool peek(const std::vector<uint8_t>& binary_array, Mobility_Envelope& envelope);
+
+        /**
+         * @brief Returns true if a recipient id addresses every vehicle. The decoders report ids of invalid length as UNSET
+         */
+        static bool is_broadcast(const std::string& recipient_id);
+    };
+}
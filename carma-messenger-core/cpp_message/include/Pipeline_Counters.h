@@ -0,0 +1,107 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <diagnostic_msgs/DiagnosticStatus.h>
+
+// Kept to C++11 as the header is shared with the j2735_convertor
+namespace cpp_message
+{
+    enum class Pipeline_Counter
+    {
+        FRAMES_IN,
+        FRAMES_OUT,
+        DECODE_FAILURES,
+        ENCODE_FAILURES,
+        DROPS,
+        // Frames skipped on purpose, e.g. addressed to another host or without subscribers, never a warning
+        FILTERED,
+        BYTES_IN,
+        BYTES_OUT,
+        COUNT
+    };
+
+    /**
+     * @class Pipeline_Counters
+     * @brief Counters of the frames of each message type passing through a node
+     *
+     * Counting is a relaxed atomic add, so any thread may count without locking. Message types are registered before
+     * counting starts. Each type also has a queue depth gauge, the depth of the queue the type waits in when the
+     * report is made.
+     *
+     * The report summarizes every type in a diagnostic status holding the totals and the rates since the previous
+     * report. A type whose failures or drops grew since the previous report is reported as a warning, so a node can
+     * log one line per type and report period instead of one line per failed frame. Filtered frames are only counted.
+     */
+    class Pipeline_Counters
+    {
+        public:
+        /**
+         * @brief Register a message type
+         * @return The id to count the type with
+         */
+        size_t add_type(const std::string& message_type);
+
+        void add(size_t type, Pipeline_Counter counter, uint64_t amount=1)
+        {
+            types_[type]->counters[static_cast<size_t>(counter)].fetch_add(amount,std::memory_order_relaxed);
+        }
+
+        void set_queue_depth(size_t type, uint64_t depth)
+        {
+            types_[type]->queue_depth.store(depth,std::memory_order_relaxed);
+        }
+
+        uint64_t get(size_t type, Pipeline_Counter counter) const
+        {
+            return types_[type]->counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Summarize every type in a diagnostic status
+         * @param node_name Prefix of the status names
+         * @param period Seconds since the previous report, to compute the rates
+         * @param status Receives the status of every type in the order the types were registered
+         */
+        void report(const std::string& node_name, double period, std::vector<diagnostic_msgs::DiagnosticStatus>& status);
+
+        /**
+         * @brief Write the totals in the Prometheus text exposition format
+         */
+        void write_metrics(const std::string& node_name, std::ostream& out) const;
+
+        private:
+        static const size_t COUNTERS=static_cast<size_t>(Pipeline_Counter::COUNT);
+
+        struct Type_Counters
+        {
+            std::string message_type;
+            std::array<std::atomic<uint64_t>,COUNTERS> counters;
+            std::atomic<uint64_t> queue_depth;
+            // Totals at the previous report, only used by the reporting thread
+            std::array<uint64_t,COUNTERS> reported;
+        };
+
+        // Atomics cannot move, so every type is allocated on its own
+        std::vector<std::unique_ptr<Type_Counters>> types_;
+    };
+}
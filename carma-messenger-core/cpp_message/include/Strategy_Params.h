@@ -0,0 +1,128 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace cpp_message
+{
+    /**
+     * @brief One key:value entry of a strategy_params string. Both point into the parsed string
+     */
+    struct Strategy_Param
+    {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    /**
+     * @brief Result of parsing a strategy_params string
+     */
+    enum class Strategy_Params_Error
+    {
+        NONE,
+        EMPTY_ENTRY,        // Two adjacent commas or a comma at either end
+        MISSING_SEPARATOR,  // An entry without a colon
+        EMPTY_KEY,          // An entry starting with a colon
+        TOO_MANY_ENTRIES    // More than MAX_PARAMS entries
+    };
+
+    /**
+     * @class Strategy_Params
+     * @brief Tokenizer for the comma separated key:value strategy_params of mobility messages
+     *
+     * The entries are stored as string_view pairs into the parsed string, which has to outlive the parser, and a key
+     * index sorted in place serves lookups as a flat map. Parsing and lookups never allocate. Delimiters are found 16
+     * characters at a time with SSE2 where available.
+     *
+     * A key is split from its value at the first colon, so values may contain colons. Values may be empty. If a key
+     * occurs more than once the first entry is returned by lookups. Unlike splitting with std::getline, a trailing comma
+     * and an entry without a colon are errors.
+     */
+    class Strategy_Params
+    {
+        public:
+        static const size_t MAX_LENGTH=1000;  // Longest strategy_params of a mobility message
+        // The shortest entry "k:" and its comma take 3 characters
+        static const size_t MAX_PARAMS=MAX_LENGTH/3+1;
+
+        /**
+         * @brief Tokenize a strategy_params string, replacing the previously parsed entries
+         * @param params The string to parse. An empty string has no entries
+         * @return NONE on success. On failure the entries before the malformed one are kept
+         */
+        Strategy_Params_Error parse(std::string_view params);
+
+        /**
+         * @brief Returns the number of parsed entries
+         */
+        size_t size() const
+        {
+            return size_;
+        }
+
+        /**
+         * @brief Returns the entries in the order of the parsed string
+         */
+        const Strategy_Param* begin() const
+        {
+            return params_.data();
+        }
+
+        const Strategy_Param* end() const
+        {
+            return params_.data()+size_;
+        }
+
+        const Strategy_Param& operator[](size_t index) const
+        {
+            return params_[index];
+        }
+
+        /**
+         * @brief Returns the value of a key, or an empty optional if the key does not exist
+         */
+        std::optional<std::string_view> get(std::string_view key) const;
+
+        /**
+         * @brief Returns the value of a key as integer, or an empty optional if it does not exist or is not an integer
+         */
+        std::optional<int64_t> get_int(std::string_view key) const;
+
+        /**
+         * @brief Returns the value of a key as double, or an empty optional if it does not exist or is not a number
+         */
+        std::optional<double> get_double(std::string_view key) const;
+
+        /**
+         * @brief Returns the value of a key as bool from true/false or 1/0, or an empty optional otherwise
+         */
+        std::optional<bool> get_bool(std::string_view key) const;
+
+        private:
+        /**
+         * @brief Append the entry between two commas
+         */
+        Strategy_Params_Error add_entry(const char* begin, const char* end, const char* colon);
+
+        std::array<Strategy_Param, MAX_PARAMS> params_;
+        std::array<uint16_t, MAX_PARAMS> sorted_;  // Entry indices sorted by key
+        size_t size_=0;
+    };
+}
@@ -0,0 +1,66 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace cpp_message
+{
+    /**
+     * @class Strategy_Params_Codec
+     * @brief Compact encoding of key:value strategy_params strings
+     *
+     * strategy_params are sent as IA5String, so every character costs 7 bits on air and the compact form only uses
+     * characters 0 to 127 as well. It starts with COMPACT_FLAG, a control character plain text params never start
+     * with, followed by the dictionary version. Every entry then starts with one character holding the dictionary id
+     * of its key in the upper 5 bits and the value type in the lower 2 bits. Keys missing from the dictionary and
+     * string values are written as length and characters, integers without leading zeros as variable length numbers
+     * of 6 bits per character.
+     *
+     * Decoding restores the original text exactly, receivers which do not know the compact form see an unknown
+     * control character instead of misreading it.
+     */
+    class Strategy_Params_Codec
+    {
+        public:
+        static const char COMPACT_FLAG='\x01';
+        static const int DICTIONARY_VERSION=0;
+
+        /**
+         * @brief Encode strategy_params in the compact form
+         * @param params Comma separated key:value pairs
+         * @param compact Receives the compact form
+         * @return false if params are not a well formed key:value list, contain characters outside of IA5 or the
+         *         compact form is not shorter. compact is undefined in that case
+         */
+        static bool encode(std::string_view params, std::string& compact);
+
+        /**
+         * @brief Returns true if received strategy_params are in the compact form
+         */
+        static bool is_compact(std::string_view params)
+        {
+            return !params.empty() && params[0]==COMPACT_FLAG;
+        }
+
+        /**
+         * @brief Decode compact strategy_params into the original text
+         * @return false if the compact form is malformed or of an unknown dictionary version
+         */
+        static bool decode(std::string_view compact, std::string& params);
+    };
+}
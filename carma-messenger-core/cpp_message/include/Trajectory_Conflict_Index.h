@@ -0,0 +1,157 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cav_msgs/MobilityPath.h>
+#include "Trajectory_Converter.h"
+
+namespace cpp_message
+{
+    /**
+     * @brief Earliest conflict of a trajectory with the trajectory of another vehicle
+     */
+    struct Trajectory_Conflict
+    {
+        std::string other_id;
+        uint64_t time=0;        // Time of the first conflicting point of the queried trajectory in milliseconds since epoch
+        uint64_t other_time=0;  // Time of the point of the other trajectory it conflicts with
+        double distance=0.0;  // Distance between the conflicting points in meters
+    };
+
+    /**
+     * @brief Change of the conflict state between the trajectories of two vehicles
+     */
+    struct Trajectory_Conflict_Event
+    {
+        std::string vehicle_id;
+        Trajectory_Conflict conflict;
+        bool in_conflict=false;
+    };
+
+    /**
+     * @class Trajectory_Conflict_Index
+     * @brief Spatio-temporal index over the planned trajectories of the host and neighbor vehicles
+     *
+     * Every trajectory point is placed in a cell of a grid over ECEF space and time whose cell size is the conflict
+     * distance and conflict time window. Two points conflict if they are within the conflict distance and the conflict
+     * time window of each other, so only the cells around each point of a trajectory have to be searched and the cost
+     * of an update does not depend on the number of indexed trajectories.
+     *
+     * Trajectories are keyed by the sender id of their MobilityPath. A newer path replaces the indexed one and a path
+     * is dropped once its last point is older than the conflict time window. The index tracks which pairs of vehicles
+     * are in conflict and reports an event whenever a pair starts or stops conflicting.
+     *
+     * Trajectory points are assumed to be POINT_INTERVAL_MS apart, starting at the location timestamp.
+     *
+     * The index is not thread safe.
+     */
+    class Trajectory_Conflict_Index
+    {
+        public:
+        static const uint64_t POINT_INTERVAL_MS=100;
+
+        /**
+         * @brief Constructor
+         * @param conflict_distance Points closer than this distance in meters conflict
+         * @param conflict_window_ms Points closer than this time in milliseconds conflict
+         */
+        Trajectory_Conflict_Index(double conflict_distance, uint64_t conflict_window_ms);
+
+        /**
+         * @brief Find the vehicles whose indexed trajectory conflicts with a trajectory without indexing it
+         * @param trajectory The trajectory to check
+         * @param vehicle_id Sender id of the trajectory, its own indexed trajectory is ignored
+         * @return The earliest conflict with each other vehicle
+         */
+        std::vector<Trajectory_Conflict> query(const cav_msgs::Trajectory& trajectory, const std::string& vehicle_id) const;
+
+        /**
+         * @brief Index the trajectory of a MobilityPath, replacing the previous trajectory of its sender
+         * @param path The received or sent MobilityPath
+         * @param events Appended with an event for every vehicle pair which started or stopped conflicting
+         */
+        void update(const cav_msgs::MobilityPath& path, std::vector<Trajectory_Conflict_Event>& events);
+
+        /**
+         * @brief Drop every trajectory whose last point is older than the conflict time window
+         * @param now_ms Current time in milliseconds since epoch
+         * @param events Appended with an event for every conflict of a dropped trajectory
+         */
+        void remove_expired(uint64_t now_ms, std::vector<Trajectory_Conflict_Event>& events);
+
+        /**
+         * @brief Returns the number of indexed trajectories
+         */
+        size_t size() const
+        {
+            return slot_index_.size();
+        }
+
+        private:
+        struct Point_Ref
+        {
+            uint32_t slot;
+            uint32_t point;
+        };
+
+        struct Indexed_Trajectory
+        {
+            std::string id;
+            uint64_t start_ms=0;
+            Cartesian_Points ecef;
+            std::vector<uint64_t> cells;  // Cell of every point
+            std::unordered_map<std::string, Trajectory_Conflict> conflicts;  // Current conflicts by other vehicle id
+            bool used=false;
+        };
+
+        /**
+         * @brief Returns the key of the cell with the provided cell coordinates
+         */
+        static uint64_t cell_key(int64_t x, int64_t y, int64_t z, int64_t t);
+
+        /**
+         * @brief Compute the cell coordinates of a point
+         */
+        void cell_of(double x, double y, double z, uint64_t time_ms, int64_t (&cell)[4]) const;
+
+        /**
+         * @brief Collect the earliest conflict with each other trajectory. skip_slot is not reported
+         */
+        std::vector<Trajectory_Conflict> find_conflicts(const Cartesian_Points& ecef, uint64_t start_ms, int64_t skip_slot) const;
+
+        /**
+         * @brief Remove the points of a trajectory from the grid
+         */
+        void remove_points(uint32_t slot);
+
+        /**
+         * @brief Remove a trajectory from the index and clear its conflicts
+         */
+        void remove_slot(uint32_t slot, std::vector<Trajectory_Conflict_Event>& events);
+
+        double conflict_distance_;
+        uint64_t conflict_window_ms_;
+
+        std::vector<Indexed_Trajectory> slots_;
+        std::vector<uint32_t> free_slots_;
+        std::unordered_map<std::string, uint32_t> slot_index_;  // Slot by vehicle id
+        std::unordered_map<uint64_t, std::vector<Point_Ref>> cells_;
+        Cartesian_Points scratch_;
+    };
+}
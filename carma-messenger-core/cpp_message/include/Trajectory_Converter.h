@@ -0,0 +1,127 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <cstddef>
+#include <vector>
+#include <cav_msgs/Trajectory.h>
+
+namespace cpp_message
+{
+    /**
+     * @brief Trajectory points in meters stored as structure of arrays, either ECEF or local east/north/up
+     */
+    struct Cartesian_Points
+    {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+
+        void resize(size_t size)
+        {
+            x.resize(size);
+            y.resize(size);
+            z.resize(size);
+        }
+
+        size_t size() const
+        {
+            return x.size();
+        }
+
+        bool empty() const
+        {
+            return x.empty();
+        }
+    };
+
+    /**
+     * @brief WGS84 trajectory points stored as structure of arrays. Latitude and longitude in degrees, height in meters
+     */
+    struct Geodetic_Points
+    {
+        std::vector<double> latitude;
+        std::vector<double> longitude;
+        std::vector<double> height;
+
+        void resize(size_t size)
+        {
+            latitude.resize(size);
+            longitude.resize(size);
+            height.resize(size);
+        }
+
+        size_t size() const
+        {
+            return latitude.size();
+        }
+
+        bool empty() const
+        {
+            return latitude.empty();
+        }
+    };
+
+    /**
+     * @class Trajectory_Converter
+     * @brief Batch conversion of mobility message trajectories into geodetic or local coordinates
+     *
+     * A cav_msgs::Trajectory holds an ECEF start location in centimeters followed by offsets in centimeters, each one
+     * relative to the previous point. The offsets are integrated once into absolute ECEF points which are then
+     * converted as a whole.
+     *
+     * ECEF to geodetic uses the closed form solution of Heikkinen, so every point costs the same fixed number of
+     * operations with sub-millimeter error near the Earth surface instead of iterating until convergence. The
+     * conversion loops work on structure of arrays without branches so the compiler can vectorize them.
+     */
+    class Trajectory_Converter
+    {
+        public:
+        static const int OFFSET_UNAVAILABLE=501; // Offset value set by the decoders for out of range offsets
+
+        /**
+         * @brief Integrate the offsets of a trajectory into absolute ECEF points
+         * @param trajectory The trajectory of a MobilityPath or MobilityRequest
+         * @param ecef Resized to hold the start location followed by one point per offset, in meters.
+         *             Integration stops at the first unavailable offset.
+         * @return The number of points
+         */
+        static size_t integrate_offsets(const cav_msgs::Trajectory& trajectory, Cartesian_Points& ecef);
+
+        /**
+         * @brief Convert ECEF points into WGS84 latitude, longitude and height
+         * @param ecef Points in meters
+         * @param geodetic Resized to the number of points
+         */
+        static void ecef_to_geodetic(const Cartesian_Points& ecef, Geodetic_Points& geodetic);
+
+        /**
+         * @brief Convert ECEF points into a local east/north/up frame
+         * @param ecef Points in meters
+         * @param ref_latitude Latitude of the frame origin in degrees
+         * @param ref_longitude Longitude of the frame origin in degrees
+         * @param ref_height Height of the frame origin above the ellipsoid in meters
+         * @param local Resized to the number of points
+         */
+        static void ecef_to_local(const Cartesian_Points& ecef, double ref_latitude, double ref_longitude,
+                                  double ref_height, Cartesian_Points& local);
+
+        /**
+         * @brief Convert a WGS84 latitude and longitude in degrees and height in meters into ECEF meters
+         */
+        static void geodetic_to_ecef(double latitude, double longitude, double height, double& x, double& y,
+                                     double& z);
+    };
+}
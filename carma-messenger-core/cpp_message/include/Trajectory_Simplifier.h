@@ -0,0 +1,107 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+#include <cav_msgs/Trajectory.h>
+
+namespace cpp_message
+{
+    /**
+     * @brief Encoder option to simplify outgoing trajectories. Disabled by default
+     */
+    struct Trajectory_Simplification
+    {
+        bool enabled=false;
+        double tolerance=0.1;  // Maximum distance in meters between a dropped point and the simplified path
+        size_t max_bytes=0;    // Target size of the encoded message in bytes, 0 for no target
+    };
+
+    /**
+     * @class Trajectory_Simplifier
+     * @brief Douglas-Peucker simplification of mobility message trajectories
+     *
+     * Points are kept by refining the segment with the largest error first, so the simplified trajectory is the best
+     * one found for the allowed number of offsets. A segment whose end points are further apart than an offset can
+     * express is always split, so the simplified offsets stay within the message range.
+     *
+     * Receivers expect a fixed time between trajectory points, which the simplified trajectory no longer has. The
+     * simplified path stays within the tolerance of the original path but its points are not evenly spaced in time,
+     * so receivers which time points by their index, like Trajectory_Conflict_Index, read wrong times from it.
+     */
+    class Trajectory_Simplifier
+    {
+        public:
+        static const int OFFSET_MIN=-500;
+        static const int OFFSET_MAX=500;
+
+        /**
+         * @brief Encodes the message holding the trajectory passed to encode_simplified in its current state
+         */
+        using Encoder=std::function<boost::optional<std::vector<uint8_t>>()>;
+
+        /**
+         * @brief Simplify a trajectory
+         * @param trajectory The trajectory to simplify
+         * @param tolerance Maximum distance in meters between a dropped point and the simplified path
+         * @param max_offsets Maximum number of offsets of the simplified trajectory
+         * @param output The simplified trajectory. Its start location is the start location of the input
+         * @return false if the offsets out of range can not be split below max_offsets or the trajectory
+         *         contains unavailable offsets or offsets outside the J2735 range, output is left unchanged in that case
+         */
+        static bool simplify(const cav_msgs::Trajectory& trajectory, double tolerance, size_t max_offsets,
+                             cav_msgs::Trajectory& output);
+
+        /**
+         * @brief Encode a message with its trajectory simplified, further until it fits the target size
+         * @param trajectory Trajectory of the message encode encodes. Holds the trajectory that was last encoded
+         *        on return, the original one if it could not be simplified
+         * @param simplification Tolerance and target size. If disabled the message is encoded as is
+         * @param max_offsets Maximum number of offsets the message can hold
+         * @param encode Encodes the message with the current content of trajectory
+         * @param message_type For the warnings, e.g. mobility path
+         * @return The smallest encoding found. The encoding of the original trajectory if simplification fails
+         */
+        static boost::optional<std::vector<uint8_t>> encode_simplified(cav_msgs::Trajectory& trajectory,
+            const Trajectory_Simplification& simplification, size_t max_offsets, const Encoder& encode,
+            const std::string& message_type);
+
+        private:
+        struct Segment
+        {
+            size_t start;
+            size_t end;
+            size_t split;     // Point with the largest distance to the segment
+            double error;     // Distance of the split point in centimeters
+            bool mandatory;   // The segment can not be expressed as one offset
+
+            bool operator<(const Segment& other) const
+            {
+                return mandatory!=other.mandatory ? other.mandatory : error<other.error;
+            }
+        };
+
+        /**
+         * @brief Build the segment between two points of an integrated trajectory in centimeters
+         */
+        static Segment make_segment(const std::vector<int64_t>& x, const std::vector<int64_t>& y,
+                                    const std::vector<int64_t>& z, size_t start, size_t end);
+    };
+}
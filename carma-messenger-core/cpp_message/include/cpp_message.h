@@ -25,6 +25,8 @@ extern "C"
 #include <ros/ros.h>
 #include <carma_utils/CARMAUtils.h>
 #include <cav_msgs/ByteArray.h>
+#include <std_srvs/Trigger.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
 #include <j2735_msgs/TrafficControlRequest.h>
 #include <j2735_msgs/TrafficControlMessage.h>
 #include <cav_msgs/MobilityHeader.h>
@@ -33,6 +35,17 @@ extern "C"
 #include <cav_msgs/MobilityPath.h>
 #include <cav_msgs/MobilityRequest.h>
 #include <j2735_msgs/BSM.h>
+#include <cpp_message/TrajectoryConflict.h>
+#include <cpp_message/MobilityMessageCounts.h>
+#include "Trajectory_Conflict_Index.h"
+#include "Trajectory_Simplifier.h"
+#include "Mobility_Peek.h"
+#include "Latency_Tracer.h"
+#include "Pipeline_Counters.h"
+#include "Allocation_Accounting.h"
+#include "Codec_Profiler.h"
+#include <optional>
+#include <unordered_map>
 
 
 namespace cpp_message
@@ -67,6 +80,68 @@ private:
     ros::Subscriber mobility_request_message_sub_;    //outgoing plain mobility request message
     ros::Publisher bsm_message_pub_;     //incoming bsm message
     ros::Subscriber bsm_message_sub_;    //outgoing plain bsm message
+    ros::Publisher trajectory_conflict_pub_; //conflict changes between the incoming and outgoing mobility paths
+
+    // index of the trajectories of the incoming and outgoing mobility paths, null if trajectory_conflicts is disabled
+    std::shared_ptr<Trajectory_Conflict_Index> trajectory_conflict_index_;
+    std::vector<Trajectory_Conflict_Event> trajectory_conflict_events_;
+
+    // simplification of the trajectories of outgoing mobility path and request messages
+    Trajectory_Simplification trajectory_simplification_;
+
+    // encode strategy_params of outgoing mobility operation and request messages in the compact form
+    bool compact_strategy_params_=false;
+
+    // per strategy publishers of incoming mobility operation and request messages, keyed by strategy
+    struct Strategy_Route
+    {
+        ros::Publisher mobility_operation_pub;
+        ros::Publisher mobility_request_pub;
+    };
+    std::unordered_map<std::string, Strategy_Route> strategy_routes_;
+
+    // static id of this vehicle, mobility messages addressed to another vehicle are dropped. Empty to keep all
+    std::string host_id_;
+    cpp_message::MobilityMessageCounts mobility_counts_;
+    ros::Publisher mobility_counts_pub_;
+    ros::Timer mobility_counts_timer_;
+
+    // frames of each message type in and out of this node, reported on /diagnostics with the latency histograms
+    Pipeline_Counters pipeline_counters_;
+    std::unordered_map<std::string, size_t> inbound_counter_types_, outbound_counter_types_; //keyed by messageType
+    size_t other_inbound_counter_type_=0;
+    size_t inbound_counter_type_=0; //type of the incoming message being handled
+    double diagnostics_period_=1.0;
+    ros::Publisher diagnostics_pub_;
+    ros::Timer diagnostics_timer_;
+    ros::ServiceServer metrics_service_;
+
+    // latency of incoming messages from the radio to their publication, only traced if latency_tracing is set
+    struct Inbound_Trace_Stages
+    {
+        size_t receive;  // radio receive stamp of the binary message to the start of its decode
+        size_t decode;
+        size_t publish;
+        size_t total;
+    };
+    std::shared_ptr<Latency_Tracer> latency_tracer_;
+    std::unordered_map<std::string, Inbound_Trace_Stages> inbound_trace_stages_;
+    const Inbound_Trace_Stages* inbound_trace_=nullptr; //stages of the message being handled, null if not traced
+    ros::Time inbound_receive_stamp_, inbound_decode_start_, inbound_decode_end_;
+    std::string latency_trace_file_;
+    ros::ServiceServer export_latency_trace_service_;
+
+    // heap allocations of the codec calls, only accounted if allocation_accounting is set and the malloc hooks are built in
+    std::shared_ptr<Allocation_Accounting> allocation_accounting_;
+    // hardware counters of the codec calls, only profiled if codec_profiling is set and perf_event_open is available
+    std::shared_ptr<Codec_Profiler> codec_profiler_;
+    ros::ServiceServer export_codec_profile_service_;
+    struct Codec_Ids
+    {
+        size_t allocation_tag=0;
+        size_t profile=0;
+    };
+    std::unordered_map<std::string, Codec_Ids> decode_codecs_, encode_codecs_; //keyed by messageType
     
 
     /**
@@ -74,6 +149,79 @@ private:
      */
     void initialize();
 
+    /**
+     * @brief Advertise the per strategy topics of incoming mobility operation and request messages.
+     * @param strategies the strategies to route. A strategy is published on incoming_mobility_operation/<strategy>
+     * and incoming_mobility_request/<strategy>, invalid topic name characters are replaced by underscores.
+     */
+    void advertise_strategy_routes(const std::vector<std::string>& strategies);
+    /**
+     * @brief Decide whether an incoming mobility message is decoded, reading only its header and strategy.
+     * @param array the encoded message.
+     * @param general_pub the publisher of the decoded message type. If set, messages which neither it nor the
+     * per strategy publisher has subscribers for are dropped.
+     * @param strategy_pub set to the per strategy publisher the decoded message is also published on, if any.
+     * @return false if the message is dropped because it is addressed to another vehicle or nobody subscribes to it.
+     */
+    bool filter_mobility_message(const std::vector<uint8_t>& array, const ros::Publisher* general_pub, const ros::Publisher*& strategy_pub);
+    /**
+     * @brief Publish the counts of received and dropped incoming mobility messages.
+     */
+    void mobility_counts_timer_callback(const ros::TimerEvent& event);
+    /**
+     * @brief Count an incoming message and take its stamps on the way through inbound_binary_callback.
+     * The radio receive stamp is the header stamp of the binary message, or the decode start if it is not set.
+     * Only the latency of messages which are published is recorded.
+     */
+    void begin_inbound(const cav_msgs::ByteArray& msg);
+    void inbound_decoded();
+    void inbound_decode_failed();
+    void inbound_published();
+    /**
+     * @brief Count an outgoing message and the result of its encoding.
+     */
+    void count_outbound(const std::string& message_type, const boost::optional<std::vector<uint8_t>>& encoded);
+    /**
+     * @brief Call a codec, accounting its allocations and profiling it under the message type if either is enabled.
+     */
+    template<class Codec>
+    auto instrument_codec(const std::unordered_map<std::string, Codec_Ids>& codecs, const std::string& message_type, Codec codec) -> decltype(codec())
+    {
+        if(!allocation_accounting_ && !codec_profiler_)
+        {
+            return codec();
+        }
+        const Codec_Ids& ids=codecs.at(message_type);
+        std::optional<Allocation_Scope> allocations;
+        std::optional<Codec_Profile_Scope> profile;
+        if(allocation_accounting_)
+        {
+            allocations.emplace(*allocation_accounting_,ids.allocation_tag);
+        }
+        if(codec_profiler_)
+        {
+            profile.emplace(*codec_profiler_,ids.profile);
+        }
+        return codec();
+    }
+    /**
+     * @brief Publish the frame counters, the latency histograms and the codec allocations on /diagnostics. Message types with new failures
+     * or drops are logged as one warning per type and period.
+     */
+    void diagnostics_timer_callback(const ros::TimerEvent& event);
+    /**
+     * @brief Return the frame counters in the Prometheus text format as the response message.
+     */
+    bool metrics_callback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp);
+    /**
+     * @brief Write the latest traced stages to latency_trace_file in the Chrome trace format, for Perfetto or chrome://tracing.
+     */
+    bool export_latency_trace_callback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp);
+    /**
+     * @brief Return the hardware counters summed per codec since the start as CSV in the response message.
+     */
+    bool export_codec_profile_callback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp);
+
     // callbacks for subscribers
     void inbound_binary_callback(const cav_msgs::ByteArrayConstPtr& msg);
     void outbound_control_message_callback(const j2735_msgs::TrafficControlMessageConstPtr& msg);
@@ -108,6 +256,11 @@ private:
      * The encoded message is published as outbound binary message. Failure to encode results in a ROS Warning.
      */
     void outbound_bsm_message_callback(const j2735_msgs::BSM& msg);
+    /**
+     * @brief Index the trajectory of a received or sent mobility path and publish the resulting conflict changes.
+     * @param msg the mobility path. Expired trajectories are dropped from the index first.
+     */
+    void update_trajectory_conflicts(const cav_msgs::MobilityPath& msg);
     
 public:
 
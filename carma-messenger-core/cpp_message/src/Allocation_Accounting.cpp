@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Allocation Accounting method implementations
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <malloc.h>
+#include "Allocation_Accounting.h"
+
+namespace cpp_message
+{
+    namespace
+    {
+        // Read by every hooked malloc and free. Initial exec keeps the read from allocating the thread local storage
+        // of the shared library lazily, which would recurse into malloc
+        __attribute__((tls_model("initial-exec"))) thread_local Allocation_Scope* current_scope=nullptr;
+
+        std::atomic<bool> hooks_linked(false);
+
+        diagnostic_msgs::KeyValue key_value(const std::string& key, const std::string& value)
+        {
+            diagnostic_msgs::KeyValue kv;
+            kv.key=key;
+            kv.value=value;
+            return kv;
+        }
+
+        std::string format_average(uint64_t total, uint64_t scopes)
+        {
+            char buffer[32];
+            snprintf(buffer,sizeof(buffer),"%.1f",scopes>0 ? static_cast<double>(total)/scopes : 0.0);
+            return buffer;
+        }
+    }
+
+    size_t Allocation_Accounting::add_tag(const std::string& message_type, const std::string& direction)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tags_.push_back(Tag());
+        tags_.back().message_type=message_type;
+        tags_.back().direction=direction;
+        return tags_.size()-1;
+    }
+
+    void Allocation_Accounting::report(const std::string& node_name, std::vector<diagnostic_msgs::DiagnosticStatus>& status)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(Tag& tag : tags_)
+        {
+            const Allocation_Stats& stats=tag.stats;
+            diagnostic_msgs::DiagnosticStatus tag_status;
+            tag_status.level=diagnostic_msgs::DiagnosticStatus::OK;
+            tag_status.name=node_name+": "+tag.message_type+" "+tag.direction+" allocations";
+            tag_status.hardware_id=node_name;
+            tag_status.message=stats.scopes>0 ? "OK" : "No calls";
+            tag_status.values.push_back(key_value("calls",std::to_string(stats.scopes)));
+            tag_status.values.push_back(key_value("allocations per call",format_average(stats.allocations,stats.scopes)));
+            tag_status.values.push_back(key_value("bytes per call",format_average(stats.bytes,stats.scopes)));
+            tag_status.values.push_back(key_value("peak bytes",std::to_string(stats.peak_bytes)));
+            status.push_back(tag_status);
+            tag.stats=Allocation_Stats();
+        }
+    }
+
+    Allocation_Stats Allocation_Accounting::stats(size_t tag) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tag<tags_.size() ? tags_[tag].stats : Allocation_Stats();
+    }
+
+    void Allocation_Accounting::close(const Allocation_Scope& scope)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(scope.tag_>=tags_.size())
+        {
+            return;
+        }
+        Allocation_Stats& stats=tags_[scope.tag_].stats;
+        stats.scopes++;
+        stats.allocations+=scope.allocations_;
+        stats.bytes+=scope.bytes_;
+        stats.peak_bytes=std::max(stats.peak_bytes,static_cast<uint64_t>(scope.peak_));
+    }
+
+    void Allocation_Accounting::allocated(void* ptr)
+    {
+        Allocation_Scope* scope=current_scope;
+        if(!scope || !ptr)
+        {
+            return;
+        }
+        size_t size=malloc_usable_size(ptr);
+        scope->allocations_++;
+        scope->bytes_+=size;
+        scope->held_+=size;
+        scope->peak_=std::max(scope->peak_,scope->held_);
+    }
+
+    void Allocation_Accounting::freeing(void* ptr)
+    {
+        Allocation_Scope* scope=current_scope;
+        if(!scope || !ptr)
+        {
+            return;
+        }
+        scope->held_-=malloc_usable_size(ptr);
+    }
+
+    size_t Allocation_Accounting::held_size(void* ptr)
+    {
+        if(!current_scope || !ptr)
+        {
+            return 0;
+        }
+        return malloc_usable_size(ptr);
+    }
+
+    void Allocation_Accounting::freed(size_t size)
+    {
+        Allocation_Scope* scope=current_scope;
+        if(!scope)
+        {
+            return;
+        }
+        scope->held_-=size;
+    }
+
+    bool Allocation_Accounting::hooks_installed()
+    {
+        return hooks_linked.load();
+    }
+
+    void Allocation_Accounting::set_hooks_installed()
+    {
+        hooks_linked.store(true);
+    }
+
+    Allocation_Scope::Allocation_Scope(Allocation_Accounting& accounting, size_t tag) :
+        accounting_(accounting), tag_(tag), previous_(current_scope)
+    {
+        current_scope=this;
+    }
+
+    Allocation_Scope::~Allocation_Scope()
+    {
+        // Restored first, so the lock taken by close is not accounted to this scope
+        current_scope=previous_;
+        accounting_.close(*this);
+    }
+}
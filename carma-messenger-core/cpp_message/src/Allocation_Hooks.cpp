@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * Malloc hooks of the allocation accounting, only linked into cpp_message_node if it is built with
+ * CPP_MESSAGE_ALLOCATION_HOOKS. Defined in the executable they replace the glibc functions for the whole process,
+ * including libasn1c, and forward to the glibc implementations.
+ */
+#include <cerrno>
+#include <cstddef>
+#include "Allocation_Accounting.h"
+
+using cpp_message::Allocation_Accounting;
+
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* ptr);
+
+    void* malloc(size_t size)
+    {
+        void* ptr=__libc_malloc(size);
+        Allocation_Accounting::allocated(ptr);
+        return ptr;
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        void* ptr=__libc_calloc(count,size);
+        Allocation_Accounting::allocated(ptr);
+        return ptr;
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        size_t held=Allocation_Accounting::held_size(ptr);
+        void* result=__libc_realloc(ptr,size);
+        // A failed realloc leaves the old block live, one of size 0 frees it and returns null
+        if(result || size==0)
+        {
+            Allocation_Accounting::freed(held);
+        }
+        Allocation_Accounting::allocated(result);
+        return result;
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        void* ptr=__libc_memalign(alignment,size);
+        Allocation_Accounting::allocated(ptr);
+        return ptr;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        return memalign(alignment,size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size)
+    {
+        if(alignment%sizeof(void*)!=0 || (alignment&(alignment-1))!=0)
+        {
+            return EINVAL;
+        }
+        void* ptr=memalign(alignment,size);
+        if(!ptr)
+        {
+            return ENOMEM;
+        }
+        *result=ptr;
+        return 0;
+    }
+
+    void free(void* ptr)
+    {
+        Allocation_Accounting::freeing(ptr);
+        __libc_free(ptr);
+    }
+}
+
+namespace
+{
+    struct Hooks_Installed
+    {
+        Hooks_Installed()
+        {
+            Allocation_Accounting::set_hooks_installed();
+        }
+    } hooks_installed;
+}
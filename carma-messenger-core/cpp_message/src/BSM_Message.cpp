@@ -92,7 +92,7 @@ namespace cpp_message
             
             return boost::optional<j2735_msgs::BSM>(output);
         }
-        ROS_WARN_STREAM("BasicSafetyMessage decoding failed");
+        ROS_DEBUG_STREAM("BasicSafetyMessage decoding failed");
         return boost::optional<j2735_msgs::BSM>{};
 
     }
@@ -115,7 +115,7 @@ namespace cpp_message
         //if mem allocation fails
         if(!message)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for BasicSafetyMessage encoding");
+            ROS_DEBUG_STREAM("Cannot allocate mem for BasicSafetyMessage encoding");
             return boost::optional<std::vector<uint8_t>>{};
         }
 
@@ -210,7 +210,7 @@ namespace cpp_message
         
         //log a warning if that fails
         if(ec.encoded == -1) {
-            ROS_WARN_STREAM("Encoding for BasicSafetyMessage has failed");
+            ROS_DEBUG_STREAM("Encoding for BasicSafetyMessage has failed");
             std::cout << "Failed: " << ec.failed_type->name << std::endl;
             return boost::optional<std::vector<uint8_t>>{};
         }
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Codec Profiler method implementations
+ */
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "Codec_Profiler.h"
+
+namespace cpp_message
+{
+    namespace
+    {
+        const size_t COUNTERS=static_cast<size_t>(Codec_Counter::COUNT);
+        const uint64_t CONFIGS[COUNTERS]={PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,PERF_COUNT_HW_CACHE_MISSES,PERF_COUNT_HW_BRANCH_MISSES};
+        const char* const COUNTER_NAMES[COUNTERS]={"cycles","instructions","cache_misses","branch_misses"};
+
+        /**
+         * Counter group of one thread, closed when the thread exits
+         */
+        struct Thread_Counters
+        {
+            std::array<int,COUNTERS> fds {{-1,-1,-1,-1}};
+            bool tried=false;
+            bool opened=false;
+            bool kernel=false;
+            std::string error;
+
+            ~Thread_Counters()
+            {
+                close_all();
+            }
+
+            void close_all()
+            {
+                for(int& fd : fds)
+                {
+                    if(fd>=0)
+                    {
+                        close(fd);
+                        fd=-1;
+                    }
+                }
+            }
+
+            bool open_group(bool exclude_kernel)
+            {
+                for(size_t i=0;i<COUNTERS;i++)
+                {
+                    perf_event_attr attr;
+                    memset(&attr,0,sizeof(attr));
+                    attr.size=sizeof(attr);
+                    attr.type=PERF_TYPE_HARDWARE;
+                    attr.config=CONFIGS[i];
+                    attr.read_format=PERF_FORMAT_GROUP|PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+                    attr.exclude_kernel=exclude_kernel ? 1 : 0;
+                    attr.exclude_hv=1;
+                    // This thread on any CPU, the first counter leads the group
+                    fds[i]=static_cast<int>(syscall(__NR_perf_event_open,&attr,0,-1,i==0 ? -1 : fds[0],PERF_FLAG_FD_CLOEXEC));
+                    if(fds[i]<0)
+                    {
+                        error=std::string("perf_event_open of ")+COUNTER_NAMES[i]+" failed: "+strerror(errno);
+                        close_all();
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            bool open()
+            {
+                if(!tried)
+                {
+                    tried=true;
+                    // Unprivileged users may only count user time with a perf_event_paranoid of 2
+                    kernel=open_group(false);
+                    opened=kernel || open_group(true);
+                }
+                return opened;
+            }
+
+            bool read_values(Codec_Counter_Values& values, uint64_t& enabled, uint64_t& running)
+            {
+                // nr, time enabled, time running and the values of the group
+                uint64_t buffer[3+COUNTERS];
+                if(read(fds[0],buffer,sizeof(buffer))!=static_cast<ssize_t>(sizeof(buffer)) || buffer[0]!=COUNTERS)
+                {
+                    return false;
+                }
+                enabled=buffer[1];
+                running=buffer[2];
+                for(size_t i=0;i<COUNTERS;i++)
+                {
+                    values[i]=buffer[3+i];
+                }
+                return true;
+            }
+        };
+
+        thread_local Thread_Counters thread_counters;
+
+        std::string format_average(uint64_t total, uint64_t calls)
+        {
+            char buffer[32];
+            snprintf(buffer,sizeof(buffer),"%.1f",calls>0 ? static_cast<double>(total)/calls : 0.0);
+            return buffer;
+        }
+    }
+
+    bool Codec_Profiler::open_counters(std::string& error)
+    {
+        bool opened=thread_counters.open();
+        error=thread_counters.error;
+        return opened;
+    }
+
+    bool Codec_Profiler::counting_kernel()
+    {
+        return thread_counters.opened && thread_counters.kernel;
+    }
+
+    size_t Codec_Profiler::add_codec(const std::string& message_type, const std::string& direction)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        codecs_.push_back(Codec());
+        codecs_.back().message_type=message_type;
+        codecs_.back().direction=direction;
+        return codecs_.size()-1;
+    }
+
+    void Codec_Profiler::record(size_t codec, const Codec_Counter_Values& counts, bool measured)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(codec>=codecs_.size())
+        {
+            return;
+        }
+        Codec_Profile& profile=codecs_[codec].profile;
+        profile.calls++;
+        if(!measured)
+        {
+            profile.unmeasured++;
+            return;
+        }
+        for(size_t i=0;i<COUNTERS;i++)
+        {
+            profile.sums[i]+=counts[i];
+        }
+    }
+
+    Codec_Profile Codec_Profiler::profile(size_t codec) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return codec<codecs_.size() ? codecs_[codec].profile : Codec_Profile();
+    }
+
+    void Codec_Profiler::write_csv(std::ostream& out) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out<<"type,direction,calls,unmeasured";
+        for(const char* name : COUNTER_NAMES)
+        {
+            out<<","<<name;
+        }
+        for(const char* name : COUNTER_NAMES)
+        {
+            out<<","<<name<<"_per_call";
+        }
+        out<<",instructions_per_cycle\n";
+
+        for(const Codec& codec : codecs_)
+        {
+            const Codec_Profile& profile=codec.profile;
+            uint64_t measured=profile.calls-profile.unmeasured;
+            out<<codec.message_type<<","<<codec.direction<<","<<profile.calls<<","<<profile.unmeasured;
+            for(uint64_t sum : profile.sums)
+            {
+                out<<","<<sum;
+            }
+            for(uint64_t sum : profile.sums)
+            {
+                out<<","<<format_average(sum,measured);
+            }
+            char ipc[32];
+            uint64_t cycles=profile.sums[static_cast<size_t>(Codec_Counter::CYCLES)];
+            snprintf(ipc,sizeof(ipc),"%.2f",cycles>0 ? static_cast<double>(profile.sums[static_cast<size_t>(Codec_Counter::INSTRUCTIONS)])/cycles : 0.0);
+            out<<","<<ipc<<"\n";
+        }
+    }
+
+    Codec_Profile_Scope::Codec_Profile_Scope(Codec_Profiler& profiler, size_t codec) : profiler_(profiler), codec_(codec)
+    {
+        started_=thread_counters.open() && thread_counters.read_values(start_,start_enabled_,start_running_);
+    }
+
+    Codec_Profile_Scope::~Codec_Profile_Scope()
+    {
+        Codec_Counter_Values end;
+        uint64_t end_enabled, end_running;
+        if(!started_ || !thread_counters.read_values(end,end_enabled,end_running))
+        {
+            return;
+        }
+        uint64_t enabled=end_enabled-start_enabled_;
+        uint64_t running=end_running-start_running_;
+        Codec_Counter_Values counts;
+        for(size_t i=0;i<COUNTERS;i++)
+        {
+            counts[i]=end[i]-start_[i];
+            // Extrapolate to the whole call if the group shared the PMU with others
+            if(running>0 && running<enabled)
+            {
+                counts[i]=static_cast<uint64_t>(static_cast<double>(counts[i])*enabled/running);
+            }
+        }
+        profiler_.record(codec_,counts,running>0);
+    }
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Latency Tracer method implementations
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "Latency_Tracer.h"
+
+namespace cpp_message
+{
+    const int Latency_Histogram::SUB_BUCKETS;
+    const int Latency_Histogram::BUCKETS;
+
+    namespace
+    {
+        uint32_t current_thread_id()
+        {
+            // Kernel thread id, which is what profilers and top show for the thread
+            static thread_local uint32_t thread_id=static_cast<uint32_t>(syscall(SYS_gettid));
+            return thread_id;
+        }
+
+        std::string format_ms(uint64_t ns)
+        {
+            char buffer[32];
+            snprintf(buffer,sizeof(buffer),"%.3f",ns/1e6);
+            return buffer;
+        }
+
+        diagnostic_msgs::KeyValue key_value(const std::string& key, const std::string& value)
+        {
+            diagnostic_msgs::KeyValue kv;
+            kv.key=key;
+            kv.value=value;
+            return kv;
+        }
+    }
+
+    int Latency_Histogram::bucket_of(uint64_t latency_ns)
+    {
+        if(latency_ns<SUB_BUCKETS)
+        {
+            return static_cast<int>(latency_ns);
+        }
+        int exponent=63-__builtin_clzll(latency_ns);
+        int bucket=(exponent-2)*SUB_BUCKETS+static_cast<int>(latency_ns>>(exponent-3))-SUB_BUCKETS;
+        return std::min(bucket,BUCKETS-1);
+    }
+
+    uint64_t Latency_Histogram::bucket_upper(int bucket)
+    {
+        if(bucket<SUB_BUCKETS)
+        {
+            return bucket;
+        }
+        int exponent=bucket/SUB_BUCKETS+2;
+        uint64_t width=1ULL<<(exponent-3);
+        return (SUB_BUCKETS+bucket%SUB_BUCKETS)*width+width-1;
+    }
+
+    void Latency_Histogram::record(uint64_t latency_ns)
+    {
+        counts_[bucket_of(latency_ns)]++;
+        count_++;
+        max_=std::max(max_,latency_ns);
+    }
+
+    uint64_t Latency_Histogram::percentile(double fraction) const
+    {
+        if(count_==0)
+        {
+            return 0;
+        }
+        uint64_t rank=std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction*count_)),1);
+        uint64_t seen=0;
+        for(int bucket=0;bucket<BUCKETS;bucket++)
+        {
+            seen+=counts_[bucket];
+            if(seen>=rank)
+            {
+                // The last bucket is open ended
+                return bucket==BUCKETS-1 ? max_ : std::min(bucket_upper(bucket),max_);
+            }
+        }
+        return max_;
+    }
+
+    void Latency_Histogram::clear()
+    {
+        counts_.fill(0);
+        count_=0;
+        max_=0;
+    }
+
+    Latency_Tracer::Latency_Tracer(size_t trace_capacity) : trace_capacity_(trace_capacity)
+    {
+        events_.reserve(trace_capacity_);
+    }
+
+    size_t Latency_Tracer::add_stage(const std::string& message_type, const std::string& stage)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stages_.push_back(Stage());
+        stages_.back().message_type=message_type;
+        stages_.back().name=stage;
+        return stages_.size()-1;
+    }
+
+    void Latency_Tracer::record(size_t stage, uint64_t start_ns, uint64_t end_ns)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(stage>=stages_.size())
+        {
+            return;
+        }
+        if(end_ns<start_ns)
+        {
+            rejected_++;
+            return;
+        }
+        stages_[stage].histogram.record(end_ns-start_ns);
+        if(trace_capacity_==0)
+        {
+            return;
+        }
+
+        Latency_Trace_Event event;
+        event.stage=static_cast<uint32_t>(stage);
+        event.thread_id=current_thread_id();
+        event.start_ns=start_ns;
+        event.duration_ns=end_ns-start_ns;
+        if(events_.size()<trace_capacity_)
+        {
+            events_.push_back(event);
+        }
+        else
+        {
+            events_[next_event_]=event;
+        }
+        next_event_=(next_event_+1)%trace_capacity_;
+    }
+
+    void Latency_Tracer::report(const std::string& node_name, std::vector<diagnostic_msgs::DiagnosticStatus>& status)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::string> types;
+        for(const Stage& stage : stages_)
+        {
+            if(std::find(types.begin(),types.end(),stage.message_type)==types.end())
+            {
+                types.push_back(stage.message_type);
+            }
+        }
+
+        for(const std::string& type : types)
+        {
+            diagnostic_msgs::DiagnosticStatus type_status;
+            type_status.level=diagnostic_msgs::DiagnosticStatus::OK;
+            type_status.name=node_name+": "+type+" latency";
+            type_status.hardware_id=node_name;
+            for(Stage& stage : stages_)
+            {
+                if(stage.message_type!=type)
+                {
+                    continue;
+                }
+                const Latency_Histogram& histogram=stage.histogram;
+                type_status.values.push_back(key_value(stage.name+" count",std::to_string(histogram.count())));
+                type_status.values.push_back(key_value(stage.name+" p50 (ms)",format_ms(histogram.percentile(0.5))));
+                type_status.values.push_back(key_value(stage.name+" p99 (ms)",format_ms(histogram.percentile(0.99))));
+                type_status.values.push_back(key_value(stage.name+" max (ms)",format_ms(histogram.max())));
+                stage.histogram.clear();
+            }
+            type_status.message=type_status.values.empty() || type_status.values.front().value=="0" ? "No messages" : "OK";
+            status.push_back(type_status);
+        }
+    }
+
+    bool Latency_Tracer::write_chrome_trace(std::ostream& out) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int pid=static_cast<int>(getpid());
+        out<<"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        // Once the buffer wrapped the oldest span is the one overwritten next
+        size_t first=events_.size()<trace_capacity_ ? 0 : next_event_;
+        char buffer[96];
+        for(size_t i=0;i<events_.size();i++)
+        {
+            const Latency_Trace_Event& event=events_[(first+i)%events_.size()];
+            const Stage& stage=stages_[event.stage];
+            if(i>0)
+            {
+                out<<",";
+            }
+            // Microseconds with the nanoseconds as fraction, as the format expects
+            snprintf(buffer,sizeof(buffer),"\"ts\":%llu.%03llu,\"dur\":%llu.%03llu",
+                     static_cast<unsigned long long>(event.start_ns/1000),static_cast<unsigned long long>(event.start_ns%1000),
+                     static_cast<unsigned long long>(event.duration_ns/1000),static_cast<unsigned long long>(event.duration_ns%1000));
+            out<<"{\"name\":\""<<stage.name<<"\",\"cat\":\""<<stage.message_type<<"\",\"ph\":\"X\","<<buffer
+               <<",\"pid\":"<<pid<<",\"tid\":"<<event.thread_id<<"}";
+        }
+        out<<"]}\n";
+        return static_cast<bool>(out);
+    }
+
+    Latency_Histogram Latency_Tracer::histogram(size_t stage) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stage<stages_.size() ? stages_[stage].histogram : Latency_Histogram();
+    }
+
+    uint64_t Latency_Tracer::rejected() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rejected_;
+    }
+}
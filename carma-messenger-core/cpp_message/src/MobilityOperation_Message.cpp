@@ -129,12 +129,23 @@ namespace cpp_message
                 }
             }
             else strategy_params=STRATEGY_PARAMS_STRING_DEFAULT;
+
+            if(Strategy_Params_Codec::is_compact(strategy_params))
+            {
+                std::string plain_params;
+                if(!Strategy_Params_Codec::decode(strategy_params,plain_params))
+                {
+                    ROS_DEBUG_STREAM("Compact strategy_params cannot be decoded");
+                    return boost::optional<cav_msgs::MobilityOperation>{};
+                }
+                strategy_params=plain_params;
+            }
             
             output.strategy_params=strategy_params;
 
             return boost::optional<cav_msgs::MobilityOperation>(output);
         }
-        ROS_WARN_STREAM("mobility operation decoding failed");
+        ROS_DEBUG_STREAM("mobility operation decoding failed");
         return boost::optional<cav_msgs::MobilityOperation>{};
 
     }
@@ -150,7 +161,7 @@ namespace cpp_message
         //if mem allocation fails
         if(!message_shared)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for MobilityOperation message encoding");
+            ROS_DEBUG_STREAM("Cannot allocate mem for MobilityOperation message encoding");
             return boost::optional<std::vector<uint8_t>>{};
         }
         MessageFrame_t* message=message_shared.get();
@@ -262,6 +273,11 @@ namespace cpp_message
 
         //convert parameters string to char array
         std::string strategy_params=plainMessage.strategy_params;
+        std::string compact_params;
+        if(compact_strategy_params_ && Strategy_Params_Codec::encode(strategy_params,compact_params))
+        {
+            strategy_params=compact_params;
+        }
         string_size=strategy_params.size();
         if(string_size<STRATEGY_PARAMS_MIN_LENGTH || string_size>STRATEGY_PARAMS_MAX_LENGTH){
             ROS_WARN("Unacceptable strategy_params value, changing to default");
@@ -281,7 +297,7 @@ namespace cpp_message
          
         //log a warning if that fails
         if(ec.encoded == -1) {
-            ROS_WARN_STREAM("Encoding for Mobility Operation Message failed");
+            ROS_DEBUG_STREAM("Encoding for Mobility Operation Message failed");
             return boost::optional<std::vector<uint8_t>>{};
         }
         
@@ -19,6 +19,7 @@
  */
 #include "MobilityPath_Message.h"
 #include "MobilityHeader_Message.h"
+#include <algorithm>
 
 namespace cpp_message
 {
@@ -175,11 +176,17 @@ namespace cpp_message
             
             return boost::optional<cav_msgs::MobilityPath>(output);
         }
-        ROS_WARN_STREAM("Decoding mobility path message failed");
+        ROS_DEBUG_STREAM("Decoding mobility path message failed");
         return boost::optional<cav_msgs::MobilityPath> {};
     }
     
     boost::optional<std::vector<uint8_t>> Mobility_Path::encode_mobility_path_message(cav_msgs::MobilityPath plainMessage)
+    {
+        return Trajectory_Simplifier::encode_simplified(plainMessage.trajectory,simplification_,MAX_POINTS_IN_MESSAGE,
+            [&]{ return encode_message(plainMessage); },"mobility path");
+    }
+
+    boost::optional<std::vector<uint8_t>> Mobility_Path::encode_message(const cav_msgs::MobilityPath& plainMessage)
     {
         
         uint8_t buffer[1472];
@@ -189,7 +196,7 @@ namespace cpp_message
         //if mem allocation fails
         if(!message_shared)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for MobilityPath message encoding");
+            ROS_DEBUG_STREAM("Cannot allocate mem for MobilityPath message encoding");
             return boost::optional<std::vector<uint8_t>>{};            
         }
         MessageFrame_t* message=message_shared.get();
@@ -340,7 +347,7 @@ namespace cpp_message
         offsets_list=(MobilityLocationOffsets*)calloc(1,sizeof(MobilityLocationOffsets));
         if(!offsets_list)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for offsets list");
+            ROS_DEBUG_STREAM("Cannot allocate mem for offsets list");
             return boost::optional<std::vector<uint8_t>>{}; 
         }
 
@@ -349,7 +356,7 @@ namespace cpp_message
             Offsets=(MobilityECEFOffset*)calloc(1,sizeof(MobilityECEFOffset));
             if(!Offsets)
             {
-                ROS_WARN_STREAM("Cannot allocate mem for offsets");
+                ROS_DEBUG_STREAM("Cannot allocate mem for offsets");
                 return boost::optional<std::vector<uint8_t>>{};
             }
             Offsets->offsetX=plainMessage.trajectory.offsets[i].offset_x;
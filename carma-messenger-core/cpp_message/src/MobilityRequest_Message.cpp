@@ -178,6 +178,17 @@ namespace cpp_message
                 strategy_params +=message->value.choice.TestMessage00.body.strategyParams.buf[i];
             }
 
+            if(Strategy_Params_Codec::is_compact(strategy_params))
+            {
+                std::string plain_params;
+                if(!Strategy_Params_Codec::decode(strategy_params,plain_params))
+                {
+                    ROS_DEBUG_STREAM("Compact strategy_params cannot be decoded");
+                    return boost::optional<cav_msgs::MobilityRequest>{};
+                }
+                strategy_params=plain_params;
+            }
+
             output.strategy_params=strategy_params;   
 
             //Trajectory
@@ -255,6 +266,12 @@ namespace cpp_message
     }
 
     boost::optional<std::vector<uint8_t>> Mobility_Request::encode_mobility_request_message(cav_msgs::MobilityRequest plainMessage)
+    {
+        return Trajectory_Simplifier::encode_simplified(plainMessage.trajectory,simplification_,MAX_POINTS_IN_MESSAGE,
+            [&]{ return encode_message(plainMessage); },"mobility request");
+    }
+
+    boost::optional<std::vector<uint8_t>> Mobility_Request::encode_message(const cav_msgs::MobilityRequest& plainMessage)
     {
         uint8_t buffer[1472];
         size_t buffer_size=sizeof(buffer);
@@ -263,7 +280,7 @@ namespace cpp_message
         //if mem allocation fails
         if(!message_shared)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for MobilityRequest message encoding");
+            ROS_DEBUG_STREAM("Cannot allocate mem for MobilityRequest message encoding");
             return boost::optional<std::vector<uint8_t>>{};            
         }
         MessageFrame_t* message=message_shared.get();
@@ -426,6 +443,11 @@ namespace cpp_message
 
         //strategyParams
         std::string params_string=plainMessage.strategy_params;
+        std::string compact_params;
+        if(compact_strategy_params_ && Strategy_Params_Codec::encode(params_string,compact_params))
+        {
+            params_string=compact_params;
+        }
         size_t params_string_size=params_string.size();
         if(params_string_size<STRATEGY_PARAMS_MIN_LENGTH || params_string_size>STRATEGY_PARAMS_MAX_LENGTH){
             ROS_WARN("Unacceptable strategy_params value, changing to default");
@@ -445,7 +467,7 @@ namespace cpp_message
         std::shared_ptr<MobilityLocation>trajectory_location_shared(new MobilityLocation);
         if(!trajectory_location_shared)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for trajectory.location encoding");
+            ROS_DEBUG_STREAM("Cannot allocate mem for trajectory.location encoding");
             return boost::optional<std::vector<uint8_t>>{};
         }
         MobilityLocation* trajectory_location=trajectory_location_shared.get();
@@ -503,7 +525,7 @@ namespace cpp_message
         std::shared_ptr <MobilityLocationOffsets>offsets_list_shared ((MobilityLocationOffsets*)calloc(1,sizeof(MobilityLocationOffsets)),free);
         if(!offsets_list_shared)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for offsets list encoding");
+            ROS_DEBUG_STREAM("Cannot allocate mem for offsets list encoding");
             return boost::optional<std::vector<uint8_t>>{};
         }
         MobilityLocationOffsets* offsets_list=offsets_list_shared.get();    
@@ -512,7 +534,7 @@ namespace cpp_message
             MobilityECEFOffset* Offsets=new MobilityECEFOffset;
             if(!Offsets)
             {
-                ROS_WARN_STREAM("Cannot allocate mem for Offsets encoding");
+                ROS_DEBUG_STREAM("Cannot allocate mem for Offsets encoding");
                 return boost::optional<std::vector<uint8_t>>{};
             }
             Offsets->offsetX=plainMessage.trajectory.offsets[i].offset_x;
@@ -545,7 +567,7 @@ namespace cpp_message
         std::shared_ptr<MobilityTimestamp_t>expiration_time_shared(new MobilityTimestamp_t);
         if(!expiration_time_shared)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for expiration message encoding");
+            ROS_DEBUG_STREAM("Cannot allocate mem for expiration message encoding");
             return boost::optional<std::vector<uint8_t>>{};
         }
         MobilityTimestamp_t* expiration_time=expiration_time_shared.get();
@@ -120,7 +120,7 @@ namespace cpp_message
             return boost::optional<cav_msgs::MobilityResponse>(output);
         }
         //else return an empty object
-        ROS_WARN_STREAM("Decoding mobility response message failed");
+        ROS_DEBUG_STREAM("Decoding mobility response message failed");
         return boost::optional<cav_msgs::MobilityResponse>{};
     }
 
@@ -134,7 +134,7 @@ namespace cpp_message
         //if mem allocation fails
         if(!message_shared)
         {
-            ROS_WARN_STREAM("Cannot allocate mem for MobilityResponse message encoding");
+            ROS_DEBUG_STREAM("Cannot allocate mem for MobilityResponse message encoding");
             return boost::optional<std::vector<uint8_t>>{};            
         }
         MessageFrame_t* message=message_shared.get();
@@ -240,7 +240,7 @@ namespace cpp_message
 
         //log a warning if that fails
         if(ec.encoded == -1) {
-            ROS_WARN_STREAM("Encoding for Mobility Response Message failed");
+            ROS_DEBUG_STREAM("Encoding for Mobility Response Message failed");
             return boost::optional<std::vector<uint8_t>>{};
         }
         
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Mobility Peek method implementations
+ */
+#include "Mobility_Peek.h"
+#include "MobilityHeader_Message.h"
+
+namespace cpp_message
+{
+    namespace
+    {
+        /**
+         * @brief Skip the extension bit and optional member bitmap in front of the root members of a SEQUENCE
+         */
+        bool skip_sequence_preamble(const asn_TYPE_descriptor_t& type, asn_per_data_t& pd)
+        {
+            const asn_SEQUENCE_specifics_t* specs=static_cast<const asn_SEQUENCE_specifics_t*>(type.specifics);
+            int bits=specs->roms_count+(specs->first_extension>=0 ? 1 : 0);
+            while(bits>0)
+            {
+                int count=bits>24 ? 24 : bits;
+                if(per_get_few_bits(&pd,count)<0)
+                {
+                    return false;
+                }
+                bits-=count;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Decode one member of a SEQUENCE at the current position, the caller frees the result
+         */
+        bool decode_member(const asn_TYPE_member_t& member, asn_per_data_t& pd, void** output)
+        {
+            asn_dec_rval_t rval=member.type->op->uper_decoder(0,member.type,member.encoding_constraints.per_constraints,output,&pd);
+            return rval.code==RC_OK;
+        }
+
+        std::string to_string(const IA5String_t& value)
+        {
+            return std::string(reinterpret_cast<const char*>(value.buf),value.size);
+        }
+    }
+
+    const long Mobility_Peek::MOBILITY_REQUEST_ID;
+    const long Mobility_Peek::MOBILITY_RESPONSE_ID;
+    const long Mobility_Peek::MOBILITY_PATH_ID;
+    const long Mobility_Peek::MOBILITY_OPERATION_ID;
+
+    bool Mobility_Peek::peek(const std::vector<uint8_t>& binary_array, Mobility_Envelope& envelope)
+    {
+        asn_per_data_t pd={};
+        pd.buffer=binary_array.data();
+        pd.nbits=binary_array.size()*8;
+
+        //MessageFrame: message id followed by the message as open type
+        if(!skip_sequence_preamble(asn_DEF_MessageFrame,pd))
+        {
+            return false;
+        }
+        long* message_id=nullptr;
+        bool ok=decode_member(asn_DEF_MessageFrame.elements[0],pd,(void**)&message_id);
+        if(message_id)
+        {
+            envelope.message_id=*message_id;
+            ASN_STRUCT_FREE(*asn_DEF_MessageFrame.elements[0].type,message_id);
+        }
+        if(!ok)
+        {
+            return false;
+        }
+
+        const asn_TYPE_descriptor_t* message_type;
+        switch(envelope.message_id)
+        {
+            case MOBILITY_REQUEST_ID: message_type=&asn_DEF_TestMessage00; break;
+            case MOBILITY_RESPONSE_ID: message_type=&asn_DEF_TestMessage01; break;
+            case MOBILITY_PATH_ID: message_type=&asn_DEF_TestMessage02; break;
+            case MOBILITY_OPERATION_ID: message_type=&asn_DEF_TestMessage03; break;
+            default: return false;
+        }
+        int repeat=0;
+        ssize_t length=uper_get_length(&pd,-1,0,&repeat);
+        if(length<0 || repeat || pd.nbits-pd.nboff<static_cast<size_t>(length)*8)
+        {
+            return false; //fragmented or truncated open type
+        }
+        pd.nbits=pd.nboff+length*8;
+
+        //mobility message: header followed by body
+        if(!skip_sequence_preamble(*message_type,pd))
+        {
+            return false;
+        }
+        MobilityHeader_t* header=nullptr;
+        ok=decode_member(message_type->elements[0],pd,(void**)&header);
+        if(ok)
+        {
+            envelope.sender_id=to_string(header->hostStaticId);
+            envelope.recipient_id=to_string(header->targetStaticId);
+        }
+        if(header)
+        {
+            ASN_STRUCT_FREE(asn_DEF_MobilityHeader,header);
+        }
+        envelope.strategy.clear();
+        if(!ok || (envelope.message_id!=MOBILITY_REQUEST_ID && envelope.message_id!=MOBILITY_OPERATION_ID))
+        {
+            return ok;
+        }
+
+        //requests and operations start their body with the strategy
+        const asn_TYPE_descriptor_t& body_type=*message_type->elements[1].type;
+        if(!skip_sequence_preamble(body_type,pd))
+        {
+            return false;
+        }
+        MobilityStrategy_t* strategy=nullptr;
+        ok=decode_member(body_type.elements[0],pd,(void**)&strategy);
+        if(ok)
+        {
+            envelope.strategy=to_string(*strategy);
+        }
+        if(strategy)
+        {
+            ASN_STRUCT_FREE(*body_type.elements[0].type,strategy);
+        }
+        return ok;
+    }
+
+    bool Mobility_Peek::is_broadcast(const std::string& recipient_id)
+    {
+        Mobility_Header Header_constant;
+        return recipient_id.size()<Header_constant.STATIC_ID_MIN_LENGTH || recipient_id.size()>Header_constant.STATIC_ID_MAX_LENGTH ||
+               recipient_id==Header_constant.STRING_DEFAULT;
+    }
+}
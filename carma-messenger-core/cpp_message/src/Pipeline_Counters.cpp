@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Pipeline Counters method implementations
+ */
+#include <cstdio>
+#include <sstream>
+#include "Pipeline_Counters.h"
+
+namespace cpp_message
+{
+    const size_t Pipeline_Counters::COUNTERS;
+
+    namespace
+    {
+        const char* const COUNTER_NAMES[]={"frames in","frames out","decode failures","encode failures","drops","filtered","bytes in","bytes out"};
+        const char* const METRIC_NAMES[]={"frames_in","frames_out","decode_failures","encode_failures","drops","filtered","bytes_in","bytes_out"};
+
+        // Counters whose growth is reported as a warning
+        const Pipeline_Counter PROBLEMS[]={Pipeline_Counter::DECODE_FAILURES,Pipeline_Counter::ENCODE_FAILURES,Pipeline_Counter::DROPS};
+
+        diagnostic_msgs::KeyValue key_value(const std::string& key, const std::string& value)
+        {
+            diagnostic_msgs::KeyValue kv;
+            kv.key=key;
+            kv.value=value;
+            return kv;
+        }
+
+        std::string format_rate(double rate)
+        {
+            char buffer[32];
+            snprintf(buffer,sizeof(buffer),"%.1f",rate);
+            return buffer;
+        }
+    }
+
+    size_t Pipeline_Counters::add_type(const std::string& message_type)
+    {
+        std::unique_ptr<Type_Counters> type(new Type_Counters());
+        type->message_type=message_type;
+        for(size_t i=0;i<COUNTERS;i++)
+        {
+            type->counters[i].store(0);
+            type->reported[i]=0;
+        }
+        type->queue_depth.store(0);
+        types_.push_back(std::move(type));
+        return types_.size()-1;
+    }
+
+    void Pipeline_Counters::report(const std::string& node_name, double period, std::vector<diagnostic_msgs::DiagnosticStatus>& status)
+    {
+        for(const std::unique_ptr<Type_Counters>& type : types_)
+        {
+            std::array<uint64_t,COUNTERS> totals;
+            std::array<uint64_t,COUNTERS> deltas;
+            for(size_t i=0;i<COUNTERS;i++)
+            {
+                totals[i]=type->counters[i].load(std::memory_order_relaxed);
+                deltas[i]=totals[i]-type->reported[i];
+                type->reported[i]=totals[i];
+            }
+
+            diagnostic_msgs::DiagnosticStatus type_status;
+            type_status.name=node_name+": "+type->message_type;
+            type_status.hardware_id=node_name;
+            for(size_t i=0;i<COUNTERS;i++)
+            {
+                type_status.values.push_back(key_value(COUNTER_NAMES[i],std::to_string(totals[i])));
+            }
+            for(Pipeline_Counter counter : {Pipeline_Counter::FRAMES_IN,Pipeline_Counter::FRAMES_OUT,Pipeline_Counter::BYTES_IN,Pipeline_Counter::BYTES_OUT})
+            {
+                size_t i=static_cast<size_t>(counter);
+                type_status.values.push_back(key_value(std::string(COUNTER_NAMES[i])+"/s",format_rate(period>0 ? deltas[i]/period : 0.0)));
+            }
+            type_status.values.push_back(key_value("queue depth",std::to_string(type->queue_depth.load(std::memory_order_relaxed))));
+
+            std::ostringstream problems;
+            for(Pipeline_Counter counter : PROBLEMS)
+            {
+                size_t i=static_cast<size_t>(counter);
+                if(deltas[i]>0)
+                {
+                    problems<<(problems.tellp()>0 ? ", " : "")<<deltas[i]<<" "<<COUNTER_NAMES[i];
+                }
+            }
+            if(problems.tellp()>0)
+            {
+                type_status.level=diagnostic_msgs::DiagnosticStatus::WARN;
+                problems<<" in the last "<<format_rate(period)<<" s";
+                type_status.message=problems.str();
+            }
+            else
+            {
+                type_status.level=diagnostic_msgs::DiagnosticStatus::OK;
+                type_status.message=deltas[static_cast<size_t>(Pipeline_Counter::FRAMES_IN)]>0 ? "OK" : "No frames";
+            }
+            status.push_back(type_status);
+        }
+    }
+
+    void Pipeline_Counters::write_metrics(const std::string& node_name, std::ostream& out) const
+    {
+        for(size_t i=0;i<COUNTERS;i++)
+        {
+            out<<"# TYPE carma_messenger_"<<METRIC_NAMES[i]<<"_total counter\n";
+            for(const std::unique_ptr<Type_Counters>& type : types_)
+            {
+                out<<"carma_messenger_"<<METRIC_NAMES[i]<<"_total{node=\""<<node_name<<"\",type=\""<<type->message_type<<"\"} "
+                   <<type->counters[i].load(std::memory_order_relaxed)<<"\n";
+            }
+        }
+        out<<"# TYPE carma_messenger_queue_depth gauge\n";
+        for(const std::unique_ptr<Type_Counters>& type : types_)
+        {
+            out<<"carma_messenger_queue_depth{node=\""<<node_name<<"\",type=\""<<type->message_type<<"\"} "
+               <<type->queue_depth.load(std::memory_order_relaxed)<<"\n";
+        }
+    }
+}
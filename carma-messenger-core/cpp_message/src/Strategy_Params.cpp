@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Strategy Params method implementations
+ */
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include "Strategy_Params.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace cpp_message
+{
+    namespace
+    {
+        constexpr size_t BLOCK_SIZE=16;
+
+        /**
+         * @brief Set bit i of the returned masks if character i of the block is a comma or a colon
+         */
+        void scan_block(const char* block, size_t length, uint32_t& commas, uint32_t& colons)
+        {
+#ifdef __SSE2__
+            if(length==BLOCK_SIZE)
+            {
+                __m128i chars=_mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+                commas=_mm_movemask_epi8(_mm_cmpeq_epi8(chars,_mm_set1_epi8(',')));
+                colons=_mm_movemask_epi8(_mm_cmpeq_epi8(chars,_mm_set1_epi8(':')));
+                return;
+            }
+#endif
+            commas=0;
+            colons=0;
+            for(size_t i=0;i<length;i++)
+            {
+                commas|=static_cast<uint32_t>(block[i]==',')<<i;
+                colons|=static_cast<uint32_t>(block[i]==':')<<i;
+            }
+        }
+    }
+
+    const size_t Strategy_Params::MAX_LENGTH;
+    const size_t Strategy_Params::MAX_PARAMS;
+
+    Strategy_Params_Error Strategy_Params::add_entry(const char* begin, const char* end, const char* colon)
+    {
+        if(begin==end)
+        {
+            return Strategy_Params_Error::EMPTY_ENTRY;
+        }
+        if(!colon)
+        {
+            return Strategy_Params_Error::MISSING_SEPARATOR;
+        }
+        if(colon==begin)
+        {
+            return Strategy_Params_Error::EMPTY_KEY;
+        }
+        if(size_==MAX_PARAMS)
+        {
+            return Strategy_Params_Error::TOO_MANY_ENTRIES;
+        }
+        params_[size_].key=std::string_view(begin,colon-begin);
+        params_[size_].value=std::string_view(colon+1,end-colon-1);
+        sorted_[size_]=size_;
+        size_++;
+        return Strategy_Params_Error::NONE;
+    }
+
+    Strategy_Params_Error Strategy_Params::parse(std::string_view params)
+    {
+        size_=0;
+        Strategy_Params_Error error=Strategy_Params_Error::NONE;
+        if(!params.empty())
+        {
+            const char* data=params.data();
+            const char* entry=data;
+            const char* colon=nullptr;
+            for(size_t block=0;block<params.size() && error==Strategy_Params_Error::NONE;block+=BLOCK_SIZE)
+            {
+                uint32_t commas, colons;
+                scan_block(data+block,std::min(BLOCK_SIZE,params.size()-block),commas,colons);
+
+                // Visit the delimiters of the block in order
+                uint32_t delimiters=commas|colons;
+                while(delimiters && error==Strategy_Params_Error::NONE)
+                {
+                    uint32_t bit=delimiters&(~delimiters+1);
+                    const char* position=data+block+__builtin_ctz(delimiters);
+                    if(commas&bit)
+                    {
+                        error=add_entry(entry,position,colon);
+                        entry=position+1;
+                        colon=nullptr;
+                    }
+                    else if(!colon)
+                    {
+                        colon=position;
+                    }
+                    delimiters&=delimiters-1;
+                }
+            }
+            if(error==Strategy_Params_Error::NONE)
+            {
+                error=add_entry(entry,data+params.size(),colon);
+            }
+        }
+
+        // Ties keep the parse order so lookups return the first entry of a key
+        std::sort(sorted_.begin(),sorted_.begin()+size_,[this](uint16_t a, uint16_t b) {
+            int compare=params_[a].key.compare(params_[b].key);
+            return compare<0 || (compare==0 && a<b);
+        });
+        return error;
+    }
+
+    std::optional<std::string_view> Strategy_Params::get(std::string_view key) const
+    {
+        auto it=std::lower_bound(sorted_.begin(),sorted_.begin()+size_,key,[this](uint16_t index, std::string_view key) {
+            return params_[index].key<key;
+        });
+        if(it==sorted_.begin()+size_ || params_[*it].key!=key)
+        {
+            return std::nullopt;
+        }
+        return params_[*it].value;
+    }
+
+    std::optional<int64_t> Strategy_Params::get_int(std::string_view key) const
+    {
+        std::optional<std::string_view> value=get(key);
+        if(!value || value->empty())
+        {
+            return std::nullopt;
+        }
+        int64_t out;
+        const char* end=value->data()+value->size();
+        std::from_chars_result result=std::from_chars(value->data(),end,out);
+        if(result.ec!=std::errc() || result.ptr!=end)
+        {
+            return std::nullopt;
+        }
+        return out;
+    }
+
+    std::optional<double> Strategy_Params::get_double(std::string_view key) const
+    {
+        std::optional<std::string_view> value=get(key);
+        char buffer[64];
+        if(!value || value->empty() || value->size()>=sizeof(buffer))
+        {
+            return std::nullopt;
+        }
+        // strtod needs a terminated string
+        memcpy(buffer,value->data(),value->size());
+        buffer[value->size()]='\0';
+        char* end;
+        double out=strtod(buffer,&end);
+        if(end!=buffer+value->size())
+        {
+            return std::nullopt;
+        }
+        return out;
+    }
+
+    std::optional<bool> Strategy_Params::get_bool(std::string_view key) const
+    {
+        std::optional<std::string_view> value=get(key);
+        if(value && (*value=="true" || *value=="1"))
+        {
+            return true;
+        }
+        if(value && (*value=="false" || *value=="0"))
+        {
+            return false;
+        }
+        return std::nullopt;
+    }
+}
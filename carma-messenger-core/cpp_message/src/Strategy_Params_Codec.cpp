@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Strategy Params Codec method implementations
+ */
+#include "Strategy_Params_Codec.h"
+#include "Strategy_Params.h"
+
+namespace cpp_message
+{
+    namespace
+    {
+        // Shared dictionary of version 0, ids are the indices. Only append to it in a new version
+        const std::string_view DICTIONARY[]={
+            "vin_number", "license_plate", "carrier_name", "carrier_id", "weight", "ads_software_version",
+            "date_of_last_state_inspection", "date_of_last_ads_calibration", "pre_trip_ads_health_check", "ads_status",
+            "iss_score", "permit_required", "timestamp", "state_short_name", "ads_health_status", "ads_auto_status"
+        };
+        constexpr size_t DICTIONARY_SIZE=sizeof(DICTIONARY)/sizeof(DICTIONARY[0]);
+        constexpr uint8_t LITERAL_KEY=31;
+
+        enum Value_Type : uint8_t
+        {
+            STRING=0,
+            POSITIVE=1,
+            NEGATIVE=2,
+            EMPTY=3
+        };
+
+        constexpr uint8_t VARINT_BITS=6;
+        constexpr uint8_t VARINT_MORE=1<<VARINT_BITS;
+        constexpr size_t MAX_INTEGER_DIGITS=18;  // Always fits into int64_t
+
+        void put_varint(uint64_t value, std::string& out)
+        {
+            do
+            {
+                uint8_t unit=value&(VARINT_MORE-1);
+                value>>=VARINT_BITS;
+                out.push_back(static_cast<char>(value ? unit|VARINT_MORE : unit));
+            } while(value);
+        }
+
+        bool get_varint(std::string_view in, size_t& position, uint64_t& value)
+        {
+            value=0;
+            for(unsigned shift=0;position<in.size() && shift<64;shift+=VARINT_BITS)
+            {
+                uint8_t unit=in[position++];
+                if(unit>=0x80)
+                {
+                    return false;
+                }
+                value|=static_cast<uint64_t>(unit&(VARINT_MORE-1))<<shift;
+                if(!(unit&VARINT_MORE))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool put_string(std::string_view value, std::string& out)
+        {
+            for(char c : value)
+            {
+                if(static_cast<uint8_t>(c)>=0x80)
+                {
+                    return false;
+                }
+            }
+            put_varint(value.size(),out);
+            out.append(value.data(),value.size());
+            return true;
+        }
+
+        bool get_string(std::string_view in, size_t& position, std::string& out)
+        {
+            uint64_t length;
+            if(!get_varint(in,position,length) || length>in.size()-position)
+            {
+                return false;
+            }
+            out.append(in.data()+position,length);
+            position+=length;
+            return true;
+        }
+
+        /**
+         * @brief Returns true if the value is an integer which prints back to the same text
+         */
+        bool is_integer(std::string_view value, bool& negative, uint64_t& magnitude)
+        {
+            negative=!value.empty() && value[0]=='-';
+            std::string_view digits=negative ? value.substr(1) : value;
+            if(digits.empty() || digits.size()>MAX_INTEGER_DIGITS || (digits[0]=='0' && (digits.size()>1 || negative)))
+            {
+                return false;
+            }
+            magnitude=0;
+            for(char c : digits)
+            {
+                if(c<'0' || c>'9')
+                {
+                    return false;
+                }
+                magnitude=magnitude*10+(c-'0');
+            }
+            return true;
+        }
+    }
+
+    const char Strategy_Params_Codec::COMPACT_FLAG;
+    const int Strategy_Params_Codec::DICTIONARY_VERSION;
+
+    bool Strategy_Params_Codec::encode(std::string_view params, std::string& compact)
+    {
+        Strategy_Params parsed;
+        if(parsed.parse(params)!=Strategy_Params_Error::NONE || parsed.size()==0)
+        {
+            return false;
+        }
+
+        compact.clear();
+        compact.push_back(COMPACT_FLAG);
+        compact.push_back(static_cast<char>(DICTIONARY_VERSION));
+        for(const Strategy_Param& param : parsed)
+        {
+            uint8_t key=LITERAL_KEY;
+            for(size_t i=0;i<DICTIONARY_SIZE;i++)
+            {
+                if(DICTIONARY[i]==param.key)
+                {
+                    key=i;
+                    break;
+                }
+            }
+
+            bool negative=false;
+            uint64_t magnitude=0;
+            Value_Type type=STRING;
+            if(param.value.empty())
+            {
+                type=EMPTY;
+            }
+            else if(is_integer(param.value,negative,magnitude))
+            {
+                type=negative ? NEGATIVE : POSITIVE;
+            }
+
+            compact.push_back(static_cast<char>(key<<2|type));
+            if(key==LITERAL_KEY && !put_string(param.key,compact))
+            {
+                return false;
+            }
+            if(type==STRING && !put_string(param.value,compact))
+            {
+                return false;
+            }
+            if(type==POSITIVE || type==NEGATIVE)
+            {
+                put_varint(magnitude,compact);
+            }
+        }
+        return compact.size()<params.size();
+    }
+
+    bool Strategy_Params_Codec::decode(std::string_view compact, std::string& params)
+    {
+        if(compact.size()<2 || compact[0]!=COMPACT_FLAG || compact[1]!=DICTIONARY_VERSION)
+        {
+            return false;
+        }
+
+        params.clear();
+        size_t position=2;
+        while(position<compact.size())
+        {
+            uint8_t head=compact[position++];
+            uint8_t key=head>>2;
+            uint8_t type=head&3;
+            if(head>=0x80 || (key>=DICTIONARY_SIZE && key!=LITERAL_KEY))
+            {
+                return false;
+            }
+
+            if(!params.empty())
+            {
+                params.push_back(',');
+            }
+            if(key==LITERAL_KEY)
+            {
+                if(!get_string(compact,position,params))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                params.append(DICTIONARY[key].data(),DICTIONARY[key].size());
+            }
+            params.push_back(':');
+
+            uint64_t magnitude;
+            switch(type)
+            {
+                case STRING:
+                    if(!get_string(compact,position,params))
+                    {
+                        return false;
+                    }
+                    break;
+                case POSITIVE:
+                case NEGATIVE:
+                    if(!get_varint(compact,position,magnitude))
+                    {
+                        return false;
+                    }
+                    if(type==NEGATIVE)
+                    {
+                        params.push_back('-');
+                    }
+                    params+=std::to_string(magnitude);
+                    break;
+                default:
+                    break;
+            }
+        }
+        return !params.empty();
+    }
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Trajectory Conflict Index method implementations
+ */
+#include <algorithm>
+#include <cmath>
+#include "Trajectory_Conflict_Index.h"
+
+namespace cpp_message
+{
+    const uint64_t Trajectory_Conflict_Index::POINT_INTERVAL_MS;
+
+    Trajectory_Conflict_Index::Trajectory_Conflict_Index(double conflict_distance, uint64_t conflict_window_ms)
+        : conflict_distance_(conflict_distance), conflict_window_ms_(std::max<uint64_t>(conflict_window_ms,1))
+    {
+    }
+
+    uint64_t Trajectory_Conflict_Index::cell_key(int64_t x, int64_t y, int64_t z, int64_t t)
+    {
+        // Distinct cells may share a key, which only adds candidates that fail the distance check
+        return static_cast<uint64_t>(x)*0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(y)*0xC2B2AE3D27D4EB4FULL ^
+               static_cast<uint64_t>(z)*0x165667B19E3779F9ULL ^ static_cast<uint64_t>(t)*0xD6E8FEB86659FD93ULL;
+    }
+
+    void Trajectory_Conflict_Index::cell_of(double x, double y, double z, uint64_t time_ms, int64_t (&cell)[4]) const
+    {
+        cell[0]=static_cast<int64_t>(std::floor(x/conflict_distance_));
+        cell[1]=static_cast<int64_t>(std::floor(y/conflict_distance_));
+        cell[2]=static_cast<int64_t>(std::floor(z/conflict_distance_));
+        cell[3]=static_cast<int64_t>(time_ms/conflict_window_ms_);
+    }
+
+    std::vector<Trajectory_Conflict> Trajectory_Conflict_Index::find_conflicts(const Cartesian_Points& ecef, uint64_t start_ms, int64_t skip_slot) const
+    {
+        std::unordered_map<uint32_t, Trajectory_Conflict> earliest;
+        double distance2=conflict_distance_*conflict_distance_;
+        int64_t cell[4];
+        for(size_t i=0;i<ecef.size();i++)
+        {
+            uint64_t time=start_ms+i*POINT_INTERVAL_MS;
+            cell_of(ecef.x[i],ecef.y[i],ecef.z[i],time,cell);
+
+            // Conflicting points are at most one cell away in every dimension
+            for(int64_t dt=-1;dt<=1;dt++)
+            for(int64_t dx=-1;dx<=1;dx++)
+            for(int64_t dy=-1;dy<=1;dy++)
+            for(int64_t dz=-1;dz<=1;dz++)
+            {
+                auto it=cells_.find(cell_key(cell[0]+dx,cell[1]+dy,cell[2]+dz,cell[3]+dt));
+                if(it==cells_.end())
+                {
+                    continue;
+                }
+                for(const Point_Ref& ref : it->second)
+                {
+                    if(ref.slot==skip_slot || earliest.count(ref.slot))
+                    {
+                        continue; // Own trajectory or an earlier conflict is already known
+                    }
+                    const Indexed_Trajectory& other=slots_[ref.slot];
+                    uint64_t other_time=other.start_ms+ref.point*POINT_INTERVAL_MS;
+                    uint64_t time_difference=time>other_time ? time-other_time : other_time-time;
+                    double ddx=ecef.x[i]-other.ecef.x[ref.point];
+                    double ddy=ecef.y[i]-other.ecef.y[ref.point];
+                    double ddz=ecef.z[i]-other.ecef.z[ref.point];
+                    double d2=ddx*ddx+ddy*ddy+ddz*ddz;
+                    if(time_difference<=conflict_window_ms_ && d2<=distance2)
+                    {
+                        Trajectory_Conflict& conflict=earliest[ref.slot];
+                        conflict.other_id=other.id;
+                        conflict.time=time;
+                        conflict.other_time=other_time;
+                        conflict.distance=std::sqrt(d2);
+                    }
+                }
+            }
+        }
+
+        std::vector<Trajectory_Conflict> conflicts;
+        conflicts.reserve(earliest.size());
+        for(auto& entry : earliest)
+        {
+            conflicts.push_back(entry.second);
+        }
+        return conflicts;
+    }
+
+    std::vector<Trajectory_Conflict> Trajectory_Conflict_Index::query(const cav_msgs::Trajectory& trajectory, const std::string& vehicle_id) const
+    {
+        Cartesian_Points ecef;
+        Trajectory_Converter::integrate_offsets(trajectory,ecef);
+        auto it=slot_index_.find(vehicle_id);
+        return find_conflicts(ecef,trajectory.location.timestamp,it==slot_index_.end() ? -1 : it->second);
+    }
+
+    void Trajectory_Conflict_Index::update(const cav_msgs::MobilityPath& path, std::vector<Trajectory_Conflict_Event>& events)
+    {
+        const std::string& id=path.header.sender_id;
+        auto it=slot_index_.find(id);
+        Trajectory_Converter::integrate_offsets(path.trajectory,scratch_);
+        if(scratch_.empty())
+        {
+            // Nothing to index, an empty trajectory only retracts the previous one
+            if(it!=slot_index_.end())
+            {
+                remove_slot(it->second,events);
+            }
+            return;
+        }
+
+        uint32_t slot;
+        if(it!=slot_index_.end())
+        {
+            slot=it->second;
+            remove_points(slot);
+        }
+        else
+        {
+            if(free_slots_.empty())
+            {
+                slot=slots_.size();
+                slots_.emplace_back();
+            }
+            else
+            {
+                slot=free_slots_.back();
+                free_slots_.pop_back();
+            }
+            slot_index_[id]=slot;
+            slots_[slot].id=id;
+            slots_[slot].used=true;
+        }
+
+        uint64_t start_ms=path.trajectory.location.timestamp;
+        std::vector<Trajectory_Conflict> conflicts=find_conflicts(scratch_,start_ms,slot);
+
+        // Report the pairs which changed state and keep both sides of every pair up to date
+        std::unordered_map<std::string, Trajectory_Conflict> current;
+        for(const Trajectory_Conflict& conflict : conflicts)
+        {
+            current[conflict.other_id]=conflict;
+            Trajectory_Conflict mirrored=conflict;
+            mirrored.other_id=id;
+            std::swap(mirrored.time,mirrored.other_time);
+            slots_[slot_index_[conflict.other_id]].conflicts[id]=mirrored;
+            if(!slots_[slot].conflicts.count(conflict.other_id))
+            {
+                events.push_back({id,conflict,true});
+            }
+        }
+        for(const auto& previous : slots_[slot].conflicts)
+        {
+            if(!current.count(previous.first))
+            {
+                events.push_back({id,previous.second,false});
+                slots_[slot_index_[previous.first]].conflicts.erase(id);
+            }
+        }
+
+        Indexed_Trajectory& trajectory=slots_[slot];
+        trajectory.conflicts.swap(current);
+        trajectory.start_ms=start_ms;
+        std::swap(trajectory.ecef,scratch_);
+        trajectory.cells.resize(trajectory.ecef.size());
+        int64_t cell[4];
+        for(size_t i=0;i<trajectory.ecef.size();i++)
+        {
+            cell_of(trajectory.ecef.x[i],trajectory.ecef.y[i],trajectory.ecef.z[i],start_ms+i*POINT_INTERVAL_MS,cell);
+            trajectory.cells[i]=cell_key(cell[0],cell[1],cell[2],cell[3]);
+            cells_[trajectory.cells[i]].push_back({slot,static_cast<uint32_t>(i)});
+        }
+    }
+
+    void Trajectory_Conflict_Index::remove_points(uint32_t slot)
+    {
+        for(uint64_t key : slots_[slot].cells)
+        {
+            auto it=cells_.find(key);
+            if(it==cells_.end())
+            {
+                continue; // Already cleared for an earlier point in the same cell
+            }
+            std::vector<Point_Ref>& refs=it->second;
+            refs.erase(std::remove_if(refs.begin(),refs.end(),[slot](const Point_Ref& ref) { return ref.slot==slot; }),refs.end());
+            if(refs.empty())
+            {
+                cells_.erase(it);
+            }
+        }
+        slots_[slot].cells.clear();
+    }
+
+    void Trajectory_Conflict_Index::remove_slot(uint32_t slot, std::vector<Trajectory_Conflict_Event>& events)
+    {
+        Indexed_Trajectory& trajectory=slots_[slot];
+        remove_points(slot);
+        for(const auto& conflict : trajectory.conflicts)
+        {
+            events.push_back({trajectory.id,conflict.second,false});
+            slots_[slot_index_[conflict.first]].conflicts.erase(trajectory.id);
+        }
+        trajectory.conflicts.clear();
+        slot_index_.erase(trajectory.id);
+        trajectory.used=false;
+        free_slots_.push_back(slot);
+    }
+
+    void Trajectory_Conflict_Index::remove_expired(uint64_t now_ms, std::vector<Trajectory_Conflict_Event>& events)
+    {
+        for(uint32_t slot=0;slot<slots_.size();slot++)
+        {
+            const Indexed_Trajectory& trajectory=slots_[slot];
+            if(!trajectory.used)
+            {
+                continue;
+            }
+            uint64_t end_ms=trajectory.start_ms;
+            if(!trajectory.ecef.empty())
+            {
+                end_ms+=(trajectory.ecef.size()-1)*POINT_INTERVAL_MS;
+            }
+            if(end_ms+conflict_window_ms_<now_ms)
+            {
+                remove_slot(slot,events);
+            }
+        }
+    }
+}
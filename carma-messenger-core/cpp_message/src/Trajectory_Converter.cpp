@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Trajectory Converter method implementations
+ */
+#include <cmath>
+#include "Trajectory_Converter.h"
+
+namespace cpp_message
+{
+    namespace
+    {
+        constexpr double CM_PER_M=100.0;
+        constexpr double DEG_TO_RAD=M_PI/180.0;
+
+        // WGS84 ellipsoid
+        constexpr double A=6378137.0;
+        constexpr double F=1.0/298.257223563;
+        constexpr double B=A*(1.0-F);
+        constexpr double E2=F*(2.0-F);
+        constexpr double EP2=(A*A-B*B)/(B*B);
+    }
+
+    const int Trajectory_Converter::OFFSET_UNAVAILABLE;
+
+    size_t Trajectory_Converter::integrate_offsets(const cav_msgs::Trajectory& trajectory, Cartesian_Points& ecef)
+    {
+        size_t count=1;
+        while(count<=trajectory.offsets.size())
+        {
+            const cav_msgs::LocationOffsetECEF& offset=trajectory.offsets[count-1];
+            if(offset.offset_x==OFFSET_UNAVAILABLE || offset.offset_y==OFFSET_UNAVAILABLE || offset.offset_z==OFFSET_UNAVAILABLE)
+            {
+                break;
+            }
+            count++;
+        }
+        ecef.resize(count);
+
+        // Sum in integer centimeters so the points are exact regardless of the trajectory length
+        int64_t x=trajectory.location.ecef_x;
+        int64_t y=trajectory.location.ecef_y;
+        int64_t z=trajectory.location.ecef_z;
+        for(size_t i=0;i<count;i++)
+        {
+            if(i>0)
+            {
+                x+=trajectory.offsets[i-1].offset_x;
+                y+=trajectory.offsets[i-1].offset_y;
+                z+=trajectory.offsets[i-1].offset_z;
+            }
+            ecef.x[i]=x/CM_PER_M;
+            ecef.y[i]=y/CM_PER_M;
+            ecef.z[i]=z/CM_PER_M;
+        }
+        return count;
+    }
+
+    void Trajectory_Converter::ecef_to_geodetic(const Cartesian_Points& ecef, Geodetic_Points& geodetic)
+    {
+        size_t count=ecef.size();
+        geodetic.resize(count);
+        const double* x=ecef.x.data();
+        const double* y=ecef.y.data();
+        const double* z=ecef.z.data();
+        double* latitude=geodetic.latitude.data();
+        double* longitude=geodetic.longitude.data();
+        double* height=geodetic.height.data();
+
+        // Heikkinen, Geschlossene Formeln zur Berechnung raeumlicher geodaetischer Koordinaten aus rechtwinkligen
+        // Koordinaten, Zeitschrift fuer Vermessungswesen 107, 1982
+        #pragma omp simd
+        for(size_t i=0;i<count;i++)
+        {
+            double p2=x[i]*x[i]+y[i]*y[i];
+            double p=std::sqrt(p2);
+            double z2=z[i]*z[i];
+            double f=54.0*B*B*z2;
+            double g=p2+(1.0-E2)*z2-E2*(A*A-B*B);
+            double c=E2*E2*f*p2/(g*g*g);
+            double s=std::cbrt(1.0+c+std::sqrt(c*c+2.0*c));
+            double k=s+1.0+1.0/s;
+            double pk=f/(3.0*k*k*g*g);
+            double q=std::sqrt(1.0+2.0*E2*E2*pk);
+            double r0=-(pk*E2*p)/(1.0+q)+std::sqrt(0.5*A*A*(1.0+1.0/q)-pk*(1.0-E2)*z2/(q*(1.0+q))-0.5*pk*p2);
+            double t=p-E2*r0;
+            double u=std::sqrt(t*t+z2);
+            double v=std::sqrt(t*t+(1.0-E2)*z2);
+            double z0=B*B*z[i]/(A*v);
+
+            height[i]=u*(1.0-B*B/(A*v));
+            latitude[i]=std::atan2(z[i]+EP2*z0,p)/DEG_TO_RAD;
+            longitude[i]=std::atan2(y[i],x[i])/DEG_TO_RAD;
+        }
+    }
+
+    void Trajectory_Converter::geodetic_to_ecef(double latitude, double longitude, double height, double& x, double& y,
+                                                double& z)
+    {
+        double sin_lat=std::sin(latitude*DEG_TO_RAD);
+        double cos_lat=std::cos(latitude*DEG_TO_RAD);
+        double n=A/std::sqrt(1.0-E2*sin_lat*sin_lat);
+        x=(n+height)*cos_lat*std::cos(longitude*DEG_TO_RAD);
+        y=(n+height)*cos_lat*std::sin(longitude*DEG_TO_RAD);
+        z=(n*(1.0-E2)+height)*sin_lat;
+    }
+
+    void Trajectory_Converter::ecef_to_local(const Cartesian_Points& ecef, double ref_latitude, double ref_longitude,
+                                             double ref_height, Cartesian_Points& local)
+    {
+        double ref_x, ref_y, ref_z;
+        geodetic_to_ecef(ref_latitude, ref_longitude, ref_height, ref_x, ref_y, ref_z);
+        double sin_lat=std::sin(ref_latitude*DEG_TO_RAD);
+        double cos_lat=std::cos(ref_latitude*DEG_TO_RAD);
+        double sin_lon=std::sin(ref_longitude*DEG_TO_RAD);
+        double cos_lon=std::cos(ref_longitude*DEG_TO_RAD);
+
+        size_t count=ecef.size();
+        local.resize(count);
+        const double* x=ecef.x.data();
+        const double* y=ecef.y.data();
+        const double* z=ecef.z.data();
+        double* east=local.x.data();
+        double* north=local.y.data();
+        double* up=local.z.data();
+
+        #pragma omp simd
+        for(size_t i=0;i<count;i++)
+        {
+            double dx=x[i]-ref_x;
+            double dy=y[i]-ref_y;
+            double dz=z[i]-ref_z;
+            east[i]=-sin_lon*dx+cos_lon*dy;
+            north[i]=-sin_lat*cos_lon*dx-sin_lat*sin_lon*dy+cos_lat*dz;
+            up[i]=cos_lat*cos_lon*dx+cos_lat*sin_lon*dy+sin_lat*dz;
+        }
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * CPP File containing Trajectory Simplifier method implementations
+ */
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <ros/console.h>
+#include "Trajectory_Simplifier.h"
+
+namespace cpp_message
+{
+    const int Trajectory_Simplifier::OFFSET_MIN;
+    const int Trajectory_Simplifier::OFFSET_MAX;
+
+    Trajectory_Simplifier::Segment Trajectory_Simplifier::make_segment(const std::vector<int64_t>& x,
+        const std::vector<int64_t>& y, const std::vector<int64_t>& z, size_t start, size_t end)
+    {
+        Segment segment{start,end,start,0.0,false};
+        double sx=static_cast<double>(x[end]-x[start]);
+        double sy=static_cast<double>(y[end]-y[start]);
+        double sz=static_cast<double>(z[end]-z[start]);
+        double length2=sx*sx+sy*sy+sz*sz;
+        for(size_t i=start+1;i<end;i++)
+        {
+            double px=static_cast<double>(x[i]-x[start]);
+            double py=static_cast<double>(y[i]-y[start]);
+            double pz=static_cast<double>(z[i]-z[start]);
+            double t=length2>0.0 ? std::min(1.0,std::max(0.0,(px*sx+py*sy+pz*sz)/length2)) : 0.0;
+            double dx=px-t*sx;
+            double dy=py-t*sy;
+            double dz=pz-t*sz;
+            double error=std::sqrt(dx*dx+dy*dy+dz*dz);
+            if(error>segment.error || segment.split==start)
+            {
+                segment.error=error;
+                segment.split=i;
+            }
+        }
+
+        // Only segments with interior points can be split
+        if(end-start>1)
+        {
+            for(int64_t offset : {x[end]-x[start],y[end]-y[start],z[end]-z[start]})
+            {
+                if(offset<OFFSET_MIN || offset>OFFSET_MAX)
+                {
+                    segment.mandatory=true;
+                }
+            }
+        }
+        return segment;
+    }
+
+    bool Trajectory_Simplifier::simplify(const cav_msgs::Trajectory& trajectory, double tolerance, size_t max_offsets,
+                                         cav_msgs::Trajectory& output)
+    {
+        // Integrate the offsets in centimeters
+        size_t count=trajectory.offsets.size()+1;
+        std::vector<int64_t> x(count), y(count), z(count);
+        x[0]=trajectory.location.ecef_x;
+        y[0]=trajectory.location.ecef_y;
+        z[0]=trajectory.location.ecef_z;
+        for(size_t i=1;i<count;i++)
+        {
+            const cav_msgs::LocationOffsetECEF& offset=trajectory.offsets[i-1];
+            for(int64_t value : {offset.offset_x,offset.offset_y,offset.offset_z})
+            {
+                if(value<OFFSET_MIN || value>OFFSET_MAX)
+                {
+                    return false; // Unavailable or not encodable, neither can be simplified
+                }
+            }
+            x[i]=x[i-1]+offset.offset_x;
+            y[i]=y[i-1]+offset.offset_y;
+            z[i]=z[i-1]+offset.offset_z;
+        }
+
+        std::vector<bool> keep(count,false);
+        keep[0]=true;
+        keep[count-1]=true;
+        size_t offsets=count>1 ? 1 : 0;
+        double tolerance_cm=tolerance*100.0;
+
+        std::priority_queue<Segment> segments;
+        if(count>2)
+        {
+            segments.push(make_segment(x,y,z,0,count-1));
+        }
+        while(!segments.empty())
+        {
+            Segment segment=segments.top();
+            if(!segment.mandatory && (segment.error<=tolerance_cm || offsets>=max_offsets))
+            {
+                break; // Every remaining segment is within the tolerance or the budget is used up
+            }
+            segments.pop();
+
+            size_t split=segment.split;
+            if(segment.mandatory && segment.error==0.0)
+            {
+                split=(segment.start+segment.end)/2; // Straight line, split evenly
+            }
+            keep[split]=true;
+            offsets++;
+            if(split-segment.start>1)
+            {
+                segments.push(make_segment(x,y,z,segment.start,split));
+            }
+            if(segment.end-split>1)
+            {
+                segments.push(make_segment(x,y,z,split,segment.end));
+            }
+        }
+
+        if(offsets>max_offsets)
+        {
+            return false;
+        }
+
+        output.location=trajectory.location;
+        output.offsets.clear();
+        output.offsets.reserve(offsets);
+        size_t previous=0;
+        for(size_t i=1;i<count;i++)
+        {
+            if(!keep[i])
+            {
+                continue;
+            }
+            cav_msgs::LocationOffsetECEF offset;
+            offset.offset_x=x[i]-x[previous];
+            offset.offset_y=y[i]-y[previous];
+            offset.offset_z=z[i]-z[previous];
+            output.offsets.push_back(offset);
+            previous=i;
+        }
+        return true;
+    }
+
+    boost::optional<std::vector<uint8_t>> Trajectory_Simplifier::encode_simplified(cav_msgs::Trajectory& trajectory,
+        const Trajectory_Simplification& simplification, size_t max_offsets, const Encoder& encode,
+        const std::string& message_type)
+    {
+        if(!simplification.enabled)
+        {
+            return encode();
+        }
+
+        //simplify until the message fits the target size, keeping the smallest message encoded so far
+        cav_msgs::Trajectory original=std::move(trajectory);
+        trajectory.location=original.location;
+        cav_msgs::Trajectory smallest;
+        boost::optional<std::vector<uint8_t>> output;
+        while(simplify(original,simplification.tolerance,max_offsets,trajectory))
+        {
+            auto res=encode();
+            if(!res)
+            {
+                break;
+            }
+            output=res;
+            smallest.offsets.swap(trajectory.offsets);
+            size_t offset_count=smallest.offsets.size();
+            if(simplification.max_bytes==0 || res->size()<=simplification.max_bytes || offset_count==0)
+            {
+                trajectory.offsets.swap(smallest.offsets);
+                return output;
+            }
+            max_offsets=std::min(offset_count-1,offset_count*simplification.max_bytes/res->size());
+        }
+        if(!output)
+        {
+            ROS_WARN_STREAM("Trajectory simplification failed, encoding the original "<<message_type<<" trajectory");
+            trajectory=std::move(original);
+            return encode();
+        }
+        trajectory.offsets.swap(smallest.offsets);
+        ROS_WARN_STREAM("Encoded "<<message_type<<" of "<<output->size()<<" bytes exceeds the target size");
+        return output;
+    }
+}
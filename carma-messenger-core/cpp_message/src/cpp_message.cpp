@@ -24,6 +24,10 @@
 #include "MobilityPath_Message.h"
 #include "MobilityRequest_Message.h"
 #include "BSM_Message.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
 
 namespace cpp_message
 {
@@ -49,50 +53,351 @@ namespace cpp_message
         mobility_request_message_sub_=nh_->subscribe("outgoing_mobility_request",5, &Message::outbound_mobility_request_message_callback,this);
         bsm_message_pub_=nh_->advertise<j2735_msgs::BSM>("incoming_j2735_bsm",5);
         bsm_message_sub_=nh_->subscribe("outgoing_j2735_bsm",5, &Message::outbound_bsm_message_callback,this);
+        trajectory_conflict_pub_=nh_->advertise<cpp_message::TrajectoryConflict>("trajectory_conflicts",10);
+
+        bool trajectory_conflicts=true;
+        double conflict_distance=2.0;
+        double conflict_window=1.0;
+        pnh_->param<bool>("trajectory_conflicts", trajectory_conflicts, trajectory_conflicts);
+        pnh_->param<double>("trajectory_conflict_distance", conflict_distance, conflict_distance);
+        pnh_->param<double>("trajectory_conflict_window", conflict_window, conflict_window);
+        if(!(conflict_distance>0.0) || !(conflict_window>=0.0))
+        {
+            ROS_WARN_STREAM("Invalid trajectory_conflict_distance "<<conflict_distance<<" or trajectory_conflict_window "<<conflict_window<<", using 2.0 m and 1.0 s");
+            conflict_distance=2.0;
+            conflict_window=1.0;
+        }
+        if(trajectory_conflicts)
+        {
+            trajectory_conflict_index_.reset(new Trajectory_Conflict_Index(conflict_distance, conflict_window*1000.0));
+        }
+
+        int simplification_max_bytes=0;
+        pnh_->param<bool>("trajectory_simplification", trajectory_simplification_.enabled, false);
+        pnh_->param<double>("trajectory_simplification_tolerance", trajectory_simplification_.tolerance, trajectory_simplification_.tolerance);
+        pnh_->param<int>("trajectory_simplification_max_bytes", simplification_max_bytes, simplification_max_bytes);
+        trajectory_simplification_.max_bytes=std::max(simplification_max_bytes,0);
+        if(trajectory_simplification_.enabled && trajectory_conflicts)
+        {
+            //simplified points are no longer 100 ms apart, which the conflict index of every receiver relies on
+            ROS_WARN_STREAM("trajectory_simplification needs trajectory_conflicts disabled, trajectories are sent as is");
+            trajectory_simplification_.enabled=false;
+        }
+
+        std::vector<std::string> strategies;
+        pnh_->param<std::vector<std::string>>("mobility_strategies", strategies, strategies);
+        advertise_strategy_routes(strategies);
+
+        pnh_->param<std::string>("host_id", host_id_, host_id_);
+        pnh_->param<bool>("compact_strategy_params", compact_strategy_params_, compact_strategy_params_);
+        mobility_counts_pub_=nh_->advertise<cpp_message::MobilityMessageCounts>("incoming_mobility_counts",1);
+        mobility_counts_timer_=nh_->createTimer(ros::Duration(1.0), &Message::mobility_counts_timer_callback, this);
+
+        const std::vector<std::string> message_types={"BSM","MobilityOperation","MobilityResponse","MobilityPath","MobilityRequest","TrafficControlMessage","TrafficControlRequest"};
+        for(const std::string& type : message_types)
+        {
+            inbound_counter_types_[type]=pipeline_counters_.add_type("incoming "+type);
+            outbound_counter_types_[type]=pipeline_counters_.add_type("outgoing "+type);
+        }
+        other_inbound_counter_type_=pipeline_counters_.add_type("incoming other");
+        pnh_->param<double>("diagnostics_period", diagnostics_period_, diagnostics_period_);
+        diagnostics_pub_=nh_->advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics",10);
+        diagnostics_timer_=nh_->createTimer(ros::Duration(diagnostics_period_), &Message::diagnostics_timer_callback, this);
+        metrics_service_=pnh_->advertiseService("get_metrics", &Message::metrics_callback, this);
+
+        bool latency_tracing=false;
+        int latency_trace_capacity=10000;
+        pnh_->param<bool>("latency_tracing", latency_tracing, latency_tracing);
+        pnh_->param<int>("latency_trace_capacity", latency_trace_capacity, latency_trace_capacity);
+        pnh_->param<std::string>("latency_trace_file", latency_trace_file_, "/opt/carma/logs/cpp_message_trace.json");
+        if(latency_tracing)
+        {
+            latency_tracer_.reset(new Latency_Tracer(std::max(latency_trace_capacity,0)));
+            for(const std::string& type : message_types)
+            {
+                Inbound_Trace_Stages& stages=inbound_trace_stages_[type];
+                stages.receive=latency_tracer_->add_stage(type,"receive");
+                stages.decode=latency_tracer_->add_stage(type,"decode");
+                stages.publish=latency_tracer_->add_stage(type,"publish");
+                stages.total=latency_tracer_->add_stage(type,"total");
+            }
+            export_latency_trace_service_=pnh_->advertiseService("export_latency_trace", &Message::export_latency_trace_callback, this);
+        }
+
+        bool allocation_accounting=false;
+        pnh_->param<bool>("allocation_accounting", allocation_accounting, allocation_accounting);
+        if(allocation_accounting && !Allocation_Accounting::hooks_installed())
+        {
+            ROS_WARN_STREAM("allocation_accounting needs cpp_message_node built with CPP_MESSAGE_ALLOCATION_HOOKS, allocations are not accounted");
+        }
+        else if(allocation_accounting)
+        {
+            allocation_accounting_.reset(new Allocation_Accounting());
+            for(const std::string& type : message_types)
+            {
+                decode_codecs_[type].allocation_tag=allocation_accounting_->add_tag(type,"decode");
+                encode_codecs_[type].allocation_tag=allocation_accounting_->add_tag(type,"encode");
+            }
+        }
+
+        bool codec_profiling=false;
+        pnh_->param<bool>("codec_profiling", codec_profiling, codec_profiling);
+        std::string profiling_error;
+        // the counters are opened for the thread spinning the callbacks
+        if(codec_profiling && !Codec_Profiler::open_counters(profiling_error))
+        {
+            ROS_WARN_STREAM("codec_profiling is not available, "<<profiling_error);
+        }
+        else if(codec_profiling)
+        {
+            ROS_INFO_STREAM("Profiling the codecs with hardware counters"<<(Codec_Profiler::counting_kernel() ? "" : ", user time only"));
+            codec_profiler_.reset(new Codec_Profiler());
+            for(const std::string& type : message_types)
+            {
+                decode_codecs_[type].profile=codec_profiler_->add_codec(type,"decode");
+                encode_codecs_[type].profile=codec_profiler_->add_codec(type,"encode");
+            }
+            export_codec_profile_service_=pnh_->advertiseService("export_codec_profile", &Message::export_codec_profile_callback, this);
+        }
+
+    }
+
+    void Message::advertise_strategy_routes(const std::vector<std::string>& strategies)
+    {
+        for(const std::string& strategy : strategies)
+        {
+            std::string topic=strategy;
+            for(char& c : topic)
+            {
+                if(!isalnum(static_cast<unsigned char>(c)) && c!='_' && c!='/')
+                {
+                    c='_';
+                }
+            }
+            std::string error;
+            if(topic.empty() || !ros::names::validate("incoming_mobility_operation/"+topic,error))
+            {
+                ROS_WARN_STREAM("Cannot route mobility strategy "<<strategy<<" "<<error);
+                continue;
+            }
+            Strategy_Route& route=strategy_routes_[strategy];
+            route.mobility_operation_pub=nh_->advertise<cav_msgs::MobilityOperation>("incoming_mobility_operation/"+topic,5);
+            route.mobility_request_pub=nh_->advertise<cav_msgs::MobilityRequest>("incoming_mobility_request/"+topic,5);
+        }
+    }
+
+    bool Message::filter_mobility_message(const std::vector<uint8_t>& array, const ros::Publisher* general_pub, const ros::Publisher*& strategy_pub)
+    {
+        mobility_counts_.received++;
+        strategy_pub=nullptr;
+        Mobility_Envelope envelope;
+        if((host_id_.empty() && strategy_routes_.empty()) || !Mobility_Peek::peek(array,envelope))
+        {
+            return true; //nothing to filter on or the full decode reports the error
+        }
 
+        if(!host_id_.empty() && !Mobility_Peek::is_broadcast(envelope.recipient_id) && envelope.recipient_id!=host_id_)
+        {
+            mobility_counts_.not_addressed++;
+            pipeline_counters_.add(inbound_counter_type_,Pipeline_Counter::FILTERED);
+            return false;
+        }
 
+        auto it=strategy_routes_.find(envelope.strategy);
+        if(it!=strategy_routes_.end())
+        {
+            strategy_pub=envelope.message_id==Mobility_Peek::MOBILITY_OPERATION_ID ? &it->second.mobility_operation_pub : &it->second.mobility_request_pub;
+            if(strategy_pub->getNumSubscribers()==0)
+            {
+                strategy_pub=nullptr;
+            }
+        }
+        if(general_pub && !strategy_pub && general_pub->getNumSubscribers()==0)
+        {
+            mobility_counts_.no_subscribers++;
+            pipeline_counters_.add(inbound_counter_type_,Pipeline_Counter::FILTERED);
+            return false;
+        }
+        return true;
+    }
+
+    void Message::mobility_counts_timer_callback(const ros::TimerEvent& event)
+    {
+        mobility_counts_pub_.publish(mobility_counts_);
+    }
+
+    void Message::begin_inbound(const cav_msgs::ByteArray& msg)
+    {
+        auto type=inbound_counter_types_.find(msg.messageType);
+        inbound_counter_type_=type!=inbound_counter_types_.end() ? type->second : other_inbound_counter_type_;
+        pipeline_counters_.add(inbound_counter_type_,Pipeline_Counter::FRAMES_IN);
+        pipeline_counters_.add(inbound_counter_type_,Pipeline_Counter::BYTES_IN,msg.content.size());
+
+        inbound_trace_=nullptr;
+        if(!latency_tracer_)
+        {
+            return;
+        }
+        auto it=inbound_trace_stages_.find(msg.messageType);
+        if(it!=inbound_trace_stages_.end())
+        {
+            inbound_trace_=&it->second;
+            inbound_decode_start_=ros::Time::now();
+            inbound_receive_stamp_=msg.header.stamp.isZero() ? inbound_decode_start_ : msg.header.stamp;
+        }
+    }
+
+    void Message::inbound_decoded()
+    {
+        if(inbound_trace_)
+        {
+            inbound_decode_end_=ros::Time::now();
+        }
+    }
+
+    void Message::inbound_decode_failed()
+    {
+        pipeline_counters_.add(inbound_counter_type_,Pipeline_Counter::DECODE_FAILURES);
+        inbound_trace_=nullptr;
+    }
+
+    void Message::inbound_published()
+    {
+        pipeline_counters_.add(inbound_counter_type_,Pipeline_Counter::FRAMES_OUT);
+        if(!inbound_trace_)
+        {
+            return;
+        }
+        uint64_t published=ros::Time::now().toNSec();
+        latency_tracer_->record(inbound_trace_->receive,inbound_receive_stamp_.toNSec(),inbound_decode_start_.toNSec());
+        latency_tracer_->record(inbound_trace_->decode,inbound_decode_start_.toNSec(),inbound_decode_end_.toNSec());
+        latency_tracer_->record(inbound_trace_->publish,inbound_decode_end_.toNSec(),published);
+        latency_tracer_->record(inbound_trace_->total,inbound_receive_stamp_.toNSec(),published);
+        inbound_trace_=nullptr;
+    }
+
+    void Message::count_outbound(const std::string& message_type, const boost::optional<std::vector<uint8_t>>& encoded)
+    {
+        size_t type=outbound_counter_types_.at(message_type);
+        pipeline_counters_.add(type,Pipeline_Counter::FRAMES_IN);
+        if(encoded)
+        {
+            pipeline_counters_.add(type,Pipeline_Counter::FRAMES_OUT);
+            pipeline_counters_.add(type,Pipeline_Counter::BYTES_OUT,encoded.get().size());
+        }
+        else
+        {
+            pipeline_counters_.add(type,Pipeline_Counter::ENCODE_FAILURES);
+        }
+    }
+
+    void Message::diagnostics_timer_callback(const ros::TimerEvent& event)
+    {
+        diagnostic_msgs::DiagnosticArray diagnostics;
+        diagnostics.header.stamp=ros::Time::now();
+        double period=event.last_real.isZero() ? diagnostics_period_ : (event.current_real-event.last_real).toSec();
+        pipeline_counters_.report(ros::this_node::getName(),period,diagnostics.status);
+        // one line per message type and period instead of one per failed frame
+        for(const diagnostic_msgs::DiagnosticStatus& status : diagnostics.status)
+        {
+            if(status.level==diagnostic_msgs::DiagnosticStatus::WARN)
+            {
+                ROS_WARN_STREAM(status.name<<": "<<status.message);
+            }
+        }
+        if(latency_tracer_)
+        {
+            latency_tracer_->report(ros::this_node::getName(),diagnostics.status);
+        }
+        if(allocation_accounting_)
+        {
+            allocation_accounting_->report(ros::this_node::getName(),diagnostics.status);
+        }
+        diagnostics_pub_.publish(diagnostics);
+    }
+
+    bool Message::metrics_callback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp)
+    {
+        std::ostringstream metrics;
+        pipeline_counters_.write_metrics(ros::this_node::getName(),metrics);
+        resp.success=true;
+        resp.message=metrics.str();
+        return true;
+    }
+
+    bool Message::export_latency_trace_callback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp)
+    {
+        std::ofstream file(latency_trace_file_);
+        resp.success=file && latency_tracer_->write_chrome_trace(file);
+        resp.message=resp.success ? "Latency trace written to "+latency_trace_file_ : "Cannot write latency trace to "+latency_trace_file_;
+        return true;
+    }
+
+    bool Message::export_codec_profile_callback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp)
+    {
+        std::ostringstream profile;
+        codec_profiler_->write_csv(profile);
+        resp.success=true;
+        resp.message=profile.str();
+        return true;
     }
 
     void Message::inbound_binary_callback(const cav_msgs::ByteArrayConstPtr& msg)
     {
+        begin_inbound(*msg);
         // only handle TrafficControlRequest for now
         if(msg->messageType == "TrafficControlRequest") {
             std::vector<uint8_t> array = msg->content;
-            auto output = decode_geofence_request(array);
+            auto output = instrument_codec(decode_codecs_, "TrafficControlRequest", [&]{ return decode_geofence_request(array); });
+            inbound_decoded();
             if(output)
             {
                 inbound_geofence_request_message_pub_.publish(output.get());
+                inbound_published();
             } else
             {
-                ROS_WARN_STREAM("Cannot decode geofence request message.");
+                inbound_decode_failed();
             }
         }
 
             // handle TrafficControlMessage
         else if(msg->messageType == "TrafficControlMessage") {
             std::vector<uint8_t> array = msg->content;
-            auto output = decode_geofence_control(array);
+            auto output = instrument_codec(decode_codecs_, "TrafficControlMessage", [&]{ return decode_geofence_control(array); });
+            inbound_decoded();
             if(output)
             {
                 inbound_geofence_control_message_pub_.publish(output.get());
+                inbound_published();
             } else
             {
-                ROS_WARN_STREAM("Cannot decode geofence control message.");
+                inbound_decode_failed();
             }
         }
         
         else if(msg->messageType=="MobilityOperation")   
         {
             std::vector<uint8_t> array=msg->content;
+            const ros::Publisher* strategy_pub;
+            if(!filter_mobility_message(array,&mobility_operation_message_pub_,strategy_pub))
+            {
+                return;
+            }
             Mobility_Operation decode;
-            auto output=decode.decode_mobility_operation_message(array);
+            auto output=instrument_codec(decode_codecs_,"MobilityOperation",[&]{ return decode.decode_mobility_operation_message(array); });
+            inbound_decoded();
             if(output)
             {
                 mobility_operation_message_pub_.publish(output.get());
+                if(strategy_pub)
+                {
+                    strategy_pub->publish(output.get());
+                }
+                inbound_published();
             }
             else
             {
-                ROS_WARN_STREAM("Cannot decode Mobility Operation message");
+                inbound_decode_failed();
             }
 
         }
@@ -100,45 +405,71 @@ namespace cpp_message
         else if(msg->messageType=="MobilityResponse")
         {
             std::vector<uint8_t> array=msg->content;
+            const ros::Publisher* strategy_pub;
+            if(!filter_mobility_message(array,&mobility_response_message_pub_,strategy_pub))
+            {
+                return;
+            }
             Mobility_Response decode;
-            auto output=decode.decode_mobility_response_message(array);
+            auto output=instrument_codec(decode_codecs_,"MobilityResponse",[&]{ return decode.decode_mobility_response_message(array); });
+            inbound_decoded();
             if(output)
             {
                 mobility_response_message_pub_.publish(output.get());
+                inbound_published();
             }
             else
             {
-                ROS_WARN_STREAM("Cannot decode Mobility Response message");
+                inbound_decode_failed();
             }
             
         }
         else if(msg->messageType=="MobilityPath")   
         {
             std::vector<uint8_t> array=msg->content;
+            const ros::Publisher* strategy_pub;
+            if(!filter_mobility_message(array,nullptr,strategy_pub)) //paths also feed the trajectory conflict index
+            {
+                return;
+            }
             Mobility_Path decode;
-            auto output=decode.decode_mobility_path_message(array);
+            auto output=instrument_codec(decode_codecs_,"MobilityPath",[&]{ return decode.decode_mobility_path_message(array); });
+            inbound_decoded();
             if(output)
             {
                 mobility_path_message_pub_.publish(output.get());
+                inbound_published();
+                update_trajectory_conflicts(output.get());
             }
             else
             {
-                ROS_WARN_STREAM("Cannot decode Mobility Path message");
+                inbound_decode_failed();
             }
              
         }
         else if(msg->messageType=="MobilityRequest")   
         {
             std::vector<uint8_t> array=msg->content;
+            const ros::Publisher* strategy_pub;
+            if(!filter_mobility_message(array,&mobility_request_message_pub_,strategy_pub))
+            {
+                return;
+            }
             Mobility_Request decode;
-            auto output=decode.decode_mobility_request_message(array);
+            auto output=instrument_codec(decode_codecs_,"MobilityRequest",[&]{ return decode.decode_mobility_request_message(array); });
+            inbound_decoded();
             if(output)
             {
                 mobility_request_message_pub_.publish(output.get());
+                if(strategy_pub)
+                {
+                    strategy_pub->publish(output.get());
+                }
+                inbound_published();
             }
             else
             {
-                ROS_WARN_STREAM("Cannot decode Mobility Request message");
+                inbound_decode_failed();
             }
              
         }
@@ -146,14 +477,18 @@ namespace cpp_message
         {
             std::vector<uint8_t> array=msg->content;
             BSM_Message decode;
-            auto output=decode.decode_bsm_message(array);
+            auto output=instrument_codec(decode_codecs_,"BSM",[&]{ return decode.decode_bsm_message(array); });
+            inbound_decoded();
             if(output)
             {
+                // the radio receive stamp travels on with the BSM through the j2735_convertor
+                output.get().header.stamp=msg->header.stamp;
                 bsm_message_pub_.publish(output.get());
+                inbound_published();
             }
             else
             {
-                ROS_WARN_STREAM("Cannot decode BSM message");
+                inbound_decode_failed();
             }
              
         }
@@ -163,16 +498,14 @@ namespace cpp_message
     {
 
         j2735_msgs::TrafficControlRequest request_msg(*msg.get());
-        auto res = encode_geofence_request(request_msg);
+        auto res = instrument_codec(encode_codecs_, "TrafficControlRequest", [&]{ return encode_geofence_request(request_msg); });
+        count_outbound("TrafficControlRequest",res);
         if(res) {
             // copy to byte array msg
             cav_msgs::ByteArray output;
             output.content = res.get();
             // publish result
             outbound_binary_message_pub_.publish(output);
-        } else
-        {
-            ROS_WARN_STREAM("Cannot encode geofence request message.");
         }
 
     }
@@ -180,16 +513,14 @@ namespace cpp_message
     void Message::outbound_control_message_callback(const j2735_msgs::TrafficControlMessageConstPtr& msg)
     {
         j2735_msgs::TrafficControlMessage control_msg(*msg.get());
-        auto res = encode_geofence_control(control_msg);
+        auto res = instrument_codec(encode_codecs_, "TrafficControlMessage", [&]{ return encode_geofence_control(control_msg); });
+        count_outbound("TrafficControlMessage",res);
         if(res) {
             // copy to byte array msg
             cav_msgs::ByteArray output;
             output.content = res.get();
             // publish result
             outbound_binary_message_pub_.publish(output);
-        } else
-        {
-            ROS_WARN_STREAM("Cannot encode geofence control message.");
         }
     }
 
@@ -202,8 +533,9 @@ namespace cpp_message
 
     void Message::outbound_mobility_operation_message_callback(const cav_msgs::MobilityOperation& msg)
     {//encode and publish as outbound binary message
-        Mobility_Operation encode;
-        auto res=encode.encode_mobility_operation_message(msg);
+        Mobility_Operation encode(compact_strategy_params_);
+        auto res=instrument_codec(encode_codecs_,"MobilityOperation",[&]{ return encode.encode_mobility_operation_message(msg); });
+        count_outbound("MobilityOperation",res);
         if(res)
         {
             //copy to byte array msg
@@ -215,16 +547,13 @@ namespace cpp_message
             //publish result
             outbound_binary_message_pub_.publish(output);
         }
-        else
-        {
-            ROS_WARN_STREAM("Cannot encode mobility operation message.");
-        }
     }
 
     void Message::outbound_mobility_response_message_callback(const cav_msgs::MobilityResponse& msg)
         {//encode and publish as outbound binary message
         Mobility_Response encode;
-        auto res=encode.encode_mobility_response_message(msg);
+        auto res=instrument_codec(encode_codecs_,"MobilityResponse",[&]{ return encode.encode_mobility_response_message(msg); });
+        count_outbound("MobilityResponse",res);
         if(res)
         {
             //copy to byte array msg
@@ -236,15 +565,35 @@ namespace cpp_message
             //publish result
             outbound_binary_message_pub_.publish(output);
         }
-        else
+    }
+    void Message::update_trajectory_conflicts(const cav_msgs::MobilityPath& msg)
+    {
+        if(!trajectory_conflict_index_)
         {
-            ROS_WARN_STREAM("Cannot encode mobility response message.");
+            return;
+        }
+        trajectory_conflict_events_.clear();
+        trajectory_conflict_index_->remove_expired(ros::Time::now().toNSec()/1000000,trajectory_conflict_events_);
+        trajectory_conflict_index_->update(msg,trajectory_conflict_events_);
+        for(const Trajectory_Conflict_Event& event : trajectory_conflict_events_)
+        {
+            cpp_message::TrajectoryConflict output;
+            output.vehicle_id=event.vehicle_id;
+            output.other_vehicle_id=event.conflict.other_id;
+            output.in_conflict=event.in_conflict;
+            output.conflict_time=event.conflict.time;
+            output.other_conflict_time=event.conflict.other_time;
+            output.distance=event.conflict.distance;
+            trajectory_conflict_pub_.publish(output);
         }
     }
+
     void Message::outbound_mobility_path_message_callback(const cav_msgs::MobilityPath& msg)
     {//encode and publish as outbound binary message
-        Mobility_Path encode;
-        auto res=encode.encode_mobility_path_message(msg);
+        update_trajectory_conflicts(msg);
+        Mobility_Path encode(trajectory_simplification_);
+        auto res=instrument_codec(encode_codecs_,"MobilityPath",[&]{ return encode.encode_mobility_path_message(msg); });
+        count_outbound("MobilityPath",res);
         if(res)
         {
             //copy to byte array msg
@@ -256,15 +605,12 @@ namespace cpp_message
             //publish result
             outbound_binary_message_pub_.publish(output);
         }
-        else
-        {
-            ROS_WARN_STREAM("Cannot encode mobility path message.");
-        }
     }
     void Message::outbound_mobility_request_message_callback(const cav_msgs::MobilityRequest& msg)
     {//encode and publish as outbound binary message
-        Mobility_Request encode;
-        auto res=encode.encode_mobility_request_message(msg);
+        Mobility_Request encode(trajectory_simplification_,compact_strategy_params_);
+        auto res=instrument_codec(encode_codecs_,"MobilityRequest",[&]{ return encode.encode_mobility_request_message(msg); });
+        count_outbound("MobilityRequest",res);
         if(res)
         {
             //copy to byte array msg
@@ -276,15 +622,12 @@ namespace cpp_message
             //publish result
             outbound_binary_message_pub_.publish(output);
         }
-        else
-        {
-            ROS_WARN_STREAM("Cannot encode mobility request message.");
-        }
     }
     void Message::outbound_bsm_message_callback(const j2735_msgs::BSM& msg)
     {//encode and publish as outbound binary message
         BSM_Message encode;
-        auto res=encode.encode_bsm_message(msg);
+        auto res=instrument_codec(encode_codecs_,"BSM",[&]{ return encode.encode_bsm_message(msg); });
+        count_outbound("BSM",res);
         if(res)
         {
             //copy to byte array msg
@@ -296,10 +639,6 @@ namespace cpp_message
             //publish result
             outbound_binary_message_pub_.publish(output);
         }
-        else
-        {
-            ROS_WARN_STREAM("Cannot encode BSM message.");
-        }
     }
     boost::optional<j2735_msgs::TrafficControlMessage> Message::decode_geofence_control(std::vector<uint8_t>& binary_array)
     {
@@ -1430,7 +1769,7 @@ namespace cpp_message
         // if mem allocation fails
 	    if (!message)
         {
-		    ROS_WARN_STREAM("Cannot allocate mem for TrafficControlRequest message encoding");
+		    ROS_DEBUG_STREAM("Cannot allocate mem for TrafficControlRequest message encoding");
             return boost::optional<std::vector<uint8_t>>{};
 	    }
         //set message type to TestMessage04
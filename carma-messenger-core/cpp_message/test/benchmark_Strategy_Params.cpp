@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * Benchmark of the strategy_params parser against splitting with std::stringstream and std::getline.
+ * Run with: rosrun cpp_message cpp_message_strategy_params_benchmark [iterations]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include "Strategy_Params.h"
+
+namespace
+{
+    const std::string SAFETY_LOG="vin_number:1FUJGHDV0CLBP8834,license_plate:DOT-10003,carrier_name:Silver Truck FHWA TFHRC,"
+                                 "carrier_id:USDOT 0000001,weight:,ads_software_version:System Version Unknown,"
+                                 "date_of_last_state_inspection:YYYY-MM-DD,date_of_last_ads_calibration:YYYY-MM-DD,"
+                                 "pre_trip_ads_health_check:Green,ads_status:Red,iss_score:49,permit_required:0,timestamp:1585836731814";
+
+    /**
+     * @brief Baseline which splits the entries with getline and stores them in a map of strings
+     */
+    size_t parse_stringstream(const std::string& params, std::unordered_map<std::string, std::string>& out)
+    {
+        out.clear();
+        std::string entry;
+        std::stringstream ss(params);
+        while(std::getline(ss,entry,','))
+        {
+            size_t colon=entry.find(':');
+            if(entry.empty() || colon==std::string::npos)
+            {
+                return 0;
+            }
+            out.emplace(entry.substr(0,colon),entry.substr(colon+1));
+        }
+        return out.size();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations=argc>1 ? std::strtoul(argv[1],nullptr,10) : 200000;
+
+    std::unordered_map<std::string, std::string> map;
+    size_t checksum_stringstream=0;
+    auto start=std::chrono::steady_clock::now();
+    for(size_t i=0;i<iterations;i++)
+    {
+        checksum_stringstream+=parse_stringstream(SAFETY_LOG,map);
+        checksum_stringstream+=map["ads_status"].size();
+    }
+    double stringstream_s=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    cpp_message::Strategy_Params params;
+    size_t checksum_parser=0;
+    start=std::chrono::steady_clock::now();
+    for(size_t i=0;i<iterations;i++)
+    {
+        params.parse(SAFETY_LOG);
+        checksum_parser+=params.size();
+        checksum_parser+=params.get("ads_status").value_or("").size();
+    }
+    double parser_s=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    printf("iterations: %zu, characters: %zu\n",iterations,SAFETY_LOG.size());
+    printf("stringstream: %8.1f ns/parse (checksum %zu)\n",stringstream_s*1e9/iterations,checksum_stringstream);
+    printf("parser:       %8.1f ns/parse (checksum %zu)\n",parser_s*1e9/iterations,checksum_parser);
+    printf("speedup:      %8.2fx\n",stringstream_s/parser_s);
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/**
+ * Benchmark of the batch trajectory conversion against the per point iterative conversion it replaces.
+ * Run with: rosrun cpp_message cpp_message_trajectory_benchmark [trajectories]
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "Trajectory_Converter.h"
+
+namespace
+{
+    constexpr double A=6378137.0;
+    constexpr double F=1.0/298.257223563;
+    constexpr double E2=F*(2.0-F);
+
+    struct Geodetic_Point
+    {
+        double latitude;
+        double longitude;
+        double height;
+    };
+
+    /**
+     * @brief Scalar baseline which integrates one offset at a time and iterates the latitude until it converges
+     */
+    void convert_iterative(const cav_msgs::Trajectory& trajectory, std::vector<Geodetic_Point>& points)
+    {
+        points.clear();
+        double x=trajectory.location.ecef_x/100.0;
+        double y=trajectory.location.ecef_y/100.0;
+        double z=trajectory.location.ecef_z/100.0;
+        for(size_t i=0;i<=trajectory.offsets.size();i++)
+        {
+            if(i>0)
+            {
+                x+=trajectory.offsets[i-1].offset_x/100.0;
+                y+=trajectory.offsets[i-1].offset_y/100.0;
+                z+=trajectory.offsets[i-1].offset_z/100.0;
+            }
+            double p=std::sqrt(x*x+y*y);
+            double latitude=std::atan2(z,p*(1.0-E2));
+            double height=0.0;
+            for(int iteration=0;iteration<10;iteration++)
+            {
+                double sin_lat=std::sin(latitude);
+                double n=A/std::sqrt(1.0-E2*sin_lat*sin_lat);
+                height=p/std::cos(latitude)-n;
+                double next=std::atan2(z,p*(1.0-E2*n/(n+height)));
+                bool converged=std::fabs(next-latitude)<1e-12;
+                latitude=next;
+                if(converged)
+                {
+                    break;
+                }
+            }
+            points.push_back({latitude*180.0/M_PI,std::atan2(y,x)*180.0/M_PI,height});
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t trajectory_count=argc>1 ? std::strtoul(argv[1],nullptr,10) : 20000;
+
+    // Full length trajectories spread around the globe
+    std::vector<cav_msgs::Trajectory> trajectories(trajectory_count);
+    srand(1);
+    for(cav_msgs::Trajectory& trajectory : trajectories)
+    {
+        double latitude=rand()%170-85.0;
+        double longitude=rand()%360-180.0;
+        double x, y, z;
+        cpp_message::Trajectory_Converter::geodetic_to_ecef(latitude,longitude,rand()%500,x,y,z);
+        trajectory.location.ecef_x=x*100.0;
+        trajectory.location.ecef_y=y*100.0;
+        trajectory.location.ecef_z=z*100.0;
+        cav_msgs::LocationOffsetECEF offset;
+        offset.offset_x=rand()%1000-500;
+        offset.offset_y=rand()%1000-500;
+        offset.offset_z=rand()%100-50;
+        trajectory.offsets.assign(60,offset);
+    }
+
+    std::vector<Geodetic_Point> points;
+    double checksum_iterative=0.0;
+    auto start=std::chrono::steady_clock::now();
+    for(const cav_msgs::Trajectory& trajectory : trajectories)
+    {
+        convert_iterative(trajectory,points);
+        checksum_iterative+=points.back().latitude;
+    }
+    double iterative_s=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    cpp_message::Cartesian_Points ecef;
+    cpp_message::Geodetic_Points geodetic;
+    double checksum_batch=0.0;
+    start=std::chrono::steady_clock::now();
+    for(const cav_msgs::Trajectory& trajectory : trajectories)
+    {
+        cpp_message::Trajectory_Converter::integrate_offsets(trajectory,ecef);
+        cpp_message::Trajectory_Converter::ecef_to_geodetic(ecef,geodetic);
+        checksum_batch+=geodetic.latitude.back();
+    }
+    double batch_s=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    double point_count=trajectory_count*61.0;
+    printf("trajectories: %zu, points: %.0f\n",trajectory_count,point_count);
+    printf("iterative: %8.1f ns/point (checksum %.6f)\n",iterative_s*1e9/point_count,checksum_iterative);
+    printf("batch:     %8.1f ns/point (checksum %.6f)\n",batch_s*1e9/point_count,checksum_batch);
+    printf("speedup:   %8.2fx\n",iterative_s/batch_s);
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Allocation_Accounting.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <malloc.h>
+
+using cpp_message::Allocation_Accounting;
+using cpp_message::Allocation_Scope;
+
+// The test is not linked with the malloc hooks, so the blocks are passed to the accounting as the hooks would
+TEST(AllocationAccountingTest, testScopes)
+{
+    Allocation_Accounting accounting;
+    size_t decode=accounting.add_tag("BSM","decode");
+    size_t encode=accounting.add_tag("BSM","encode");
+
+    void* outside=malloc(64);
+    void* first=malloc(100);
+    void* second=malloc(200);
+    size_t first_size=malloc_usable_size(first);
+    size_t second_size=malloc_usable_size(second);
+    {
+        Allocation_Scope scope(accounting,decode);
+        Allocation_Accounting::allocated(first);
+        Allocation_Accounting::freeing(first);
+        Allocation_Accounting::allocated(second);
+        // Freeing a block from before the scope lowers what it holds
+        Allocation_Accounting::freeing(outside);
+        {
+            Allocation_Scope inner(accounting,encode);
+            Allocation_Accounting::allocated(first);
+        }
+    }
+    // Outside any scope nothing is accounted
+    Allocation_Accounting::allocated(second);
+    free(outside);
+    free(first);
+    free(second);
+
+    cpp_message::Allocation_Stats stats=accounting.stats(decode);
+    EXPECT_EQ(1u,stats.scopes);
+    EXPECT_EQ(2u,stats.allocations);
+    EXPECT_EQ(first_size+second_size,stats.bytes);
+    EXPECT_EQ(std::max(first_size,second_size),stats.peak_bytes);
+    EXPECT_EQ(1u,accounting.stats(encode).allocations);
+
+    std::vector<diagnostic_msgs::DiagnosticStatus> status;
+    accounting.report("cpp_message",status);
+    ASSERT_EQ(2u,status.size());
+    EXPECT_EQ("cpp_message: BSM decode allocations",status[0].name);
+    ASSERT_EQ(4u,status[0].values.size());
+    EXPECT_EQ("calls",status[0].values[0].key);
+    EXPECT_EQ("1",status[0].values[0].value);
+    EXPECT_EQ("allocations per call",status[0].values[1].key);
+    EXPECT_EQ("2.0",status[0].values[1].value);
+    EXPECT_EQ(std::to_string(std::max(first_size,second_size)),status[0].values[3].value);
+
+    // A report starts the next period
+    EXPECT_EQ(0u,accounting.stats(decode).scopes);
+    status.clear();
+    accounting.report("cpp_message",status);
+    EXPECT_EQ("No calls",status[0].message);
+}
+
+// The realloc hook queries the size of the old block before the realloc and only accounts its free on success
+TEST(AllocationAccountingTest, testRealloc)
+{
+    Allocation_Accounting accounting;
+    size_t decode=accounting.add_tag("BSM","decode");
+
+    void* first=malloc(100);
+    void* second=malloc(200);
+    size_t first_size=malloc_usable_size(first);
+    size_t second_size=malloc_usable_size(second);
+    EXPECT_EQ(0u,Allocation_Accounting::held_size(first));
+    {
+        Allocation_Scope scope(accounting,decode);
+        EXPECT_EQ(0u,Allocation_Accounting::held_size(nullptr));
+        Allocation_Accounting::allocated(first);
+        // A failed realloc of first keeps it live
+        size_t held=Allocation_Accounting::held_size(first);
+        EXPECT_EQ(first_size,held);
+        Allocation_Accounting::allocated(nullptr);
+        // A successful one frees it
+        Allocation_Accounting::freed(held);
+        Allocation_Accounting::allocated(second);
+    }
+    free(first);
+    free(second);
+
+    cpp_message::Allocation_Stats stats=accounting.stats(decode);
+    EXPECT_EQ(2u,stats.allocations);
+    EXPECT_EQ(std::max(first_size,second_size),stats.peak_bytes);
+}
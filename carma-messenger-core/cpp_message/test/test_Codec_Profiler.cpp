@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Codec_Profiler.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using cpp_message::Codec_Counter_Values;
+using cpp_message::Codec_Profiler;
+
+TEST(CodecProfilerTest, testCsv)
+{
+    Codec_Profiler profiler;
+    size_t decode=profiler.add_codec("BSM","decode");
+    profiler.add_codec("BSM","encode");
+    profiler.record(decode,Codec_Counter_Values{{1000,2500,10,20}},true);
+    profiler.record(decode,Codec_Counter_Values{{3000,5500,30,40}},true);
+    profiler.record(decode,Codec_Counter_Values{{0,0,0,0}},false);
+
+    cpp_message::Codec_Profile profile=profiler.profile(decode);
+    EXPECT_EQ(3u,profile.calls);
+    EXPECT_EQ(1u,profile.unmeasured);
+    EXPECT_EQ(4000u,profile.sums[0]);
+
+    std::ostringstream csv;
+    profiler.write_csv(csv);
+    EXPECT_EQ("type,direction,calls,unmeasured,cycles,instructions,cache_misses,branch_misses,"
+              "cycles_per_call,instructions_per_call,cache_misses_per_call,branch_misses_per_call,instructions_per_cycle\n"
+              "BSM,decode,3,1,4000,8000,40,60,2000.0,4000.0,20.0,30.0,2.00\n"
+              "BSM,encode,0,0,0,0,0,0,0.0,0.0,0.0,0.0,0.00\n",csv.str());
+}
+
+TEST(CodecProfilerTest, testScope)
+{
+    Codec_Profiler profiler;
+    size_t decode=profiler.add_codec("BSM","decode");
+    std::string error;
+    if(!Codec_Profiler::open_counters(error))
+    {
+        // Scopes do nothing where the counters are not available
+        {
+            cpp_message::Codec_Profile_Scope scope(profiler,decode);
+        }
+        EXPECT_FALSE(error.empty());
+        EXPECT_EQ(0u,profiler.profile(decode).calls);
+        return;
+    }
+
+    {
+        cpp_message::Codec_Profile_Scope scope(profiler,decode);
+        volatile uint64_t sum=0;
+        for(int i=0;i<100000;i++)
+        {
+            sum=sum+i;
+        }
+    }
+    cpp_message::Codec_Profile profile=profiler.profile(decode);
+    EXPECT_EQ(1u,profile.calls);
+    if(profile.unmeasured==0)
+    {
+        EXPECT_GT(profile.sums[static_cast<size_t>(cpp_message::Codec_Counter::INSTRUCTIONS)],100000u);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Latency_Tracer.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+TEST(LatencyTracerTest, testHistogramPercentiles)
+{
+    cpp_message::Latency_Histogram histogram;
+    EXPECT_EQ(0u,histogram.percentile(0.5));
+    for(uint64_t i=1;i<=1000;i++)
+    {
+        histogram.record(i*1000);
+    }
+    EXPECT_EQ(1000u,histogram.count());
+    EXPECT_EQ(1000000u,histogram.max());
+    // Within the 12.5% bucket resolution above the exact percentile
+    EXPECT_GE(histogram.percentile(0.5),500000u);
+    EXPECT_LE(histogram.percentile(0.5),562500u);
+    EXPECT_GE(histogram.percentile(0.99),990000u);
+    EXPECT_LE(histogram.percentile(0.99),1000000u);
+    EXPECT_EQ(1000000u,histogram.percentile(1.0));
+
+    // Small latencies are exact and huge ones share the last bucket
+    cpp_message::Latency_Histogram small;
+    small.record(3);
+    small.record(5);
+    EXPECT_EQ(3u,small.percentile(0.5));
+    small.record(UINT64_MAX);
+    EXPECT_EQ(UINT64_MAX,small.percentile(1.0));
+}
+
+TEST(LatencyTracerTest, testReportAndTrace)
+{
+    cpp_message::Latency_Tracer tracer(2);
+    size_t decode=tracer.add_stage("BSM","decode");
+    size_t total=tracer.add_stage("BSM","total");
+    size_t path=tracer.add_stage("MobilityPath","decode");
+    tracer.record(decode,1000000,1200000);
+    tracer.record(decode,2000000,2300000);
+    tracer.record(total,900000,1250000);
+    tracer.record(total,2000000,1000000);
+    EXPECT_EQ(1u,tracer.rejected());
+    EXPECT_EQ(2u,tracer.histogram(decode).count());
+    EXPECT_EQ(300000u,tracer.histogram(decode).max());
+
+    std::vector<diagnostic_msgs::DiagnosticStatus> status;
+    tracer.report("cpp_message",status);
+    ASSERT_EQ(2u,status.size());
+    EXPECT_EQ("cpp_message: BSM latency",status[0].name);
+    ASSERT_EQ(8u,status[0].values.size());
+    EXPECT_EQ("decode count",status[0].values[0].key);
+    EXPECT_EQ("2",status[0].values[0].value);
+    EXPECT_EQ("decode max (ms)",status[0].values[3].key);
+    EXPECT_EQ("0.300",status[0].values[3].value);
+    EXPECT_EQ("No messages",status[1].message);
+    EXPECT_EQ(0u,tracer.histogram(decode).count());
+
+    // Only the latest two spans are kept, oldest first
+    tracer.record(path,3000000,3000500);
+    std::ostringstream trace;
+    ASSERT_TRUE(tracer.write_chrome_trace(trace));
+    std::string json=trace.str();
+    EXPECT_EQ(std::string::npos,json.find("\"ts\":1000.000"));
+    size_t total_span=json.find("\"name\":\"total\",\"cat\":\"BSM\",\"ph\":\"X\",\"ts\":900.000,\"dur\":350.000");
+    size_t path_span=json.find("\"cat\":\"MobilityPath\",\"ph\":\"X\",\"ts\":3000.000,\"dur\":0.500");
+    ASSERT_NE(std::string::npos,total_span);
+    ASSERT_NE(std::string::npos,path_span);
+    EXPECT_LT(total_span,path_span);
+}
@@ -95,3 +95,33 @@ TEST(MobilityOperationMessageTest, testEncodeMobilityOperationMsg_base_case)
         EXPECT_TRUE(false);
     }
 }
+
+TEST(MobilityOperationMessageTest, testCompactStrategyParams)
+{
+    cpp_message::Mobility_Operation compact_worker(true);
+    cpp_message::Mobility_Operation plain_worker;
+    cav_msgs::MobilityHeader header;
+    cav_msgs::MobilityOperation message;
+    header.sender_id="USDOT-45100";
+    header.recipient_id="USDOT-45095";
+    header.sender_bsm_id="10ABCDEF";
+    header.plan_id="11111111-2222-3333-AAAA-111111111111";
+    header.timestamp = 1585836731814;
+    message.header=header;
+    message.strategy="TruckInspection";
+    message.strategy_params="vin_number:1FUJGHDV0CLBP8834,license_plate:DOT-10003,carrier_name:Silver Truck FHWA TFHRC,carrier_id:USDOT 0000001,weight:,ads_software_version:System Version Unknown,date_of_last_state_inspection:YYYY-MM-DD,date_of_last_ads_calibration:YYYY-MM-DD,pre_trip_ads_health_check:Green,ads_status:Red,iss_score:49,permit_required:0,timestamp:1585836731814";
+
+    auto compact = compact_worker.encode_mobility_operation_message(message);
+    auto plain = plain_worker.encode_mobility_operation_message(message);
+    ASSERT_TRUE(compact);
+    ASSERT_TRUE(plain);
+    EXPECT_LT(compact.get().size(), plain.get().size());
+
+    // Both forms decode to the original params, whatever the decoder was configured with
+    auto res = plain_worker.decode_mobility_operation_message(compact.get());
+    ASSERT_TRUE(res);
+    EXPECT_EQ(message.strategy_params, res.get().strategy_params);
+    res = compact_worker.decode_mobility_operation_message(plain.get());
+    ASSERT_TRUE(res);
+    EXPECT_EQ(message.strategy_params, res.get().strategy_params);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Pipeline_Counters.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+using cpp_message::Pipeline_Counter;
+
+TEST(PipelineCountersTest, testReport)
+{
+    cpp_message::Pipeline_Counters counters;
+    size_t bsm=counters.add_type("incoming BSM");
+    size_t path=counters.add_type("incoming MobilityPath");
+    counters.add(bsm,Pipeline_Counter::FRAMES_IN,10);
+    counters.add(bsm,Pipeline_Counter::BYTES_IN,400);
+    counters.add(bsm,Pipeline_Counter::FRAMES_OUT,8);
+    counters.add(bsm,Pipeline_Counter::DECODE_FAILURES,2);
+    counters.set_queue_depth(bsm,3);
+
+    std::vector<diagnostic_msgs::DiagnosticStatus> status;
+    counters.report("cpp_message",2.0,status);
+    ASSERT_EQ(2u,status.size());
+    EXPECT_EQ("cpp_message: incoming BSM",status[0].name);
+    EXPECT_EQ(diagnostic_msgs::DiagnosticStatus::WARN,status[0].level);
+    EXPECT_EQ("2 decode failures in the last 2.0 s",status[0].message);
+    ASSERT_EQ(13u,status[0].values.size());
+    EXPECT_EQ("frames in",status[0].values[0].key);
+    EXPECT_EQ("10",status[0].values[0].value);
+    EXPECT_EQ("frames in/s",status[0].values[8].key);
+    EXPECT_EQ("5.0",status[0].values[8].value);
+    EXPECT_EQ("bytes in/s",status[0].values[10].key);
+    EXPECT_EQ("200.0",status[0].values[10].value);
+    EXPECT_EQ("queue depth",status[0].values[12].key);
+    EXPECT_EQ("3",status[0].values[12].value);
+    EXPECT_EQ(diagnostic_msgs::DiagnosticStatus::OK,status[1].level);
+    EXPECT_EQ("No frames",status[1].message);
+
+    // Failures are only warned about again if they grow, the totals keep counting
+    counters.add(bsm,Pipeline_Counter::FRAMES_IN,4);
+    counters.add(path,Pipeline_Counter::DROPS);
+    // Filtered frames are counted without a warning
+    counters.add(bsm,Pipeline_Counter::FILTERED,3);
+    status.clear();
+    counters.report("cpp_message",1.0,status);
+    EXPECT_EQ(diagnostic_msgs::DiagnosticStatus::OK,status[0].level);
+    EXPECT_EQ("14",status[0].values[0].value);
+    EXPECT_EQ("filtered",status[0].values[5].key);
+    EXPECT_EQ("3",status[0].values[5].value);
+    EXPECT_EQ("4.0",status[0].values[8].value);
+    EXPECT_EQ("1 drops in the last 1.0 s",status[1].message);
+}
+
+TEST(PipelineCountersTest, testConcurrentCountsAndMetrics)
+{
+    cpp_message::Pipeline_Counters counters;
+    size_t bsm=counters.add_type("incoming BSM");
+    std::vector<std::thread> threads;
+    for(int t=0;t<4;t++)
+    {
+        threads.emplace_back([&counters,bsm]()
+        {
+            for(int i=0;i<10000;i++)
+            {
+                counters.add(bsm,Pipeline_Counter::FRAMES_IN);
+            }
+        });
+    }
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(40000u,counters.get(bsm,Pipeline_Counter::FRAMES_IN));
+
+    std::ostringstream metrics;
+    counters.write_metrics("/cpp_message_node",metrics);
+    EXPECT_NE(std::string::npos,metrics.str().find("# TYPE carma_messenger_frames_in_total counter\n"
+                                                    "carma_messenger_frames_in_total{node=\"/cpp_message_node\",type=\"incoming BSM\"} 40000\n"));
+    EXPECT_NE(std::string::npos,metrics.str().find("carma_messenger_queue_depth{node=\"/cpp_message_node\",type=\"incoming BSM\"} 0\n"));
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Strategy_Params.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+    const std::string SAFETY_LOG="vin_number:1FUJGHDV0CLBP8834,license_plate:DOT-10003,carrier_name:Silver Truck FHWA TFHRC,"
+                                 "carrier_id:USDOT 0000001,weight:,ads_software_version:System Version Unknown,"
+                                 "date_of_last_state_inspection:YYYY-MM-DD,date_of_last_ads_calibration:YYYY-MM-DD,"
+                                 "pre_trip_ads_health_check:Green,ads_status:Red,iss_score:49,permit_required:0,timestamp:1585836731814";
+}
+
+TEST(StrategyParamsTest, testParse)
+{
+    cpp_message::Strategy_Params params;
+    ASSERT_EQ(cpp_message::Strategy_Params_Error::NONE,params.parse(SAFETY_LOG));
+    ASSERT_EQ(13u,params.size());
+    EXPECT_EQ("vin_number",params[0].key);
+    EXPECT_EQ("1FUJGHDV0CLBP8834",params[0].value);
+    EXPECT_EQ("timestamp",params[12].key);
+
+    EXPECT_EQ("Silver Truck FHWA TFHRC",params.get("carrier_name").value());
+    EXPECT_EQ("",params.get("weight").value());
+    EXPECT_FALSE(params.get("missing"));
+    EXPECT_EQ(49,params.get_int("iss_score").value());
+    EXPECT_EQ(1585836731814,params.get_int("timestamp").value());
+    EXPECT_FALSE(params.get_int("ads_status"));
+    EXPECT_FALSE(params.get_int("weight"));
+    EXPECT_DOUBLE_EQ(49.0,params.get_double("iss_score").value());
+    EXPECT_FALSE(params.get_double("license_plate"));
+    EXPECT_FALSE(params.get_bool("permit_required").value());
+    EXPECT_FALSE(params.get_bool("ads_status"));
+
+    // Values keep everything after the first colon and the first of duplicate keys is found
+    ASSERT_EQ(cpp_message::Strategy_Params_Error::NONE,params.parse("time:12:30,speed:1.5,time:13:00"));
+    EXPECT_EQ(3u,params.size());
+    EXPECT_EQ("12:30",params.get("time").value());
+    EXPECT_DOUBLE_EQ(1.5,params.get_double("speed").value());
+
+    ASSERT_EQ(cpp_message::Strategy_Params_Error::NONE,params.parse(""));
+    EXPECT_EQ(0u,params.size());
+}
+
+TEST(StrategyParamsTest, testLongestParams)
+{
+    // The most entries 1000 characters can hold
+    std::string longest;
+    for(size_t i=0;longest.size()+3<=cpp_message::Strategy_Params::MAX_LENGTH;i++)
+    {
+        longest+=(i>0 ? ",k:" : "k:");
+    }
+    cpp_message::Strategy_Params params;
+    ASSERT_EQ(cpp_message::Strategy_Params_Error::NONE,params.parse(longest));
+    EXPECT_EQ(333u,params.size());
+}
+
+TEST(StrategyParamsTest, testGetlineDifferences)
+{
+    // A safety log split with std::getline accepted a trailing comma and an entry without a colon
+    cpp_message::Strategy_Params params;
+    EXPECT_EQ(cpp_message::Strategy_Params_Error::EMPTY_ENTRY,params.parse(SAFETY_LOG+","));
+    EXPECT_EQ(13u,params.size());
+    EXPECT_EQ(cpp_message::Strategy_Params_Error::MISSING_SEPARATOR,params.parse("vin_number:1FUJGHDV0CLBP8834,VA"));
+    EXPECT_EQ(1u,params.size());
+}
+
+TEST(StrategyParamsTest, testMalformed)
+{
+    cpp_message::Strategy_Params params;
+    EXPECT_EQ(cpp_message::Strategy_Params_Error::EMPTY_ENTRY,params.parse("a:1,,b:2"));
+    EXPECT_EQ(1u,params.size());
+    EXPECT_EQ(cpp_message::Strategy_Params_Error::EMPTY_ENTRY,params.parse("a:1,b:2,"));
+    EXPECT_EQ(cpp_message::Strategy_Params_Error::MISSING_SEPARATOR,params.parse("a:1,b"));
+    EXPECT_EQ(cpp_message::Strategy_Params_Error::EMPTY_KEY,params.parse("a:1,:2"));
+
+    std::string too_many;
+    for(size_t i=0;i<=cpp_message::Strategy_Params::MAX_PARAMS;i++)
+    {
+        too_many+=(i>0 ? ",k:" : "k:")+std::to_string(i);
+    }
+    EXPECT_EQ(cpp_message::Strategy_Params_Error::TOO_MANY_ENTRIES,params.parse(too_many));
+    EXPECT_EQ(cpp_message::Strategy_Params::MAX_PARAMS,params.size());
+    EXPECT_EQ("0",params.get("k").value());
+}
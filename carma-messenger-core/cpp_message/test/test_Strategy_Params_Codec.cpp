@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Strategy_Params_Codec.h"
+#include <gtest/gtest.h>
+
+TEST(StrategyParamsCodecTest, testRoundTrip)
+{
+    std::string log="vin_number:1FUJGHDV0CLBP8834,license_plate:DOT-10003,carrier_name:Silver Truck FHWA TFHRC,"
+                    "carrier_id:USDOT 0000001,weight:,ads_software_version:System Version Unknown,"
+                    "date_of_last_state_inspection:YYYY-MM-DD,date_of_last_ads_calibration:YYYY-MM-DD,"
+                    "pre_trip_ads_health_check:Green,ads_status:Red,iss_score:49,permit_required:0,timestamp:1585836731814";
+    std::string compact;
+    ASSERT_TRUE(cpp_message::Strategy_Params_Codec::encode(log,compact));
+    EXPECT_TRUE(cpp_message::Strategy_Params_Codec::is_compact(compact));
+    EXPECT_LT(compact.size(),log.size()/2);
+    for(char c : compact)
+    {
+        EXPECT_LT(static_cast<uint8_t>(c),0x80);
+    }
+    std::string decoded;
+    ASSERT_TRUE(cpp_message::Strategy_Params_Codec::decode(compact,decoded));
+    EXPECT_EQ(log,decoded);
+
+    // Unknown keys, negative numbers, numbers that do not print back the same and colons in values
+    std::string params="timestamp:1585836731814,speed_limit:-25,lane:007,offset:-0,time:12:30,id:0,big:123456789012345678901234";
+    ASSERT_TRUE(cpp_message::Strategy_Params_Codec::encode(params,compact));
+    ASSERT_TRUE(cpp_message::Strategy_Params_Codec::decode(compact,decoded));
+    EXPECT_EQ(params,decoded);
+}
+
+TEST(StrategyParamsCodecTest, testPlainText)
+{
+    std::string compact;
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::encode("[]",compact));
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::encode("a:1,,b:2",compact));
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::encode("a:1",compact)); // Not shorter
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::is_compact("vin_number:1"));
+
+    std::string decoded;
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::decode("vin_number:1",decoded));
+}
+
+TEST(StrategyParamsCodecTest, testUnknownCompact)
+{
+    std::string decoded;
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::decode(std::string("\x01\x07\x03",3),decoded)); // Unknown version
+    // An empty value of key id 0 is complete, the same of the unassigned ids 16 and 30 is not
+    ASSERT_TRUE(cpp_message::Strategy_Params_Codec::decode(std::string("\x01\x00\x03",3),decoded));
+    EXPECT_EQ("vin_number:",decoded);
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::decode(std::string("\x01\x00\x43",3),decoded));
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::decode(std::string("\x01\x00\x7b",3),decoded));
+}
+
+TEST(StrategyParamsCodecTest, testTruncatedCompact)
+{
+    std::string decoded;
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::decode(std::string("\x01\x00\x00\x05" "ab",6),decoded)); // Value
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::decode(std::string("\x01\x00\x7f",3),decoded)); // Literal key
+    EXPECT_FALSE(cpp_message::Strategy_Params_Codec::decode(std::string("\x01\x00\x01\x41",4),decoded)); // Number
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Trajectory_Conflict_Index.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+    /**
+     * @brief Path moving along ECEF x by step_cm every 100 ms
+     */
+    cav_msgs::MobilityPath make_path(const std::string& sender_id, int32_t start_x_cm, int16_t step_cm, uint64_t timestamp)
+    {
+        cav_msgs::MobilityPath path;
+        path.header.sender_id=sender_id;
+        path.trajectory.location.ecef_x=start_x_cm;
+        path.trajectory.location.ecef_y=-484000000;
+        path.trajectory.location.ecef_z=398000000;
+        path.trajectory.location.timestamp=timestamp;
+        cav_msgs::LocationOffsetECEF offset;
+        offset.offset_x=step_cm;
+        path.trajectory.offsets.assign(50,offset);
+        return path;
+    }
+}
+
+TEST(TrajectoryConflictIndexTest, testConflictEvents)
+{
+    cpp_message::Trajectory_Conflict_Index index(2.0,1000);
+    std::vector<cpp_message::Trajectory_Conflict_Event> events;
+
+    // Host drives 5 m per 100 ms from x = 1000 m, a neighbor waits 100 m ahead
+    index.update(make_path("HOST",100000,500,1000000),events);
+    EXPECT_TRUE(events.empty());
+    index.update(make_path("STOPPED",110000,0,1000000),events);
+    ASSERT_EQ(1,events.size());
+    EXPECT_EQ("STOPPED",events[0].vehicle_id);
+    EXPECT_EQ("HOST",events[0].conflict.other_id);
+    EXPECT_TRUE(events[0].in_conflict);
+    EXPECT_EQ(1001000,events[0].conflict.time); // The host passes 2 s in, within the window of the point 1 s in
+    EXPECT_EQ(1002000,events[0].conflict.other_time);
+
+    // A vehicle beside the path never conflicts
+    events.clear();
+    cav_msgs::MobilityPath beside=make_path("BESIDE",110000,0,1000000);
+    beside.trajectory.location.ecef_y+=1000;
+    index.update(beside,events);
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(3,index.size());
+
+    // Querying the host path finds the stopped vehicle when the host reaches it after 2 s
+    std::vector<cpp_message::Trajectory_Conflict> conflicts=index.query(make_path("HOST",100000,500,1000000).trajectory,"HOST");
+    ASSERT_EQ(1,conflicts.size());
+    EXPECT_EQ("STOPPED",conflicts[0].other_id);
+    EXPECT_NEAR(1002000,conflicts[0].time,100);
+    EXPECT_LE(conflicts[0].distance,2.0);
+
+    // The host changes lanes, which clears the conflict
+    cav_msgs::MobilityPath changed=make_path("HOST",100000,500,1000100);
+    changed.trajectory.location.ecef_y-=400;
+    index.update(changed,events);
+    ASSERT_EQ(1,events.size());
+    EXPECT_EQ("HOST",events[0].vehicle_id);
+    EXPECT_EQ("STOPPED",events[0].conflict.other_id);
+    EXPECT_FALSE(events[0].in_conflict);
+    // The mirrored conflict kept by the host holds the times from its own side
+    EXPECT_EQ(1002000,events[0].conflict.time);
+    EXPECT_EQ(1001000,events[0].conflict.other_time);
+}
+
+TEST(TrajectoryConflictIndexTest, testExpiry)
+{
+    cpp_message::Trajectory_Conflict_Index index(2.0,1000);
+    std::vector<cpp_message::Trajectory_Conflict_Event> events;
+    index.update(make_path("A",100000,100,1000000),events);
+    index.update(make_path("B",100000,100,1000000),events);
+    ASSERT_EQ(1,events.size());
+
+    // Paths end 5 s after their start and are kept for the conflict window after that
+    events.clear();
+    index.remove_expired(1006000,events);
+    EXPECT_TRUE(events.empty());
+    index.remove_expired(1006001,events);
+    EXPECT_EQ(0,index.size());
+    ASSERT_EQ(1,events.size());
+    EXPECT_FALSE(events[0].in_conflict);
+
+    // Slots are reused
+    events.clear();
+    index.update(make_path("C",100000,100,2000000),events);
+    index.update(make_path("D",100000,100,2000000),events);
+    EXPECT_EQ(1,events.size());
+    EXPECT_EQ(2,index.size());
+}
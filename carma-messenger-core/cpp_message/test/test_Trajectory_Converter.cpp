@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Trajectory_Converter.h"
+#include <gtest/gtest.h>
+
+TEST(TrajectoryConverterTest, testIntegrateOffsets)
+{
+    cav_msgs::Trajectory trajectory;
+    trajectory.location.ecef_x=100000;
+    trajectory.location.ecef_y=200000;
+    trajectory.location.ecef_z=300000;
+    cav_msgs::LocationOffsetECEF offset;
+    offset.offset_x=100;
+    offset.offset_y=-50;
+    offset.offset_z=1;
+    trajectory.offsets.push_back(offset);
+    trajectory.offsets.push_back(offset);
+    offset.offset_x=cpp_message::Trajectory_Converter::OFFSET_UNAVAILABLE;
+    trajectory.offsets.push_back(offset);
+    trajectory.offsets.push_back(offset);
+
+    cpp_message::Cartesian_Points ecef;
+    EXPECT_EQ(3,cpp_message::Trajectory_Converter::integrate_offsets(trajectory,ecef));
+    ASSERT_EQ(3,ecef.size());
+    EXPECT_DOUBLE_EQ(1000.0,ecef.x[0]);
+    EXPECT_DOUBLE_EQ(1002.0,ecef.x[2]);
+    EXPECT_DOUBLE_EQ(1999.0,ecef.y[2]);
+    EXPECT_DOUBLE_EQ(3000.02,ecef.z[2]);
+}
+
+TEST(TrajectoryConverterTest, testEcefToGeodetic)
+{
+    // Points from the equator to near the poles and from below the surface to aircraft altitude
+    const double latitudes[]={0.0,38.9549,-33.8688,60.0,89.0};
+    const double longitudes[]={0.0,-77.1460,151.2093,-179.5,45.0};
+    const double heights[]={0.0,-30.0,58.0,1000.0,10000.0};
+    cpp_message::Cartesian_Points ecef;
+    ecef.resize(5);
+    for(size_t i=0;i<5;i++)
+    {
+        cpp_message::Trajectory_Converter::geodetic_to_ecef(latitudes[i],longitudes[i],heights[i],ecef.x[i],ecef.y[i],ecef.z[i]);
+    }
+
+    cpp_message::Geodetic_Points geodetic;
+    cpp_message::Trajectory_Converter::ecef_to_geodetic(ecef,geodetic);
+    ASSERT_EQ(5,geodetic.size());
+    for(size_t i=0;i<5;i++)
+    {
+        // 1e-8 degrees is about a millimeter
+        EXPECT_NEAR(latitudes[i],geodetic.latitude[i],1e-8);
+        EXPECT_NEAR(longitudes[i],geodetic.longitude[i],1e-8);
+        EXPECT_NEAR(heights[i],geodetic.height[i],0.001);
+    }
+}
+
+TEST(TrajectoryConverterTest, testEcefToLocal)
+{
+    cpp_message::Cartesian_Points ecef;
+    ecef.resize(3);
+    cpp_message::Trajectory_Converter::geodetic_to_ecef(38.9549,-77.1460,10.0,ecef.x[0],ecef.y[0],ecef.z[0]);
+    cpp_message::Trajectory_Converter::geodetic_to_ecef(38.9549,-77.1460,20.0,ecef.x[1],ecef.y[1],ecef.z[1]);
+    cpp_message::Trajectory_Converter::geodetic_to_ecef(38.9559,-77.1460,10.0,ecef.x[2],ecef.y[2],ecef.z[2]);
+
+    cpp_message::Cartesian_Points local;
+    cpp_message::Trajectory_Converter::ecef_to_local(ecef,38.9549,-77.1460,10.0,local);
+    ASSERT_EQ(3,local.size());
+    EXPECT_NEAR(0.0,local.x[0],0.001);
+    EXPECT_NEAR(0.0,local.y[0],0.001);
+    EXPECT_NEAR(0.0,local.z[0],0.001);
+    EXPECT_NEAR(10.0,local.z[1],0.001);
+    EXPECT_NEAR(0.0,local.x[2],0.001);
+    EXPECT_NEAR(111.0,local.y[2],0.2); // A thousandth of a degree of latitude
+}
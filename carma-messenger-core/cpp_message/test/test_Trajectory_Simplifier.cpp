@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "Trajectory_Simplifier.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+    cav_msgs::LocationOffsetECEF offset(int x, int y, int z)
+    {
+        cav_msgs::LocationOffsetECEF out;
+        out.offset_x=x;
+        out.offset_y=y;
+        out.offset_z=z;
+        return out;
+    }
+}
+
+TEST(TrajectorySimplifierTest, testStraightLine)
+{
+    cav_msgs::Trajectory trajectory;
+    trajectory.location.ecef_x=100000;
+    for(int i=0;i<80;i++)
+    {
+        trajectory.offsets.push_back(offset(100,0,0));
+    }
+
+    // A straight line is only split to keep the offsets in range
+    cav_msgs::Trajectory simplified;
+    ASSERT_TRUE(cpp_message::Trajectory_Simplifier::simplify(trajectory,0.1,60,simplified));
+    EXPECT_EQ(100000,simplified.location.ecef_x);
+    int64_t x=simplified.location.ecef_x;
+    for(const auto& o : simplified.offsets)
+    {
+        EXPECT_LE(o.offset_x,cpp_message::Trajectory_Simplifier::OFFSET_MAX);
+        x+=o.offset_x;
+    }
+    EXPECT_EQ(108000,x);
+    EXPECT_LE(simplified.offsets.size(),20u);
+    EXPECT_GE(simplified.offsets.size(),16u);
+
+    // Too few offsets to keep the offsets in range
+    EXPECT_FALSE(cpp_message::Trajectory_Simplifier::simplify(trajectory,0.1,10,simplified));
+}
+
+TEST(TrajectorySimplifierTest, testCorner)
+{
+    cav_msgs::Trajectory trajectory;
+    for(int i=0;i<10;i++)
+    {
+        trajectory.offsets.push_back(offset(30,0,0));
+    }
+    for(int i=0;i<10;i++)
+    {
+        trajectory.offsets.push_back(offset(0,30,1));
+    }
+
+    cav_msgs::Trajectory simplified;
+    ASSERT_TRUE(cpp_message::Trajectory_Simplifier::simplify(trajectory,0.1,60,simplified));
+    ASSERT_EQ(2u,simplified.offsets.size());
+    EXPECT_EQ(300,simplified.offsets[0].offset_x);
+    EXPECT_EQ(0,simplified.offsets[0].offset_y);
+    EXPECT_EQ(300,simplified.offsets[1].offset_y);
+    EXPECT_EQ(10,simplified.offsets[1].offset_z);
+
+    // A single offset can not keep the corner within the tolerance but is the most that is allowed
+    ASSERT_TRUE(cpp_message::Trajectory_Simplifier::simplify(trajectory,0.1,1,simplified));
+    ASSERT_EQ(1u,simplified.offsets.size());
+    EXPECT_EQ(300,simplified.offsets[0].offset_x);
+    EXPECT_EQ(300,simplified.offsets[0].offset_y);
+
+    // Unavailable offsets are not simplified
+    trajectory.offsets.push_back(offset(501,0,0));
+    EXPECT_FALSE(cpp_message::Trajectory_Simplifier::simplify(trajectory,0.1,60,simplified));
+}
+
+TEST(TrajectorySimplifierTest, testOutOfRange)
+{
+    cav_msgs::Trajectory trajectory;
+    trajectory.offsets.push_back(offset(100,0,0));
+    trajectory.offsets.push_back(offset(-600,0,0));
+    trajectory.offsets.push_back(offset(100,0,0));
+
+    // Offsets beyond the J2735 range can not be encoded, so they are not simplified either
+    cav_msgs::Trajectory simplified;
+    EXPECT_FALSE(cpp_message::Trajectory_Simplifier::simplify(trajectory,0.1,60,simplified));
+    EXPECT_TRUE(simplified.offsets.empty());
+}
+
+TEST(TrajectorySimplifierTest, testEncodeSimplified)
+{
+    cav_msgs::Trajectory trajectory;
+    for(int i=0;i<40;i++)
+    {
+        trajectory.offsets.push_back(offset(10,i<20 ? 0 : 10,0));
+    }
+    cav_msgs::Trajectory original=trajectory;
+
+    // Sizes of 10 bytes per offset, the target of 15 bytes can not be met but is approached
+    std::vector<size_t> encoded_offsets;
+    auto encode=[&]{
+        encoded_offsets.push_back(trajectory.offsets.size());
+        return boost::optional<std::vector<uint8_t>>(std::vector<uint8_t>(10*trajectory.offsets.size()));
+    };
+    cpp_message::Trajectory_Simplification simplification;
+    simplification.enabled=true;
+    simplification.max_bytes=15;
+    auto res=cpp_message::Trajectory_Simplifier::encode_simplified(trajectory,simplification,60,encode,"test");
+    ASSERT_TRUE(res);
+    ASSERT_EQ(2u,encoded_offsets.size());
+    EXPECT_EQ(2u,encoded_offsets[0]);  // The corner
+    EXPECT_EQ(1u,encoded_offsets[1]);
+    EXPECT_EQ(10u,res->size());
+    ASSERT_EQ(1u,trajectory.offsets.size());
+    EXPECT_EQ(400,trajectory.offsets[0].offset_x);
+
+    // Disabled or failed simplification encodes the original trajectory
+    simplification.enabled=false;
+    trajectory=original;
+    encoded_offsets.clear();
+    res=cpp_message::Trajectory_Simplifier::encode_simplified(trajectory,simplification,60,encode,"test");
+    ASSERT_EQ(1u,encoded_offsets.size());
+    EXPECT_EQ(40u,encoded_offsets[0]);
+
+    simplification.enabled=true;
+    trajectory.offsets.push_back(offset(501,0,0));
+    encoded_offsets.clear();
+    res=cpp_message::Trajectory_Simplifier::encode_simplified(trajectory,simplification,60,encode,"test");
+    ASSERT_EQ(1u,encoded_offsets.size());
+    EXPECT_EQ(41u,encoded_offsets[0]);
+    EXPECT_EQ(41u,trajectory.offsets.size());
+}
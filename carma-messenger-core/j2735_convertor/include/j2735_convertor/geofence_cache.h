@@ -0,0 +1,125 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ros/time.h>
+#include <cav_msgs/TrafficControlMessageV01.h>
+#include "geofence_coverage.h"
+#include "geofence_store.h"
+
+namespace j2735_convertor
+{
+/**
+ * @class GeofenceCache
+ * @brief On disk log of geofences which allows a GeofenceStore to be restored at startup
+ *
+ * The file starts with a magic number and a format version followed by one record per stored geofence. A record is
+ * the length and FNV-1a checksum of the payload followed by the ROS serialization of the
+ * cav_msgs::TrafficControlMessageV01. New geofences are appended. Records superseded by a newer version of the same
+ * traffic control id stay in the file until it is compacted.
+ *
+ * At startup the file is memory mapped and every record is deserialized straight from the mapping into the store. A
+ * truncated or corrupt tail, as left by a crash during an append, ends the load and is dropped by the compaction
+ * which follows it.
+ *
+ * The GeofenceCoverage of the store is saved next to the cache file, in <path>.coverage. It is small and rewritten as a
+ * whole whenever a request completes.
+ *
+ * The cache is not thread safe. It is expected to be used from the thread which updates the store.
+ */
+class GeofenceCache
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param path Location of the cache file. It is created if it does not exist
+   */
+  explicit GeofenceCache(const std::string& path);
+
+  /**
+   * @brief Add every geofence of the cache file to the store, drop the expired ones and rewrite the file with the
+   * remaining geofences
+   *
+   * @param store The store to restore
+   * @param now Time used to expire geofences whose schedule has ended
+   *
+   * @return The number of geofences in the store after loading
+   */
+  size_t load(GeofenceStore& store, const ros::Time& now);
+
+  /**
+   * @brief Append a geofence to the cache file
+   *
+   * @return False if the file could not be written
+   */
+  bool append(const cav_msgs::TrafficControlMessageV01& geofence);
+
+  /**
+   * @brief Returns true if the file holds enough superseded records to be worth compacting
+   *
+   * @param live_count The number of geofences currently in the store
+   */
+  bool needsCompaction(size_t live_count) const;
+
+  /**
+   * @brief Replace the cache file with one record per provided geofence
+   *
+   * The new file is written next to the old one and renamed over it, so a crash leaves either version intact.
+   *
+   * @return False if the file could not be written
+   */
+  bool compact(const std::vector<GeofenceStore::GeofencePtr>& geofences);
+
+  /**
+   * @brief Returns the coverage saved next to the cache file
+   *
+   * Nothing is returned unless the last load restored every record of an existing cache file, as the coverage could
+   * otherwise claim geofences the store is missing.
+   */
+  std::vector<GeofenceCoverage::Area> loadCoverage() const;
+
+  /**
+   * @brief Replace the coverage saved next to the cache file
+   *
+   * @return False if the file could not be written
+   */
+  bool saveCoverage(const std::vector<GeofenceCoverage::Area>& areas);
+
+private:
+  static constexpr uint32_t MAGIC = 0x47464331;  // "GFC1"
+  static constexpr uint32_t FORMAT_VERSION = 1;
+  static constexpr uint32_t COVERAGE_MAGIC = 0x47464131;  // "GFA1"
+
+  /**
+   * @brief Serialize a record for a geofence into buffer_
+   */
+  void serializeRecord(const cav_msgs::TrafficControlMessageV01& geofence);
+
+  /**
+   * @brief Write the file header and every provided geofence to a file descriptor
+   */
+  bool writeFile(int fd, const std::vector<GeofenceStore::GeofencePtr>& geofences);
+
+  std::string path_;
+  size_t record_count_ = 0;     // Records in the file including superseded ones
+  bool restored_ = false;        // The last load read every record of an existing file
+  std::vector<uint8_t> buffer_;  // Serialization buffer reused between records
+};
+}  // namespace j2735_convertor
@@ -0,0 +1,140 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cav_msgs/TrafficControlMessageV01.h>
+#include "geofence_projection.h"
+#include "local_frame.h"
+
+namespace j2735_convertor
+{
+/**
+ * @brief Boundary polygon of a single version of a geofence
+ *
+ * The centerline holds the absolute position and width of every path node. The boundary is a closed ring made of the
+ * left edge from the first to the last node followed by the right edge from the last to the first node, so its size
+ * is twice the centerline size. Positions are in meters in the local frame of the GeofenceCompiler which produced it.
+ */
+struct GeofencePolygon
+{
+  j2735_msgs::Id128b id;
+  ros::Time updated;
+
+  // Latitude and longitude in degrees of the frame origin
+  double origin_latitude = 0.0;
+  double origin_longitude = 0.0;
+
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> width;
+
+  std::vector<double> boundary_x;
+  std::vector<double> boundary_y;
+};
+
+/**
+ * @class GeofenceCompiler
+ * @brief Converts traffic control geometries into boundary polygons in one local frame
+ *
+ * The first path node is offset from the geometry reference point and every following node from the previous node.
+ * The offsets are accumulated in the frame described by the geometry proj string and the resulting positions are
+ * moved into the compiler frame. Geometries with an empty proj string are treated as east/north offsets around the
+ * reference point. Geometries with an unsupported proj string are not compiled, as their offsets cannot be placed.
+ * Nodes without a width keep the width of the previous node.
+ *
+ * The compiler frame is a LocalFrame, which may be shared with an IntersectionGeometryStore so polygons line up with
+ * the lanes. Without an origin set explicitly or by the other users of the frame the reference point of the first
+ * compiled geofence is used.
+ *
+ * Parsed projections are cached by proj string and polygons by traffic control id and updated time, so compiling a
+ * rebroadcast of an unchanged geofence costs one lookup. The projection cache is cleared once it holds
+ * MAX_PROJECTIONS proj strings, polygons are kept until removed.
+ *
+ * The compiler is thread safe. Polygons are immutable once returned.
+ */
+class GeofenceCompiler
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param frame The frame of the compiled polygons
+   */
+  explicit GeofenceCompiler(std::shared_ptr<LocalFrame> frame = std::make_shared<LocalFrame>());
+
+  /**
+   * @brief Set the latitude and longitude in degrees of the origin of the compiler frame
+   *
+   * Has no effect once the frame origin is set, so it must be called before the first compile
+   */
+  void setOrigin(double latitude, double longitude);
+
+  /**
+   * @brief Returns the polygon of a geofence, compiling it unless the same version was compiled before
+   *
+   * @return The polygon or nullptr if the geofence has no geometry or an unsupported proj string
+   */
+  std::shared_ptr<const GeofencePolygon> compile(const cav_msgs::TrafficControlMessageV01& geofence);
+
+  /**
+   * @brief Returns the last polygon compiled for a traffic control id or nullptr if there is none
+   */
+  std::shared_ptr<const GeofencePolygon> lookup(const j2735_msgs::Id128b& id) const;
+
+  /**
+   * @brief Forget the polygon of a traffic control id
+   */
+  void remove(const j2735_msgs::Id128b& id);
+
+  /**
+   * @brief Returns the number of cached polygons
+   */
+  size_t size() const;
+
+  /**
+   * @brief Returns the number of cached projections
+   */
+  size_t projectionCount() const;
+
+  // Proj strings cached at most, geofences rarely use more than a few
+  static constexpr size_t MAX_PROJECTIONS = 64;
+
+private:
+  /**
+   * @brief Returns the projection for a proj string, parsing it on first use. The caller must hold mutex_
+   */
+  std::shared_ptr<const GeofenceProjection> projection(const std::string& proj);
+
+  /**
+   * @brief Build the polygon of a geofence, nullptr if its proj string is not supported. The caller must hold mutex_
+   */
+  std::shared_ptr<GeofencePolygon> build(const cav_msgs::TrafficControlMessageV01& geofence);
+
+  static std::string key(const j2735_msgs::Id128b& id);
+
+  std::shared_ptr<LocalFrame> frame_;
+
+  // Parsed projection by proj string, nullptr for unsupported strings so they are only parsed once
+  std::unordered_map<std::string, std::shared_ptr<const GeofenceProjection>> projections_;
+  std::unordered_map<std::string, std::shared_ptr<const GeofencePolygon>> polygons_;  // By traffic control id
+  mutable std::mutex mutex_;
+};
+}  // namespace j2735_convertor
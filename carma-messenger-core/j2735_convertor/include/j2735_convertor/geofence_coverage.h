@@ -0,0 +1,100 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <ros/time.h>
+#include <cav_msgs/TrafficControlMessageV01.h>
+#include <cav_msgs/TrafficControlRequestV01.h>
+#include "packed_rtree.h"
+
+namespace j2735_convertor
+{
+/**
+ * @class GeofenceCoverage
+ * @brief Areas for which a GeofenceStore is known to hold every geofence, used to narrow outgoing requests
+ *
+ * An outgoing TrafficControlRequest is tracked by its request id until every one of its msgtot responses arrived. Its
+ * bounds are then covered: every geofence within them updated since bounds.oldest has been received by the time the
+ * request was sent.
+ *
+ * A later request whose bounds lie within a covered area only needs the geofences updated since that area was
+ * complete, so the oldest time of those bounds is raised accordingly. Bounds which are not covered are sent unchanged,
+ * so a request is complete on its own when nothing is covered. A request whose responses never all arrive, including
+ * one which no geofence answers, covers nothing.
+ *
+ * The coverage is not thread safe. It is expected to be used from the thread which updates the store.
+ */
+class GeofenceCoverage
+{
+public:
+  struct Area
+  {
+    PackedRTree::Box extent;  // Longitude as x and latitude as y in degrees
+    ros::Time oldest;         // Every geofence within the extent updated since this time
+    ros::Time complete;       // was received by this time
+  };
+
+  // Times are compared across the vehicle and server clocks, so covered areas are trusted this much less recently
+  static constexpr double CLOCK_MARGIN = 5.0;
+
+  /**
+   * @brief Narrow the bounds of an outgoing request to what the store may be missing and track its responses
+   *
+   * @param request The request to send. The oldest time of each bounds within a covered area is raised.
+   * @param now The time the request is sent
+   *
+   * @return The number of narrowed bounds
+   */
+  size_t trackRequest(cav_msgs::TrafficControlRequestV01& request, const ros::Time& now);
+
+  /**
+   * @brief Account a response to a tracked request. The request is covered once every response arrived.
+   *
+   * @return True if the response completed its request
+   */
+  bool addResponse(const cav_msgs::TrafficControlMessageV01& response);
+
+  /**
+   * @brief Returns the covered areas, oldest first
+   */
+  std::vector<Area> getAreas() const;
+
+  /**
+   * @brief Replace the covered areas, e.g. with those saved by a GeofenceCache
+   */
+  void restore(const std::vector<Area>& areas);
+
+private:
+  static constexpr size_t MAX_PENDING_REQUESTS = 16;
+  static constexpr size_t MAX_AREAS = 64;
+
+  struct PendingRequest
+  {
+    std::string reqid;
+    std::vector<Area> areas;     // Bounds as requested before narrowing
+    std::vector<bool> received;  // By msgnum - 1, sized by the first response
+    size_t remaining = 0;
+  };
+
+  void cover(const Area& area);
+
+  std::deque<PendingRequest> pending_;
+  std::deque<Area> areas_;
+};
+}  // namespace j2735_convertor
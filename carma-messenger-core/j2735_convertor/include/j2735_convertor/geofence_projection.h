@@ -0,0 +1,67 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <string>
+
+namespace j2735_convertor
+{
+/**
+ * @class GeofenceProjection
+ * @brief Transverse Mercator projection on the WGS84 ellipsoid described by a proj string
+ *
+ * Supports the proj strings used by traffic control messages, "+proj=tmerc" with +lat_0, +lon_0, +k or +k_0, +x_0 and
+ * +y_0, and "+proj=utm" with +zone and +south. The datum and ellipsoid must be WGS84 or GRS80 if given and the units
+ * meters. Other parameters like +no_defs or +vunits are ignored.
+ *
+ * The series expansion used is accurate to millimeters within a few degrees of the central meridian.
+ */
+class GeofenceProjection
+{
+public:
+  /**
+   * @brief Parse a proj string
+   *
+   * @return The projection or nullptr if the string is empty or describes an unsupported projection
+   */
+  static std::shared_ptr<const GeofenceProjection> parse(const std::string& proj);
+
+  /**
+   * @brief Convert a latitude and longitude in degrees into projected easting and northing in meters
+   */
+  void forward(double latitude, double longitude, double& x, double& y) const;
+
+  /**
+   * @brief Convert projected easting and northing in meters into a latitude and longitude in degrees
+   */
+  void inverse(double x, double y, double& latitude, double& longitude) const;
+
+private:
+  GeofenceProjection(double lat_0, double lon_0, double k_0, double x_0, double y_0);
+
+  /**
+   * @brief Returns the meridian distance from the equator to a latitude in radians
+   */
+  static double meridianDistance(double phi);
+
+  double lon_0_;  // Radians
+  double k_0_;
+  double x_0_;
+  double y_0_;
+  double m_0_;  // Meridian distance of lat_0
+};
+}  // namespace j2735_convertor
@@ -0,0 +1,130 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ros/time.h>
+#include <cav_msgs/TrafficControlMessageV01.h>
+#include "timer_wheel.h"
+
+namespace j2735_convertor
+{
+/**
+ * @brief Find the first interval in which a schedule is active that ends after the provided time
+ *
+ * The schedule is active between start and end on the days enabled in dow, inside the between windows of those days
+ * and inside the repeat spans of those windows. A missing dow, between or repeat field does not restrict the schedule.
+ * Adjacent intervals, such as consecutive whole days, are merged. Times are evaluated to the second in UTC.
+ *
+ * @param schedule The schedule to evaluate
+ * @param time The time to search from
+ * @param begin Set to the start of the interval. This may be before time if the schedule is already active
+ * @param end Set to the end of the interval
+ *
+ * @return False if the schedule is not active at or after time
+ */
+bool nextActiveInterval(const cav_msgs::TrafficControlSchedule& schedule, const ros::Time& time, ros::Time& begin,
+                        ros::Time& end);
+
+/**
+ * @brief Activation state change of a geofence
+ */
+struct ScheduleEvent
+{
+  j2735_msgs::Id128b id;
+  bool active;
+  ros::Time stamp;
+};
+
+/**
+ * @class GeofenceScheduler
+ * @brief Tracks when the schedules of geofences activate and deactivate
+ *
+ * Each schedule is compiled into its next transition instant which is placed on a TimerWheel with one second ticks.
+ * Advancing the scheduler only evaluates the geofences whose transition is due, so the cost is proportional to the
+ * number of transitions rather than to the number of geofences. Geofences without params are always active. A
+ * geofence which will never be active again is forgotten after its deactivation is reported.
+ *
+ * The scheduler is not thread safe.
+ */
+class GeofenceScheduler
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param now The current time
+   */
+  explicit GeofenceScheduler(const ros::Time& now);
+
+  /**
+   * @brief Add or replace the schedule of a geofence
+   *
+   * @param geofence The geofence to schedule. Geofences are identified by their traffic control id
+   * @param now The current time
+   * @param events An event is appended if the geofence changes state
+   */
+  void update(const cav_msgs::TrafficControlMessageV01& geofence, const ros::Time& now,
+              std::vector<ScheduleEvent>& events);
+
+  /**
+   * @brief Evaluate every geofence whose transition is due
+   *
+   * @param now The current time
+   * @param events Appended with an event for every geofence which changed state
+   */
+  void advance(const ros::Time& now, std::vector<ScheduleEvent>& events);
+
+  /**
+   * @brief Returns true if the geofence is known and was active when last evaluated
+   */
+  bool isActive(const j2735_msgs::Id128b& id) const;
+
+  /**
+   * @brief Returns the number of tracked geofences
+   */
+  size_t size() const
+  {
+    return entry_index_.size();
+  }
+
+private:
+  struct Entry
+  {
+    j2735_msgs::Id128b id;
+    bool params_exists = false;
+    cav_msgs::TrafficControlSchedule schedule;
+    bool active = false;
+    uint32_t generation = 0;  // Incremented whenever pending timers of the entry become stale
+    bool used = false;
+  };
+
+  /**
+   * @brief Compute the state of an entry at the provided time, report a change and schedule its next transition
+   */
+  void evaluate(uint32_t index, const ros::Time& now, std::vector<ScheduleEvent>& events);
+
+  static std::string key(const j2735_msgs::Id128b& id);
+
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> free_entries_;
+  std::unordered_map<std::string, uint32_t> entry_index_;  // Index into entries_ by traffic control id
+  TimerWheel wheel_;  // Timer ids hold the entry generation in the upper and the entry index in the lower 32 bits
+  std::vector<uint64_t> expired_;
+};
+}  // namespace j2735_convertor
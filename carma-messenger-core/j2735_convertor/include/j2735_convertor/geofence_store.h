@@ -0,0 +1,116 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ros/time.h>
+#include <cav_msgs/TrafficControlMessageV01.h>
+#include <cav_msgs/TrafficControlRequestV01.h>
+#include "packed_rtree.h"
+
+namespace j2735_convertor
+{
+/**
+ * @class GeofenceStore
+ * @brief Store of received traffic control messages indexed by the extent of their geometry
+ *
+ * Geofences are keyed by their traffic control id. A geofence with a newer updated time replaces the stored one,
+ * rebroadcasts of the stored version are rejected.
+ * The extent of a geofence is the latitude/longitude bounding box of its path nodes grown by half the node width. The
+ * first node is offset from the geometry reference point and every following node from the previous node.
+ *
+ * The extents are indexed in a PackedRTree which is rebuilt on the first query after the stored geofences changed.
+ * TrafficControlRequest bounds are answered in O(log n) plus the number of geofences whose extent intersects them.
+ *
+ * The store is thread safe. Returned geofences are immutable.
+ */
+class GeofenceStore
+{
+public:
+  using GeofencePtr = std::shared_ptr<const cav_msgs::TrafficControlMessageV01>;
+
+  /**
+   * @brief Add or replace a geofence
+   *
+   * @return False if the geofence has no geometry or the same or a newer version of it is already stored
+   */
+  bool add(const cav_msgs::TrafficControlMessageV01& geofence);
+
+  /**
+   * @brief Returns true if the same or a newer version of the geofence is stored
+   */
+  bool holds(const cav_msgs::TrafficControlMessageV01& geofence) const;
+
+  /**
+   * @brief Remove every geofence whose schedule ended before the provided time
+   *
+   * @return The ids of the removed geofences
+   */
+  std::vector<j2735_msgs::Id128b> removeExpired(const ros::Time& now);
+
+  /**
+   * @brief Returns the stored geofences updated no earlier than bounds.oldest whose extent intersects the bounds
+   */
+  std::vector<GeofencePtr> query(const cav_msgs::TrafficControlBounds& bounds) const;
+
+  /**
+   * @brief Returns the stored geofences matching any of the bounds of a request. Each geofence is returned once.
+   */
+  std::vector<GeofencePtr> query(const cav_msgs::TrafficControlRequestV01& request) const;
+
+  /**
+   * @brief Returns every stored geofence
+   */
+  std::vector<GeofencePtr> getGeofences() const;
+
+  /**
+   * @brief Returns the number of stored geofences
+   */
+  size_t size() const;
+
+  /**
+   * @brief Returns the longitude/latitude box in degrees spanned by request bounds
+   */
+  static PackedRTree::Box extent(const cav_msgs::TrafficControlBounds& bounds);
+
+private:
+  struct Entry
+  {
+    GeofencePtr geofence;
+    PackedRTree::Box extent;  // Longitude as x and latitude as y in degrees
+  };
+
+  /**
+   * @brief Visit the index of every entry matching the bounds. The caller must hold mutex_
+   */
+  template <typename Visitor>
+  void visit(const cav_msgs::TrafficControlBounds& bounds, Visitor visitor) const;
+
+  static PackedRTree::Box extent(const cav_msgs::TrafficControlGeometry& geometry);
+  static std::string key(const cav_msgs::TrafficControlMessageV01& geofence);
+
+  std::vector<Entry> entries_;
+  std::unordered_map<std::string, size_t> entry_index_;  // Index into entries_ by traffic control id
+
+  mutable PackedRTree tree_;  // Rebuilt lazily over entries_ when dirty_ is set
+  mutable bool dirty_ = false;
+  mutable std::mutex mutex_;
+};
+}  // namespace j2735_convertor
@@ -0,0 +1,141 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <cav_msgs/MapData.h>
+#include <cav_msgs/SPAT.h>
+
+namespace j2735_convertor
+{
+/**
+ * @class IntersectionDemux
+ * @brief Splits converted SPAT and MAP messages into one message per intersection id
+ *
+ * Each intersection id is routed to its own sink, which is created by the provided factory the first time the id is
+ * received. A sink is anything with the publish(message) and getNumSubscribers() of a ros::Publisher. The node uses
+ * publishers on incoming_spat/intersection_<id> and incoming_map/intersection_<id>, see topic().
+ *
+ * The split messages are reused between calls, so only the intersection itself is copied.
+ */
+template <typename Sink>
+class IntersectionDemux
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param make_sink Creates the sink of an intersection id when it is first received
+   */
+  explicit IntersectionDemux(std::function<Sink(uint16_t)> make_sink) : make_sink_(make_sink)
+  {
+  }
+
+  /**
+   * @brief Returns the topic of an intersection, base/intersection_<id>
+   */
+  static std::string topic(const std::string& base, uint16_t intersection_id)
+  {
+    return base + "/intersection_" + std::to_string(intersection_id);
+  }
+
+  /**
+   * @brief Publish each intersection of a SPAT to its sink. Intersections whose sink has no subscribers are skipped
+   */
+  void publishSpat(const cav_msgs::SPAT& message)
+  {
+    for (const cav_msgs::IntersectionState& state : message.intersection_state_list)
+    {
+      Sink& sink = getSink(state.id.id);
+      if (sink.getNumSubscribers() == 0)
+      {
+        continue;  // Avoid copying and serializing intersections nobody is interested in
+      }
+      spat_msg_.time_stamp = message.time_stamp;
+      spat_msg_.time_stamp_exists = message.time_stamp_exists;
+      spat_msg_.name = message.name;
+      spat_msg_.name_exists = message.name_exists;
+      spat_msg_.intersection_state_list.resize(1);
+      spat_msg_.intersection_state_list[0] = state;
+      sink.publish(spat_msg_);
+    }
+  }
+
+  /**
+   * @brief Publish each intersection of a MapData to its sink
+   *
+   * MAP sinks are expected to be latched, so they are published without subscribers to serve late subscribers
+   */
+  void publishMap(const cav_msgs::MapData& message)
+  {
+    for (const cav_msgs::IntersectionGeometry& geometry : message.intersections)
+    {
+      Sink& sink = getSink(geometry.id.id);
+      map_msg_.header = message.header;
+      map_msg_.time_stamp = message.time_stamp;
+      map_msg_.time_stamp_exists = message.time_stamp_exists;
+      map_msg_.msg_issue_revision = message.msg_issue_revision;
+      map_msg_.layer_type = message.layer_type;
+      map_msg_.layer_id = message.layer_id;
+      map_msg_.layer_id_exists = message.layer_id_exists;
+      map_msg_.intersections_exists = true;
+      map_msg_.intersections.resize(1);
+      map_msg_.intersections[0] = geometry;
+      map_msg_.data_parameters = message.data_parameters;
+      map_msg_.data_parameters_exists = message.data_parameters_exists;
+      map_msg_.restriction_class_list = message.restriction_class_list;
+      map_msg_.restriction_list_exists = message.restriction_list_exists;
+      sink.publish(map_msg_);
+    }
+  }
+
+  /**
+   * @brief Returns the sink of an intersection or nullptr if the intersection was never received
+   */
+  Sink* findSink(uint16_t intersection_id)
+  {
+    auto it = sinks_.find(intersection_id);
+    return it == sinks_.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * @brief Returns the number of intersections with a sink
+   */
+  size_t size() const
+  {
+    return sinks_.size();
+  }
+
+private:
+  Sink& getSink(uint16_t intersection_id)
+  {
+    auto it = sinks_.find(intersection_id);
+    if (it == sinks_.end())
+    {
+      it = sinks_.emplace(intersection_id, make_sink_(intersection_id)).first;
+    }
+    return it->second;
+  }
+
+  std::function<Sink(uint16_t)> make_sink_;
+  std::unordered_map<uint16_t, Sink> sinks_;  // Keyed by intersection id
+  cav_msgs::SPAT spat_msg_;
+  cav_msgs::MapData map_msg_;
+};
+}  // namespace j2735_convertor
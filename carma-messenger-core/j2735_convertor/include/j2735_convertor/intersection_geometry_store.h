@@ -0,0 +1,146 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cav_msgs/MapData.h>
+#include "local_frame.h"
+
+namespace j2735_convertor
+{
+/**
+ * @brief Absolute lane geometry of a single revision of an intersection
+ *
+ * Lanes are stored as structure of arrays. The points of lane i are the entries
+ * [lane_offsets[i], lane_offsets[i + 1]) of x, y and width. Positions are in meters in the local frame of the
+ * IntersectionGeometryStore which produced this geometry.
+ */
+struct IntersectionGeometry
+{
+  uint16_t id = 0;
+  uint8_t revision = 0;
+  double ref_x = 0.0;  // Position of the intersection reference point in the store frame
+  double ref_y = 0.0;
+
+  std::vector<uint8_t> lane_ids;
+  std::vector<uint32_t> lane_offsets;  // Size is lane_ids.size() + 1
+
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> width;  // Lane width at each point in meters
+
+  /**
+   * @brief Returns the number of lanes in this intersection
+   */
+  size_t laneCount() const
+  {
+    return lane_ids.size();
+  }
+
+  /**
+   * @brief Returns the index of the lane with the given lane id or -1 if the intersection does not contain it
+   */
+  int findLane(uint8_t lane_id) const;
+};
+
+/**
+ * @class IntersectionGeometryStore
+ * @brief Store of absolute lane centerlines for every intersection received in a MAP message
+ *
+ * MAP lanes are described by node offsets relative to the previous node with the first node relative to the
+ * intersection reference point. The store accumulates these offsets and the node width deltas once per intersection
+ * revision so consumers can use the lane polylines directly. Rebroadcasts of an unchanged revision cost one lookup.
+ *
+ * All positions share one LocalFrame whose origin is the reference point of the first intersection received, unless
+ * set explicitly. The frame may be shared with a GeofenceCompiler so geofence polygons line up with the lanes.
+ *
+ * Lanes described as a computed lane are stored without points.
+ *
+ * The store is thread safe. Geometries are immutable once published, so readers may keep the returned pointers while
+ * the store is updated.
+ */
+class IntersectionGeometryStore
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param frame The frame of the stored positions
+   */
+  explicit IntersectionGeometryStore(std::shared_ptr<LocalFrame> frame = std::make_shared<LocalFrame>());
+
+  /**
+   * @brief Set the latitude and longitude in degrees of the origin of the store frame
+   *
+   * Has no effect once the frame origin is set, so it must be called before the first update
+   */
+  void setOrigin(double latitude, double longitude);
+
+  /**
+   * @brief Compute the absolute geometry of every intersection in the provided MAP whose revision is not yet known
+   *
+   * @param map The converted MAP message
+   *
+   * @return True if any intersection geometry was added or replaced
+   */
+  bool update(const cav_msgs::MapData& map);
+
+  /**
+   * @brief Returns the geometry of an intersection or nullptr if it has not been received
+   */
+  std::shared_ptr<const IntersectionGeometry> getIntersection(uint16_t intersection_id) const;
+
+  /**
+   * @brief Returns the geometry of every stored intersection
+   */
+  std::vector<std::shared_ptr<const IntersectionGeometry>> getIntersections() const;
+
+  /**
+   * @brief Returns a counter which is incremented every time the stored geometry changes
+   */
+  uint64_t version() const;
+
+  /**
+   * @brief Returns the latitude and longitude in degrees of the origin of the store frame
+   *
+   * @return False if the store origin is not set yet
+   */
+  bool getOrigin(double& latitude, double& longitude) const;
+
+  /**
+   * @brief Convert a latitude and longitude in degrees into the store frame
+   *
+   * @return False if the store origin is not set yet
+   */
+  bool toLocal(double latitude, double longitude, double& x, double& y) const;
+
+private:
+  /**
+   * @brief Build the absolute geometry of a single intersection
+   */
+  std::shared_ptr<IntersectionGeometry> build(const cav_msgs::IntersectionGeometry& in_msg) const;
+
+  std::shared_ptr<LocalFrame> frame_;
+
+  uint64_t version_ = 0;
+  std::unordered_map<uint16_t, std::shared_ptr<const IntersectionGeometry>> intersections_;
+  mutable std::mutex mutex_;
+};
+}  // namespace j2735_convertor
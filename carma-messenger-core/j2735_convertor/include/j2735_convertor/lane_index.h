@@ -0,0 +1,90 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "intersection_geometry_store.h"
+#include "packed_rtree.h"
+
+namespace j2735_convertor
+{
+/**
+ * @brief Result of matching a position to a MAP lane
+ */
+struct LaneMatch
+{
+  uint16_t intersection_id = 0;
+  uint8_t lane_id = 0;
+  double downtrack = 0.0;   // Distance along the lane centerline from its first node in meters
+  double crosstrack = 0.0;  // Signed distance from the lane centerline in meters, positive to the left
+};
+
+/**
+ * @class LaneIndex
+ * @brief Immutable R-tree over the lane segments of a set of intersection geometries
+ *
+ * Each segment is indexed by its bounding box grown by half the lane width, so a position query visits O(log n) nodes
+ * plus the segments whose lanes could contain the position.
+ *
+ * The index is built once per set of geometries. Build a new index when IntersectionGeometryStore::version changes.
+ */
+class LaneIndex
+{
+public:
+  /**
+   * @brief Build the index over every lane of the provided intersections
+   *
+   * @param intersections Geometries which are kept alive by the index
+   */
+  explicit LaneIndex(const std::vector<std::shared_ptr<const IntersectionGeometry>>& intersections);
+
+  /**
+   * @brief Find the lane containing a position
+   *
+   * When lanes overlap the lane whose centerline is closest to the position is returned.
+   *
+   * @param x Position in the frame of the IntersectionGeometryStore which produced the geometries
+   * @param y Position in the frame of the IntersectionGeometryStore which produced the geometries
+   * @param match The matched lane if any
+   *
+   * @return True if the position is within the width of a lane
+   */
+  bool match(double x, double y, LaneMatch& match) const;
+
+  /**
+   * @brief Returns the number of indexed lane segments
+   */
+  size_t segmentCount() const
+  {
+    return segments_.size();
+  }
+
+private:
+  struct Segment
+  {
+    uint32_t intersection;  // Index into intersections_
+    uint32_t lane;          // Lane index in the intersection
+    uint32_t point;         // Index of the first point of the segment in the intersection arrays
+    double downtrack;       // Length of the lane centerline before this segment
+  };
+
+  std::vector<std::shared_ptr<const IntersectionGeometry>> intersections_;
+  std::vector<Segment> segments_;
+  PackedRTree tree_;
+};
+}  // namespace j2735_convertor
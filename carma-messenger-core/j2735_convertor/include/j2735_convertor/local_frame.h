@@ -0,0 +1,65 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <mutex>
+
+namespace j2735_convertor
+{
+/**
+ * @class LocalFrame
+ * @brief Local east/north frame in meters shared by the IntersectionGeometryStore and the GeofenceCompiler
+ *
+ * Latitudes and longitudes are placed in the frame with an equirectangular projection around its origin, which is
+ * accurate to well under a meter within radio range of the origin.
+ *
+ * The origin is set once, either explicitly or by the first reference point its users place into the frame. Later
+ * calls to setOrigin have no effect, so every user of a frame agrees on its origin.
+ *
+ * The frame is thread safe.
+ */
+class LocalFrame
+{
+public:
+  /**
+   * @brief Set the latitude and longitude in degrees of the frame origin unless it is already set
+   *
+   * @return True if the origin was set by this call
+   */
+  bool setOrigin(double latitude, double longitude);
+
+  /**
+   * @brief Returns the latitude and longitude in degrees of the frame origin
+   *
+   * @return False if the origin is not set yet
+   */
+  bool getOrigin(double& latitude, double& longitude) const;
+
+  /**
+   * @brief Convert a latitude and longitude in degrees into the frame
+   *
+   * @return False if the origin is not set yet
+   */
+  bool toLocal(double latitude, double longitude, double& x, double& y) const;
+
+private:
+  bool origin_set_ = false;
+  double origin_latitude_ = 0.0;
+  double origin_longitude_ = 0.0;
+  double meters_per_deg_lon_ = 0.0;
+  mutable std::mutex mutex_;
+};
+}  // namespace j2735_convertor
@@ -43,7 +43,8 @@ public:
    * @brief Convert the contents of a j2735_msgs::MapData into a cav_msgs::MapData
    *
    * @param in_msg The message to be converted
-   * @param out_msg The message to store the output
+   * @param out_msg The message to store the output. May be a message from a previous conversion, in which case every
+   *                field is overwritten and the already allocated nested lists are reused.
    *
    * Unit conversions are handled
    */
@@ -0,0 +1,38 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstddef>
+#include <ros/callback_queue.h>
+
+namespace j2735_convertor
+{
+/**
+ * @brief Callback queue which reports how many callbacks wait in it
+ */
+class MeasuredCallbackQueue : public ros::CallbackQueue
+{
+public:
+  /**
+   * @brief Number of callbacks waiting to be called, not counting the one being called
+   */
+  size_t depth()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return callbacks_.size();
+  }
+};
+}  // namespace j2735_convertor
@@ -0,0 +1,157 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace j2735_convertor
+{
+/**
+ * @class PackedRTree
+ * @brief Immutable R-tree over a set of axis aligned boxes
+ *
+ * The tree is bulk loaded with Sort-Tile-Recursive packing so every node except the last of each level is full and
+ * the children of a node are contiguous. A query visits O(log n) nodes plus the items whose boxes intersect it.
+ *
+ * The tree does not support updates. Build a new tree when the indexed items change.
+ */
+class PackedRTree
+{
+public:
+  struct Box
+  {
+    double min_x, min_y, max_x, max_y;
+
+    bool intersects(const Box& other) const
+    {
+      return min_x <= other.max_x && other.min_x <= max_x && min_y <= other.max_y && other.min_y <= max_y;
+    }
+  };
+
+  /**
+   * @brief Constructs an empty tree
+   */
+  PackedRTree() = default;
+
+  /**
+   * @brief Build the tree
+   *
+   * @param boxes The box of every item. Queries report items by their index in this list
+   */
+  explicit PackedRTree(const std::vector<Box>& boxes);
+
+  /**
+   * @brief Call visit(index) for every item whose box intersects the provided box
+   */
+  template <typename Visitor>
+  void query(const Box& box, Visitor visit) const;
+
+  /**
+   * @brief Returns the number of indexed items
+   */
+  size_t size() const
+  {
+    return items_.size();
+  }
+
+private:
+  static constexpr size_t NODE_CAPACITY = 16;
+  static constexpr size_t MAX_QUERY_STACK = 256;  // Enough for a tree of depth 16 without spilling to the heap
+
+  struct Item
+  {
+    Box box;
+    uint32_t index;
+  };
+
+  struct Node
+  {
+    Box box;
+    uint32_t first;  // First child. Children of leaves are items, children of other nodes are nodes
+    uint32_t count;
+  };
+
+  /**
+   * @brief Create the parents of items_ or nodes_ in [begin, end) and append them to nodes_
+   */
+  template <typename T>
+  void pack(std::vector<T>& children, size_t begin, size_t end);
+
+  std::vector<Item> items_;  // In leaf order
+  std::vector<Node> nodes_;  // Leaves first, root last
+  size_t leaf_count_ = 0;
+};
+
+template <typename Visitor>
+void PackedRTree::query(const Box& box, Visitor visit) const
+{
+  if (nodes_.empty() || !nodes_.back().box.intersects(box))
+  {
+    return;
+  }
+
+  // Nodes go to the fixed stack and only spill into overflow once it is full, which keeps the usual query free of
+  // allocations without dropping nodes of unexpectedly deep trees
+  uint32_t stack[MAX_QUERY_STACK];
+  std::vector<uint32_t> overflow;
+  size_t top = 0;
+  stack[top++] = nodes_.size() - 1;
+
+  while (top > 0)
+  {
+    uint32_t index;
+    if (overflow.empty())
+    {
+      index = stack[--top];
+    }
+    else
+    {
+      index = overflow.back();
+      overflow.pop_back();
+    }
+    const Node& node = nodes_[index];
+    if (index >= leaf_count_)
+    {
+      for (uint32_t child = node.first; child < node.first + node.count; child++)
+      {
+        if (!nodes_[child].box.intersects(box))
+        {
+          continue;
+        }
+        if (top < MAX_QUERY_STACK)
+        {
+          stack[top++] = child;
+        }
+        else
+        {
+          overflow.push_back(child);
+        }
+      }
+      continue;
+    }
+
+    for (uint32_t i = node.first; i < node.first + node.count; i++)
+    {
+      if (items_[i].box.intersects(box))
+      {
+        visit(items_[i].index);
+      }
+    }
+  }
+}
+}  // namespace j2735_convertor
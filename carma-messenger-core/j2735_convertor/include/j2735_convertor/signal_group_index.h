@@ -0,0 +1,132 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cav_msgs/MapData.h>
+#include <cav_msgs/SPAT.h>
+
+namespace j2735_convertor
+{
+/**
+ * @brief A signalized connection from an ingress lane of an intersection
+ */
+struct LaneConnection
+{
+  uint8_t lane_id = 0;             // Ingress lane
+  uint8_t connecting_lane_id = 0;  // Lane reached through the connection
+  uint16_t maneuvers = 0;          // AllowedManeuvers bits of the connection, 0 if not provided
+  uint8_t signal_group = 0;
+};
+
+/**
+ * @class SignalGroupIndex
+ * @brief Joins SPAT movement states onto MAP lanes
+ *
+ * The connections of each MAP lane which carry a signal group are indexed by intersection and lane id when a new
+ * intersection revision is received. The latest movement state of every signal group is indexed by intersection id
+ * and signal group when a SPAT is received. The signal state of a lane is then found with two lookups instead of a
+ * scan of the connect_to_list followed by a scan of the movement_list.
+ *
+ * MAP and SPAT updates may arrive on different threads. All methods are thread safe.
+ */
+class SignalGroupIndex
+{
+public:
+  /**
+   * @brief Index the connections of every intersection in the MAP whose revision is not yet known
+   *
+   * @return True if any intersection was added or replaced
+   */
+  bool updateMap(const cav_msgs::MapData& map);
+
+  /**
+   * @brief Replace the movement states of every intersection in the SPAT
+   */
+  void updateSpat(const cav_msgs::SPAT& spat);
+
+  /**
+   * @brief Find the signal group controlling a maneuver from a lane
+   *
+   * @param maneuver AllowedManeuvers bits which the connection must allow. 0 matches the first signalized connection
+   *
+   * @return False if the lane has no matching signalized connection
+   */
+  bool getSignalGroup(uint16_t intersection_id, uint8_t lane_id, uint16_t maneuver, uint8_t& signal_group) const;
+
+  /**
+   * @brief Get the latest movement state of a signal group
+   *
+   * @return False if no SPAT containing the signal group was received
+   */
+  bool getMovementState(uint16_t intersection_id, uint8_t signal_group, cav_msgs::MovementState& state) const;
+
+  /**
+   * @brief Get the latest movement state controlling a maneuver from a lane
+   *
+   * @return False if the lane has no matching signalized connection or its signal group has no movement state yet
+   */
+  bool getLaneMovementState(uint16_t intersection_id, uint8_t lane_id, uint16_t maneuver,
+                            cav_msgs::MovementState& state) const;
+
+  /**
+   * @brief Returns every signalized connection of an intersection in MAP lane order
+   */
+  std::vector<LaneConnection> getConnections(uint16_t intersection_id) const;
+
+private:
+  struct IntersectionConnections
+  {
+    uint8_t revision = 0;
+    std::vector<LaneConnection> connections;  // Connections of each lane are contiguous
+  };
+
+  struct IntersectionSignals
+  {
+    IntersectionSignals()
+    {
+      slots.fill(-1);
+    }
+
+    std::array<int16_t, 256> slots;                 // Index into movements per signal group, -1 if not received
+    std::vector<cav_msgs::MovementState> movements;  // Latest movement states in SPAT order
+  };
+
+  /**
+   * @brief Returns the first connection of a lane which allows the maneuver or nullptr. The caller must hold mutex_
+   */
+  const LaneConnection* findConnection(uint16_t intersection_id, uint8_t lane_id, uint16_t maneuver) const;
+
+  /**
+   * @brief Returns the movement state of a signal group or nullptr. The caller must hold mutex_
+   */
+  const cav_msgs::MovementState* findMovement(uint16_t intersection_id, uint8_t signal_group) const;
+
+  static uint32_t laneKey(uint16_t intersection_id, uint8_t lane_id)
+  {
+    return (static_cast<uint32_t>(intersection_id) << 8) | lane_id;
+  }
+
+  std::unordered_map<uint16_t, IntersectionConnections> intersections_;
+  std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> lanes_;  // Range of a lane in its connections
+  std::unordered_map<uint16_t, IntersectionSignals> signals_;
+  mutable std::mutex mutex_;
+};
+}  // namespace j2735_convertor
@@ -42,53 +42,66 @@ public:
    * @brief Convert the contents of a j2735_msgs::MapData into a cav_msgs::MapData
    *
    * @param in_msg The message to be converted
-   * @param out_msg The message to store the output
+   * @param out_msg The message to store the output. May be a message from a previous conversion, in which case every
+   *                field is overwritten and the already allocated nested lists are reused.
    *
    * Unit conversions are handled
    */
   static void convert(const j2735_msgs::SPAT& in_msg, cav_msgs::SPAT& out_msg);
 
-private:
   /**
-   * @brief Convert the contents of a j2735_msgs::TimeChangeDetails into a cav_msgs::TimeChangeDetails
+   * @brief Convert the contents of a j2735_msgs::MovementState into a cav_msgs::MovementState
    *
    * @param in_msg The message to be converted
    * @param out_msg The message to store the output
    *
    * Unit conversions are handled
    */
-  static void convertTimeChangeDetails(const j2735_msgs::TimeChangeDetails& in_msg,
-                                       cav_msgs::TimeChangeDetails& out_msg);
+  static void convertMovementState(const j2735_msgs::MovementState& in_msg, cav_msgs::MovementState& out_msg);
 
   /**
-   * @brief Convert the contents of a j2735_msgs::AdvisorySpeed into a cav_msgs::AdvisorySpeed
+   * @brief Convert every field of a j2735_msgs::IntersectionState except its movement list into a
+   * cav_msgs::IntersectionState. The movement_list of the output is left untouched.
    *
    * @param in_msg The message to be converted
    * @param out_msg The message to store the output
    *
    * Unit conversions are handled
    */
-  static void convertAdvisorySpeed(const j2735_msgs::AdvisorySpeed& in_msg, cav_msgs::AdvisorySpeed& out_msg);
+  static void convertIntersectionStateHeader(const j2735_msgs::IntersectionState& in_msg,
+                                             cav_msgs::IntersectionState& out_msg);
 
+private:
   /**
-   * @brief Convert the contents of a j2735_msgs::MovementEvent into a cav_msgs::MovementEvent
+   * @brief Convert the contents of a j2735_msgs::TimeChangeDetails into a cav_msgs::TimeChangeDetails
    *
    * @param in_msg The message to be converted
    * @param out_msg The message to store the output
    *
    * Unit conversions are handled
    */
-  static void convertMovementEvent(const j2735_msgs::MovementEvent& in_msg, cav_msgs::MovementEvent& out_msg);
+  static void convertTimeChangeDetails(const j2735_msgs::TimeChangeDetails& in_msg,
+                                       cav_msgs::TimeChangeDetails& out_msg);
 
   /**
-   * @brief Convert the contents of a j2735_msgs::MovementState into a cav_msgs::MovementState
+   * @brief Convert the contents of a j2735_msgs::AdvisorySpeed into a cav_msgs::AdvisorySpeed
    *
    * @param in_msg The message to be converted
    * @param out_msg The message to store the output
    *
    * Unit conversions are handled
    */
-  static void convertMovementState(const j2735_msgs::MovementState& in_msg, cav_msgs::MovementState& out_msg);
+  static void convertAdvisorySpeed(const j2735_msgs::AdvisorySpeed& in_msg, cav_msgs::AdvisorySpeed& out_msg);
+
+  /**
+   * @brief Convert the contents of a j2735_msgs::MovementEvent into a cav_msgs::MovementEvent
+   *
+   * @param in_msg The message to be converted
+   * @param out_msg The message to store the output
+   *
+   * Unit conversions are handled
+   */
+  static void convertMovementEvent(const j2735_msgs::MovementEvent& in_msg, cav_msgs::MovementEvent& out_msg);
 
   /**
    * @brief Convert the contents of a j2735_msgs::IntersectionState into a cav_msgs::IntersectionState
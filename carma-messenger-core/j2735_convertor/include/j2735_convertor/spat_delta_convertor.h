@@ -0,0 +1,126 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <ros/time.h>
+#include <j2735_msgs/SPAT.h>
+#include <cav_msgs/SPAT.h>
+#include "spat_convertor.h"
+
+namespace j2735_convertor
+{
+/**
+ * @class SPATDeltaConvertor
+ * @brief Stateful SPAT conversion which only reconverts the movement states that changed since the last SPAT
+ *
+ * The last received j2735_msgs::MovementState of every signal group is kept per intersection id together with its
+ * converted cav_msgs::MovementState. Incoming movement states are compared against the cache in their serialized form
+ * and only converted again if they differ.
+ *
+ * The status, enabled lanes and maneuver assist list of an intersection are compared the same way.
+ *
+ * In addition to the full cav_msgs::SPAT a delta cav_msgs::SPAT is produced. It contains only the intersections which
+ * changed and for each of those only the movement states which changed, so an intersection whose header changed alone
+ * is sent without movement states. Every keyframe_interval SPATs of an
+ * intersection, when its revision changes or when its set of signal groups changes, the delta carries all movement
+ * states of that intersection instead. Delta subscribers should therefore update their state by signal group and drop
+ * everything they know about an intersection when its revision changes.
+ *
+ * Intersections not received for MAX_AGE_SEC are dropped from the cache, their next SPAT is a keyframe. The age is
+ * kept per intersection, so it does not depend on how many other intersections are in range.
+ */
+class SPATDeltaConvertor
+{
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param keyframe_interval Number of SPATs of an intersection after which its full state is sent on the delta
+   */
+  explicit SPATDeltaConvertor(uint32_t keyframe_interval);
+
+  /**
+   * @brief Convert a j2735_msgs::SPAT into its full and delta cav_msgs::SPAT representations
+   *
+   * @param in_msg The message to be converted
+   * @param now Receive time of the message, used to drop intersections which are no longer broadcast
+   * @param full_msg The message to store the complete output. Nested lists are reused as in SPATConvertor::convert
+   * @param delta_msg The message to store the intersections and movement states which changed
+   *
+   * Unit conversions are handled
+   *
+   * @return True if delta_msg contains at least one intersection and should be published
+   */
+  bool convert(const j2735_msgs::SPAT& in_msg, const ros::Time& now, cav_msgs::SPAT& full_msg,
+               cav_msgs::SPAT& delta_msg);
+
+  /**
+   * @brief Number of intersections in the cache
+   */
+  size_t intersectionCount() const;
+
+  // Seconds without a SPAT of an intersection after which it is dropped
+  static constexpr double MAX_AGE_SEC = 10.0;
+
+private:
+  struct MovementCache
+  {
+    std::vector<uint8_t> serialized;    // Serialized form of the last j2735 movement state
+    cav_msgs::MovementState converted;  // Conversion of the last j2735 movement state
+    uint64_t last_seen = 0;             // Value of IntersectionCache::received when this signal group was last seen
+  };
+
+  struct IntersectionCache
+  {
+    int32_t revision = -1;  // -1 marks an intersection which has not been received yet
+    uint32_t since_keyframe = 0;
+    uint64_t received = 0;
+    ros::Time last_seen;          // Receive time of the last SPAT of this intersection
+    std::vector<uint8_t> header;  // Serialized status, enabled lanes and maneuver assist of the last SPAT
+    std::unordered_map<uint8_t, MovementCache> movements;  // Keyed by signal group
+  };
+
+  /**
+   * @brief Update the cache entry of a movement state, reconverting it only if its content changed
+   *
+   * @return True if the movement state is new or changed
+   */
+  bool updateMovement(const j2735_msgs::MovementState& in_msg, MovementCache& cache);
+
+  /**
+   * @brief Update the serialized header of an intersection from its converted header
+   *
+   * @return True if the header is new or changed. Time stamps are not compared
+   */
+  bool updateHeader(const cav_msgs::IntersectionState& header, IntersectionCache& cache);
+
+  /**
+   * @brief Replace a serialized cache entry by the scratch buffer if they differ
+   *
+   * @return True if they differed
+   */
+  bool swapIfChanged(std::vector<uint8_t>& serialized);
+
+  uint32_t keyframe_interval_;
+  std::unordered_map<uint16_t, IntersectionCache> intersections_;  // Keyed by intersection id
+  ros::Time next_sweep_;                                           // Time to look for dropped intersections again
+  std::vector<uint8_t> scratch_;                                   // Serialization buffer reused between calls
+  std::vector<const MovementCache*> changed_;                      // Changed movements of the current intersection
+};
+}  // namespace j2735_convertor
@@ -0,0 +1,118 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace j2735_convertor
+{
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timer wheel over integer ticks
+ *
+ * Each of the LEVELS wheels has SLOTS slots. A timer is placed on the lowest level whose span covers its remaining
+ * ticks and moves down one level each time the slot it is in comes around. Adding a timer and firing it are O(1)
+ * and each timer is moved at most LEVELS - 1 times. Timers beyond the span of the top level wait in an overflow list
+ * which is redistributed every time the top level wraps.
+ *
+ * An advance by more than one revolution of the lowest level, e.g. from a wheel created before the first sim time,
+ * redistributes all timers in O(size) instead of stepping through every tick.
+ *
+ * Timers cannot be cancelled. Owners should tag timer ids so they can ignore timers that are no longer wanted.
+ */
+class TimerWheel
+{
+public:
+  static constexpr uint32_t SLOT_BITS = 6;
+  static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+  static constexpr uint32_t LEVELS = 4;
+
+  /**
+   * @brief Constructor
+   *
+   * @param now The current tick
+   */
+  explicit TimerWheel(uint64_t now);
+
+  /**
+   * @brief Add a timer
+   *
+   * @param timer_id Id reported when the timer fires
+   * @param expiry Tick at which the timer fires. Timers at or before the current tick fire on the next advance
+   */
+  void add(uint64_t timer_id, uint64_t expiry);
+
+  /**
+   * @brief Move the wheel forward and collect the timers which fired
+   *
+   * @param now The new current tick. Ticks before the current tick are ignored
+   * @param expired Ids of the fired timers are appended to this list
+   */
+  void advance(uint64_t now, std::vector<uint64_t>& expired);
+
+  /**
+   * @brief Returns the current tick
+   */
+  uint64_t now() const
+  {
+    return now_;
+  }
+
+  /**
+   * @brief Returns the number of pending timers
+   */
+  size_t size() const
+  {
+    return size_;
+  }
+
+private:
+  struct Timer
+  {
+    uint64_t id;
+    uint64_t expiry;
+  };
+
+  /**
+   * @brief Place a timer on the level matching its remaining ticks
+   */
+  void insert(const Timer& timer);
+
+  /**
+   * @brief Move the timers of the current slot of a level down to the lower levels
+   */
+  void cascade(uint32_t level);
+
+  /**
+   * @brief Move straight to now, firing the timers up to it in order of expiry and placing the others anew
+   */
+  void jump(uint64_t now, std::vector<uint64_t>& expired);
+
+  /**
+   * @brief Report and remove the timers in due_
+   */
+  void fireDue(std::vector<uint64_t>& expired);
+
+  std::vector<Timer> slots_[LEVELS][SLOTS];
+  std::vector<Timer> overflow_;  // Timers beyond the span of the top level
+  std::vector<Timer> due_;       // Timers added at or before the current tick
+  std::vector<Timer> scratch_;   // Slot contents being cascaded
+  uint64_t now_;
+  size_t size_ = 0;
+};
+}  // namespace j2735_convertor
@@ -0,0 +1,185 @@
+#pragma once
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ros/time.h>
+#include <cav_msgs/BSM.h>
+
+namespace j2735_convertor
+{
+/**
+ * @brief Latest state of a remote vehicle
+ */
+struct TrackedVehicle
+{
+  uint32_t id = 0;         // BSM temporary id, first byte most significant
+  cav_msgs::BSM bsm;       // Latest accepted BSM
+  std::string static_id;   // Static id from the mobility messages of the vehicle, empty until correlated
+  ros::Time stamp;         // Receipt time of the latest accepted BSM
+  uint32_t bsm_count = 0;  // Accepted BSMs
+  bool used = false;
+};
+
+/**
+ * @class VehicleTracker
+ * @brief Fixed capacity table of the remote vehicles heard from, keyed by BSM temporary id
+ *
+ * Vehicles are kept in an open addressing table with linear probing which is allocated once, at twice the capacity
+ * so probe sequences stay short. Removed vehicles are backward shifted out of the probe sequence so no tombstones are
+ * left behind. New vehicles are dropped while the table is full.
+ *
+ * A BSM is a duplicate if its msgCnt, which counts modulo 128, equals or is up to REORDER_WINDOW behind the one of
+ * the last accepted BSM of the vehicle. Vehicles are expired once their last BSM is older than the maximum age.
+ *
+ * Mobility messages carry the BSM id of their sender as 8 hex digits, which correlates the static id of a vehicle to
+ * its tracked BSMs.
+ */
+class VehicleTracker
+{
+public:
+  static constexpr uint8_t MSG_COUNT_MODULO = 128;
+  static constexpr uint8_t REORDER_WINDOW = 16;
+
+  enum class Update
+  {
+    ACCEPTED,
+    DUPLICATE,  // Same or older msgCnt than the last accepted BSM
+    FULL,       // New vehicle while the table is full
+    INVALID     // BSM without a 4 byte id
+  };
+
+  /**
+   * @brief Constructor
+   *
+   * @param capacity Maximum number of tracked vehicles
+   * @param max_age Vehicles without a BSM for longer than this are expired
+   */
+  VehicleTracker(size_t capacity, const ros::Duration& max_age);
+
+  /**
+   * @brief Track a received BSM
+   *
+   * @param bsm The converted BSM
+   * @param now Receipt time of the BSM
+   *
+   * @return ACCEPTED if the BSM replaced the state of its vehicle
+   */
+  Update update(const cav_msgs::BSM& bsm, const ros::Time& now);
+
+  /**
+   * @brief Attach the static id of a mobility message to the vehicle sending BSMs with sender_bsm_id
+   *
+   * @return True if the vehicle is tracked
+   */
+  bool correlate(const std::string& sender_bsm_id, const std::string& static_id);
+
+  /**
+   * @brief Remove the vehicles whose last BSM is older than the maximum age
+   *
+   * @return The number of removed vehicles
+   */
+  size_t expire(const ros::Time& now);
+
+  /**
+   * @brief Returns the tracked vehicle with a BSM id or nullptr
+   */
+  const TrackedVehicle* find(uint32_t id) const;
+
+  /**
+   * @brief Call f with every tracked vehicle, in no particular order
+   */
+  template <class F>
+  void forEach(F f) const
+  {
+    for (const TrackedVehicle& slot : slots_)
+    {
+      if (slot.used)
+      {
+        f(slot);
+      }
+    }
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  size_t capacity() const
+  {
+    return capacity_;
+  }
+
+  /**
+   * @brief Returns the number of BSMs rejected as duplicates since construction
+   */
+  uint64_t duplicates() const
+  {
+    return duplicates_;
+  }
+
+  /**
+   * @brief Returns the number of BSMs dropped because the table was full since construction
+   */
+  uint64_t dropped() const
+  {
+    return dropped_;
+  }
+
+  /**
+   * @brief Read the id of a BSM
+   *
+   * @return False if the id is not 4 bytes long
+   */
+  static bool bsmId(const cav_msgs::BSM& bsm, uint32_t& id);
+
+  /**
+   * @brief Parse the 8 hex digit sender_bsm_id of a mobility header
+   *
+   * @return False if the string is not 8 hex digits
+   */
+  static bool parseBsmId(const std::string& sender_bsm_id, uint32_t& id);
+
+private:
+  /**
+   * @brief Returns the home slot of an id
+   */
+  size_t home(uint32_t id) const;
+
+  /**
+   * @brief Returns the slot of an id, or the free slot ending its probe sequence
+   */
+  size_t probe(uint32_t id) const;
+
+  /**
+   * @brief Remove the vehicle in a slot and shift the following vehicles of its probe sequence back
+   */
+  void erase(size_t slot);
+
+  std::vector<TrackedVehicle> slots_;
+  size_t mask_;
+  uint32_t shift_;
+  size_t capacity_;
+  size_t size_ = 0;
+  ros::Duration max_age_;
+  uint64_t duplicates_ = 0;
+  uint64_t dropped_ = 0;
+};
+}  // namespace j2735_convertor
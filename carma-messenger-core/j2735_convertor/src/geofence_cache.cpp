@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <ros/console.h>
+#include <ros/serialization.h>
+#include <j2735_convertor/geofence_cache.h>
+
+/**
+ * CPP File containing GeofenceCache method definitions
+ */
+
+namespace j2735_convertor
+{
+constexpr uint32_t GeofenceCache::MAGIC;
+constexpr uint32_t GeofenceCache::FORMAT_VERSION;
+constexpr uint32_t GeofenceCache::COVERAGE_MAGIC;
+
+namespace
+{
+constexpr size_t FILE_HEADER_SIZE = 8;     // Magic and format version
+constexpr size_t RECORD_HEADER_SIZE = 8;   // Payload length and checksum
+constexpr size_t MIN_COMPACTION_RECORDS = 64;
+constexpr size_t COVERAGE_HEADER_SIZE = 16;  // Magic, format version, area count and checksum
+constexpr size_t AREA_SIZE = 48;             // Extent and the seconds and nanoseconds of both times
+
+uint32_t fnv1a(const uint8_t* data, size_t size)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++)
+  {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// Header fields are stored in host byte order. The cache is only read back by the machine which wrote it.
+uint32_t readU32(const uint8_t* data)
+{
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+void writeU32(uint8_t* data, uint32_t value)
+{
+  memcpy(data, &value, sizeof(value));
+}
+
+double readDouble(const uint8_t* data)
+{
+  double value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+void writeDouble(uint8_t* data, double value)
+{
+  memcpy(data, &value, sizeof(value));
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t written = write(fd, data, size);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+}  // namespace
+
+GeofenceCache::GeofenceCache(const std::string& path) : path_(path)
+{
+}
+
+size_t GeofenceCache::load(GeofenceStore& store, const ros::Time& now)
+{
+  size_t loaded = 0;
+  restored_ = false;
+  int fd = open(path_.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if (fd >= 0 && fstat(fd, &file_stat) == 0 && static_cast<size_t>(file_stat.st_size) >= FILE_HEADER_SIZE)
+  {
+    size_t size = file_stat.st_size;
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      ROS_WARN_STREAM("Failed to map geofence cache " << path_ << ": " << strerror(errno));
+    }
+    else
+    {
+      const uint8_t* data = static_cast<const uint8_t*>(mapping);
+      if (readU32(data) != MAGIC || readU32(data + 4) != FORMAT_VERSION)
+      {
+        ROS_WARN_STREAM("Ignoring geofence cache " << path_ << " with unknown format");
+      }
+      else
+      {
+        size_t offset = FILE_HEADER_SIZE;
+        while (offset + RECORD_HEADER_SIZE <= size)
+        {
+          uint32_t length = readU32(data + offset);
+          uint32_t checksum = readU32(data + offset + 4);
+          const uint8_t* payload = data + offset + RECORD_HEADER_SIZE;
+          if (length > size - offset - RECORD_HEADER_SIZE || fnv1a(payload, length) != checksum)
+          {
+            ROS_WARN_STREAM("Geofence cache " << path_ << " is truncated at byte " << offset);
+            break;
+          }
+
+          cav_msgs::TrafficControlMessageV01 geofence;
+          try
+          {
+            // The stream only reads from the mapping
+            ros::serialization::IStream stream(const_cast<uint8_t*>(payload), length);
+            ros::serialization::deserialize(stream, geofence);
+          }
+          catch (const ros::serialization::StreamOverrunException& e)
+          {
+            ROS_WARN_STREAM("Geofence cache " << path_ << " has an invalid record at byte " << offset);
+            break;
+          }
+          store.add(geofence);
+          loaded++;
+          offset += RECORD_HEADER_SIZE + length;
+        }
+        restored_ = offset == size;
+      }
+      munmap(mapping, size);
+    }
+  }
+  if (fd >= 0)
+  {
+    close(fd);
+  }
+
+  size_t expired = store.removeExpired(now).size();
+  ROS_INFO_STREAM("Loaded " << loaded << " records from geofence cache " << path_ << ", " << expired
+                            << " geofences expired, " << store.size() << " geofences restored");
+
+  // Start from a file holding only the live geofences. This also creates the file on first use.
+  compact(store.getGeofences());
+  return store.size();
+}
+
+void GeofenceCache::serializeRecord(const cav_msgs::TrafficControlMessageV01& geofence)
+{
+  uint32_t length = ros::serialization::serializationLength(geofence);
+  buffer_.resize(RECORD_HEADER_SIZE + length);
+  ros::serialization::OStream stream(buffer_.data() + RECORD_HEADER_SIZE, length);
+  ros::serialization::serialize(stream, geofence);
+  writeU32(buffer_.data(), length);
+  writeU32(buffer_.data() + 4, fnv1a(buffer_.data() + RECORD_HEADER_SIZE, length));
+}
+
+bool GeofenceCache::append(const cav_msgs::TrafficControlMessageV01& geofence)
+{
+  int fd = open(path_.c_str(), O_WRONLY | O_APPEND);
+  if (fd < 0)
+  {
+    ROS_WARN_STREAM("Failed to open geofence cache " << path_ << ": " << strerror(errno));
+    return false;
+  }
+
+  serializeRecord(geofence);
+  bool success = writeAll(fd, buffer_.data(), buffer_.size());
+  close(fd);
+  if (!success)
+  {
+    ROS_WARN_STREAM("Failed to append to geofence cache " << path_);
+    return false;
+  }
+  record_count_++;
+  return true;
+}
+
+bool GeofenceCache::needsCompaction(size_t live_count) const
+{
+  return record_count_ >= MIN_COMPACTION_RECORDS && record_count_ > 2 * live_count;
+}
+
+bool GeofenceCache::writeFile(int fd, const std::vector<GeofenceStore::GeofencePtr>& geofences)
+{
+  uint8_t header[FILE_HEADER_SIZE];
+  writeU32(header, MAGIC);
+  writeU32(header + 4, FORMAT_VERSION);
+  if (!writeAll(fd, header, FILE_HEADER_SIZE))
+  {
+    return false;
+  }
+
+  for (const GeofenceStore::GeofencePtr& geofence : geofences)
+  {
+    serializeRecord(*geofence);
+    if (!writeAll(fd, buffer_.data(), buffer_.size()))
+    {
+      return false;
+    }
+  }
+  return fsync(fd) == 0;
+}
+
+bool GeofenceCache::compact(const std::vector<GeofenceStore::GeofencePtr>& geofences)
+{
+  std::string temp_path = path_ + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    ROS_WARN_STREAM("Failed to create geofence cache " << temp_path << ": " << strerror(errno));
+    return false;
+  }
+
+  bool success = writeFile(fd, geofences);
+  close(fd);
+  if (!success || rename(temp_path.c_str(), path_.c_str()) != 0)
+  {
+    ROS_WARN_STREAM("Failed to write geofence cache " << path_);
+    unlink(temp_path.c_str());
+    return false;
+  }
+  record_count_ = geofences.size();
+  return true;
+}
+
+std::vector<GeofenceCoverage::Area> GeofenceCache::loadCoverage() const
+{
+  std::vector<GeofenceCoverage::Area> areas;
+  std::string coverage_path = path_ + ".coverage";
+  int fd = open(coverage_path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return areas;
+  }
+  if (!restored_)
+  {
+    ROS_WARN_STREAM("Ignoring geofence coverage " << coverage_path << " of an incomplete geofence cache");
+    close(fd);
+    return areas;
+  }
+
+  std::vector<uint8_t> data;
+  uint8_t chunk[4096];
+  ssize_t count;
+  while ((count = read(fd, chunk, sizeof(chunk))) != 0)
+  {
+    if (count < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (count < 0)
+    {
+      data.clear();
+      break;
+    }
+    data.insert(data.end(), chunk, chunk + count);
+  }
+  close(fd);
+
+  if (data.size() < COVERAGE_HEADER_SIZE || readU32(data.data()) != COVERAGE_MAGIC ||
+      readU32(data.data() + 4) != FORMAT_VERSION ||
+      data.size() != COVERAGE_HEADER_SIZE + static_cast<size_t>(readU32(data.data() + 8)) * AREA_SIZE ||
+      fnv1a(data.data() + COVERAGE_HEADER_SIZE, data.size() - COVERAGE_HEADER_SIZE) != readU32(data.data() + 12))
+  {
+    ROS_WARN_STREAM("Ignoring invalid geofence coverage " << coverage_path);
+    return areas;
+  }
+
+  for (size_t offset = COVERAGE_HEADER_SIZE; offset < data.size(); offset += AREA_SIZE)
+  {
+    const uint8_t* record = data.data() + offset;
+    GeofenceCoverage::Area area;
+    area.extent = { readDouble(record), readDouble(record + 8), readDouble(record + 16), readDouble(record + 24) };
+    area.oldest = ros::Time(readU32(record + 32), readU32(record + 36));
+    area.complete = ros::Time(readU32(record + 40), readU32(record + 44));
+    areas.push_back(area);
+  }
+  return areas;
+}
+
+bool GeofenceCache::saveCoverage(const std::vector<GeofenceCoverage::Area>& areas)
+{
+  std::vector<uint8_t> data(COVERAGE_HEADER_SIZE + areas.size() * AREA_SIZE);
+  for (size_t i = 0; i < areas.size(); i++)
+  {
+    uint8_t* record = data.data() + COVERAGE_HEADER_SIZE + i * AREA_SIZE;
+    const GeofenceCoverage::Area& area = areas[i];
+    writeDouble(record, area.extent.min_x);
+    writeDouble(record + 8, area.extent.min_y);
+    writeDouble(record + 16, area.extent.max_x);
+    writeDouble(record + 24, area.extent.max_y);
+    writeU32(record + 32, area.oldest.sec);
+    writeU32(record + 36, area.oldest.nsec);
+    writeU32(record + 40, area.complete.sec);
+    writeU32(record + 44, area.complete.nsec);
+  }
+  writeU32(data.data(), COVERAGE_MAGIC);
+  writeU32(data.data() + 4, FORMAT_VERSION);
+  writeU32(data.data() + 8, areas.size());
+  writeU32(data.data() + 12, fnv1a(data.data() + COVERAGE_HEADER_SIZE, data.size() - COVERAGE_HEADER_SIZE));
+
+  // Replaced like the cache file, so a crash leaves either version intact
+  std::string coverage_path = path_ + ".coverage";
+  std::string temp_path = coverage_path + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    ROS_WARN_STREAM("Failed to create geofence coverage " << temp_path << ": " << strerror(errno));
+    return false;
+  }
+
+  bool success = writeAll(fd, data.data(), data.size()) && fsync(fd) == 0;
+  close(fd);
+  if (!success || rename(temp_path.c_str(), coverage_path.c_str()) != 0)
+  {
+    ROS_WARN_STREAM("Failed to write geofence coverage " << coverage_path);
+    unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace j2735_convertor
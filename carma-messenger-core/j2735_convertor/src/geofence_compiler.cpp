@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <ros/console.h>
+#include <j2735_convertor/geofence_compiler.h>
+
+/**
+ * CPP File containing GeofenceCompiler method definitions
+ */
+
+namespace j2735_convertor
+{
+namespace
+{
+constexpr double EARTH_RADIUS_M = 6378137.0;
+constexpr double DEG_TO_RAD = M_PI / 180.0;
+constexpr double METERS_PER_DEG_LAT = EARTH_RADIUS_M * DEG_TO_RAD;
+constexpr double DEFAULT_WIDTH_M = 3.66;  // Used until a node provides a width
+}  // namespace
+
+constexpr size_t GeofenceCompiler::MAX_PROJECTIONS;
+
+GeofenceCompiler::GeofenceCompiler(std::shared_ptr<LocalFrame> frame) : frame_(frame)
+{
+}
+
+void GeofenceCompiler::setOrigin(double latitude, double longitude)
+{
+  frame_->setOrigin(latitude, longitude);
+}
+
+std::string GeofenceCompiler::key(const j2735_msgs::Id128b& id)
+{
+  return std::string(id.id.begin(), id.id.end());
+}
+
+std::shared_ptr<const GeofenceProjection> GeofenceCompiler::projection(const std::string& proj)
+{
+  auto it = projections_.find(proj);
+  if (it != projections_.end())
+  {
+    return it->second;
+  }
+  std::shared_ptr<const GeofenceProjection> parsed = GeofenceProjection::parse(proj);
+  if (!parsed && !proj.empty())
+  {
+    ROS_WARN_STREAM("Unsupported geofence proj string " << proj << ", geofences using it are not compiled");
+  }
+  if (projections_.size() >= MAX_PROJECTIONS)
+  {
+    projections_.clear();  // Proj strings are parsed again on their next use
+  }
+  projections_.emplace(proj, parsed);
+  return parsed;
+}
+
+std::shared_ptr<const GeofencePolygon> GeofenceCompiler::compile(const cav_msgs::TrafficControlMessageV01& geofence)
+{
+  if (!geofence.geometry_exists)
+  {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string id = key(geofence.id);
+  auto it = polygons_.find(id);
+  if (it != polygons_.end() && it->second->updated == geofence.updated)
+  {
+    return it->second;
+  }
+
+  std::shared_ptr<const GeofencePolygon> polygon = build(geofence);
+  if (!polygon)
+  {
+    // The geometry cannot be placed, so an older version would be wrong as well
+    if (it != polygons_.end())
+    {
+      polygons_.erase(it);
+    }
+    return nullptr;
+  }
+  polygons_[id] = polygon;
+  return polygon;
+}
+
+std::shared_ptr<GeofencePolygon> GeofenceCompiler::build(const cav_msgs::TrafficControlMessageV01& geofence)
+{
+  const cav_msgs::TrafficControlGeometry& geometry = geofence.geometry;
+  std::shared_ptr<const GeofenceProjection> proj = projection(geometry.proj);
+  if (!proj && !geometry.proj.empty())
+  {
+    return nullptr;
+  }
+
+  frame_->setOrigin(geometry.reflat, geometry.reflon);  // Unless already set
+
+  std::shared_ptr<GeofencePolygon> out(new GeofencePolygon());
+  out->id = geofence.id;
+  out->updated = geofence.updated;
+  frame_->getOrigin(out->origin_latitude, out->origin_longitude);
+  size_t count = geometry.nodes.size();
+  out->x.reserve(count);
+  out->y.reserve(count);
+  out->width.reserve(count);
+
+  // Accumulate the offsets in the geofence frame and move each node into the compiler frame
+  double ref_x = 0.0;
+  double ref_y = 0.0;
+  double local_meters_per_deg_lon = METERS_PER_DEG_LAT * cos(geometry.reflat * DEG_TO_RAD);
+  if (proj)
+  {
+    proj->forward(geometry.reflat, geometry.reflon, ref_x, ref_y);
+  }
+
+  double node_x = ref_x;
+  double node_y = ref_y;
+  double width = DEFAULT_WIDTH_M;
+  for (const cav_msgs::PathNode& node : geometry.nodes)
+  {
+    node_x += node.x;
+    node_y += node.y;
+    if (node.width_exists)
+    {
+      width = fabs(node.width);
+    }
+
+    double latitude, longitude;
+    if (proj)
+    {
+      proj->inverse(node_x, node_y, latitude, longitude);
+    }
+    else
+    {
+      latitude = geometry.reflat + node_y / METERS_PER_DEG_LAT;
+      longitude = geometry.reflon + node_x / local_meters_per_deg_lon;
+    }
+    double x, y;
+    frame_->toLocal(latitude, longitude, x, y);
+    out->x.push_back(x);
+    out->y.push_back(y);
+    out->width.push_back(width);
+  }
+
+  // Offset each node along the normal of the direction between its neighbours
+  out->boundary_x.resize(2 * count);
+  out->boundary_y.resize(2 * count);
+  for (size_t i = 0; i < count; i++)
+  {
+    size_t prev = i > 0 ? i - 1 : i;
+    size_t next = i + 1 < count ? i + 1 : i;
+    double dx = out->x[next] - out->x[prev];
+    double dy = out->y[next] - out->y[prev];
+    double length = sqrt(dx * dx + dy * dy);
+    double half_width = out->width[i] / 2.0;
+    double normal_x = length > 0.0 ? -dy / length * half_width : 0.0;  // Points to the left
+    double normal_y = length > 0.0 ? dx / length * half_width : 0.0;
+
+    out->boundary_x[i] = out->x[i] + normal_x;
+    out->boundary_y[i] = out->y[i] + normal_y;
+    out->boundary_x[2 * count - 1 - i] = out->x[i] - normal_x;
+    out->boundary_y[2 * count - 1 - i] = out->y[i] - normal_y;
+  }
+  return out;
+}
+
+std::shared_ptr<const GeofencePolygon> GeofenceCompiler::lookup(const j2735_msgs::Id128b& id) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = polygons_.find(key(id));
+  return it == polygons_.end() ? nullptr : it->second;
+}
+
+void GeofenceCompiler::remove(const j2735_msgs::Id128b& id)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  polygons_.erase(key(id));
+}
+
+size_t GeofenceCompiler::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return polygons_.size();
+}
+
+size_t GeofenceCompiler::projectionCount() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return projections_.size();
+}
+
+}  // namespace j2735_convertor
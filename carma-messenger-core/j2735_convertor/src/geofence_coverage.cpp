@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <j2735_convertor/geofence_coverage.h>
+#include <j2735_convertor/geofence_store.h>
+
+/**
+ * CPP File containing GeofenceCoverage method definitions
+ */
+
+namespace j2735_convertor
+{
+constexpr double GeofenceCoverage::CLOCK_MARGIN;
+constexpr size_t GeofenceCoverage::MAX_PENDING_REQUESTS;
+constexpr size_t GeofenceCoverage::MAX_AREAS;
+
+namespace
+{
+bool contains(const PackedRTree::Box& outer, const PackedRTree::Box& inner)
+{
+  return outer.min_x <= inner.min_x && inner.max_x <= outer.max_x && outer.min_y <= inner.min_y &&
+         inner.max_y <= outer.max_y;
+}
+
+std::string requestId(const j2735_msgs::Id64b& reqid)
+{
+  return std::string(reqid.id.begin(), reqid.id.end());
+}
+}  // namespace
+
+size_t GeofenceCoverage::trackRequest(cav_msgs::TrafficControlRequestV01& request, const ros::Time& now)
+{
+  std::string reqid = requestId(request.reqid);
+  bool tracked = std::any_of(pending_.begin(), pending_.end(),
+                             [&reqid](const PendingRequest& pending) { return pending.reqid == reqid; });
+  if (!tracked)
+  {
+    // A repeated request keeps the responses already received for it
+    pending_.emplace_back();
+    pending_.back().reqid = reqid;
+    for (const cav_msgs::TrafficControlBounds& bounds : request.bounds)
+    {
+      pending_.back().areas.push_back({ GeofenceStore::extent(bounds), bounds.oldest, now });
+    }
+    if (pending_.size() > MAX_PENDING_REQUESTS)
+    {
+      pending_.pop_front();
+    }
+  }
+
+  size_t narrowed = 0;
+  for (cav_msgs::TrafficControlBounds& bounds : request.bounds)
+  {
+    PackedRTree::Box extent = GeofenceStore::extent(bounds);
+    ros::Time oldest = bounds.oldest;
+    for (const Area& area : areas_)
+    {
+      if (area.oldest <= bounds.oldest && area.complete.toSec() > CLOCK_MARGIN && contains(area.extent, extent))
+      {
+        oldest = std::max(oldest, area.complete - ros::Duration(CLOCK_MARGIN));
+      }
+    }
+    if (oldest != bounds.oldest)
+    {
+      bounds.oldest = oldest;
+      narrowed++;
+    }
+  }
+  return narrowed;
+}
+
+bool GeofenceCoverage::addResponse(const cav_msgs::TrafficControlMessageV01& response)
+{
+  std::string reqid = requestId(response.reqid);
+  auto it = std::find_if(pending_.begin(), pending_.end(),
+                         [&reqid](const PendingRequest& pending) { return pending.reqid == reqid; });
+  if (it == pending_.end() || response.msgnum < 1 || response.msgnum > response.msgtot)
+  {
+    return false;
+  }
+
+  if (it->received.empty())
+  {
+    it->received.resize(response.msgtot, false);
+    it->remaining = response.msgtot;
+  }
+  if (it->received.size() != response.msgtot || it->received[response.msgnum - 1])
+  {
+    return false;  // Inconsistent total or a repeated response
+  }
+  it->received[response.msgnum - 1] = true;
+  if (--it->remaining > 0)
+  {
+    return false;
+  }
+
+  for (const Area& area : it->areas)
+  {
+    cover(area);
+  }
+  pending_.erase(it);
+  return true;
+}
+
+void GeofenceCoverage::cover(const Area& area)
+{
+  // Drop the areas the new one makes redundant
+  areas_.erase(std::remove_if(areas_.begin(), areas_.end(),
+                              [&area](const Area& covered) {
+                                return area.oldest <= covered.oldest && covered.complete <= area.complete &&
+                                       contains(area.extent, covered.extent);
+                              }),
+               areas_.end());
+  areas_.push_back(area);
+  if (areas_.size() > MAX_AREAS)
+  {
+    areas_.pop_front();
+  }
+}
+
+std::vector<GeofenceCoverage::Area> GeofenceCoverage::getAreas() const
+{
+  return std::vector<Area>(areas_.begin(), areas_.end());
+}
+
+void GeofenceCoverage::restore(const std::vector<Area>& areas)
+{
+  areas_.assign(areas.begin(), areas.end());
+  while (areas_.size() > MAX_AREAS)
+  {
+    areas_.pop_front();
+  }
+}
+
+}  // namespace j2735_convertor
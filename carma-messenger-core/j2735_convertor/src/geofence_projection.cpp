@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <initializer_list>
+#include <sstream>
+#include <unordered_map>
+#include <j2735_convertor/geofence_projection.h>
+
+/**
+ * CPP File containing GeofenceProjection method definitions
+ */
+
+namespace j2735_convertor
+{
+namespace
+{
+constexpr double DEG_TO_RAD = M_PI / 180.0;
+
+// WGS84 ellipsoid
+constexpr double A = 6378137.0;
+constexpr double F = 1.0 / 298.257223563;
+constexpr double E2 = F * (2.0 - F);
+constexpr double E4 = E2 * E2;
+constexpr double E6 = E4 * E2;
+constexpr double EP2 = E2 / (1.0 - E2);
+
+constexpr double UTM_K_0 = 0.9996;
+constexpr double UTM_FALSE_EASTING = 500000.0;
+constexpr double UTM_FALSE_NORTHING_SOUTH = 10000000.0;
+
+/**
+ * @brief Read a numeric proj parameter
+ *
+ * @return False if the parameter is present but not a number
+ */
+bool readNumber(const std::unordered_map<std::string, std::string>& params, const std::string& key, double& value)
+{
+  auto it = params.find(key);
+  if (it == params.end())
+  {
+    return true;  // Keep the default
+  }
+  char* end;
+  value = strtod(it->second.c_str(), &end);
+  return !it->second.empty() && *end == '\0';
+}
+
+/**
+ * @brief Returns true if the parameter is absent or has one of the accepted values
+ */
+bool hasValue(const std::unordered_map<std::string, std::string>& params, const std::string& key,
+              std::initializer_list<const char*> accepted)
+{
+  auto it = params.find(key);
+  if (it == params.end())
+  {
+    return true;
+  }
+  for (const char* value : accepted)
+  {
+    if (it->second == value)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+std::shared_ptr<const GeofenceProjection> GeofenceProjection::parse(const std::string& proj)
+{
+  std::unordered_map<std::string, std::string> params;
+  std::istringstream tokens(proj);
+  std::string token;
+  while (tokens >> token)
+  {
+    if (token[0] != '+')
+    {
+      return nullptr;
+    }
+    size_t equals = token.find('=');
+    if (equals == std::string::npos)
+    {
+      params[token.substr(1)] = "";
+    }
+    else
+    {
+      params[token.substr(1, equals - 1)] = token.substr(equals + 1);
+    }
+  }
+
+  if (!hasValue(params, "datum", { "WGS84" }) || !hasValue(params, "ellps", { "WGS84", "GRS80" }) ||
+      !hasValue(params, "units", { "m" }))
+  {
+    return nullptr;
+  }
+
+  double lat_0 = 0.0, lon_0 = 0.0, k_0 = 1.0, x_0 = 0.0, y_0 = 0.0;
+  auto projection = params.find("proj");
+  if (projection == params.end())
+  {
+    return nullptr;
+  }
+  else if (projection->second == "tmerc")
+  {
+    if (!readNumber(params, "lat_0", lat_0) || !readNumber(params, "lon_0", lon_0) || !readNumber(params, "k", k_0) ||
+        !readNumber(params, "k_0", k_0) || !readNumber(params, "x_0", x_0) || !readNumber(params, "y_0", y_0))
+    {
+      return nullptr;
+    }
+  }
+  else if (projection->second == "utm")
+  {
+    double zone = 0.0;
+    if (!readNumber(params, "zone", zone) || zone < 1.0 || zone > 60.0)
+    {
+      return nullptr;
+    }
+    lon_0 = std::floor(zone) * 6.0 - 183.0;
+    k_0 = UTM_K_0;
+    x_0 = UTM_FALSE_EASTING;
+    y_0 = params.count("south") ? UTM_FALSE_NORTHING_SOUTH : 0.0;
+  }
+  else
+  {
+    return nullptr;
+  }
+
+  return std::shared_ptr<const GeofenceProjection>(new GeofenceProjection(lat_0, lon_0, k_0, x_0, y_0));
+}
+
+GeofenceProjection::GeofenceProjection(double lat_0, double lon_0, double k_0, double x_0, double y_0)
+  : lon_0_(lon_0 * DEG_TO_RAD)
+  , k_0_(k_0)
+  , x_0_(x_0)
+  , y_0_(y_0)
+  , m_0_(meridianDistance(lat_0 * DEG_TO_RAD))
+{
+}
+
+double GeofenceProjection::meridianDistance(double phi)
+{
+  return A * ((1.0 - E2 / 4.0 - 3.0 * E4 / 64.0 - 5.0 * E6 / 256.0) * phi -
+              (3.0 * E2 / 8.0 + 3.0 * E4 / 32.0 + 45.0 * E6 / 1024.0) * sin(2.0 * phi) +
+              (15.0 * E4 / 256.0 + 45.0 * E6 / 1024.0) * sin(4.0 * phi) - (35.0 * E6 / 3072.0) * sin(6.0 * phi));
+}
+
+// Series from Snyder, Map Projections - A Working Manual, USGS Professional Paper 1395, pages 61 to 64
+
+void GeofenceProjection::forward(double latitude, double longitude, double& x, double& y) const
+{
+  double phi = latitude * DEG_TO_RAD;
+  double sin_phi = sin(phi);
+  double cos_phi = cos(phi);
+  double tan_phi = tan(phi);
+
+  double n = A / sqrt(1.0 - E2 * sin_phi * sin_phi);
+  double t = tan_phi * tan_phi;
+  double c = EP2 * cos_phi * cos_phi;
+  double a = (longitude * DEG_TO_RAD - lon_0_) * cos_phi;
+  double a2 = a * a;
+
+  x = x_0_ + k_0_ * n * (a + (1.0 - t + c) * a2 * a / 6.0 +
+                         (5.0 - 18.0 * t + t * t + 72.0 * c - 58.0 * EP2) * a2 * a2 * a / 120.0);
+  y = y_0_ + k_0_ * (meridianDistance(phi) - m_0_ +
+                     n * tan_phi * (a2 / 2.0 + (5.0 - t + 9.0 * c + 4.0 * c * c) * a2 * a2 / 24.0 +
+                                    (61.0 - 58.0 * t + t * t + 600.0 * c - 330.0 * EP2) * a2 * a2 * a2 / 720.0));
+}
+
+void GeofenceProjection::inverse(double x, double y, double& latitude, double& longitude) const
+{
+  double m = m_0_ + (y - y_0_) / k_0_;
+  double mu = m / (A * (1.0 - E2 / 4.0 - 3.0 * E4 / 64.0 - 5.0 * E6 / 256.0));
+  double e1 = (1.0 - sqrt(1.0 - E2)) / (1.0 + sqrt(1.0 - E2));
+  double phi_1 = mu + (3.0 * e1 / 2.0 - 27.0 * pow(e1, 3) / 32.0) * sin(2.0 * mu) +
+                 (21.0 * e1 * e1 / 16.0 - 55.0 * pow(e1, 4) / 32.0) * sin(4.0 * mu) +
+                 (151.0 * pow(e1, 3) / 96.0) * sin(6.0 * mu) + (1097.0 * pow(e1, 4) / 512.0) * sin(8.0 * mu);
+
+  double sin_phi_1 = sin(phi_1);
+  double cos_phi_1 = cos(phi_1);
+  double tan_phi_1 = tan(phi_1);
+  double c_1 = EP2 * cos_phi_1 * cos_phi_1;
+  double t_1 = tan_phi_1 * tan_phi_1;
+  double w = 1.0 - E2 * sin_phi_1 * sin_phi_1;
+  double n_1 = A / sqrt(w);
+  double r_1 = A * (1.0 - E2) / (w * sqrt(w));
+  double d = (x - x_0_) / (n_1 * k_0_);
+  double d2 = d * d;
+
+  double phi = phi_1 - (n_1 * tan_phi_1 / r_1) *
+                           (d2 / 2.0 - (5.0 + 3.0 * t_1 + 10.0 * c_1 - 4.0 * c_1 * c_1 - 9.0 * EP2) * d2 * d2 / 24.0 +
+                            (61.0 + 90.0 * t_1 + 298.0 * c_1 + 45.0 * t_1 * t_1 - 252.0 * EP2 - 3.0 * c_1 * c_1) *
+                                d2 * d2 * d2 / 720.0);
+  double lambda = lon_0_ + (d - (1.0 + 2.0 * t_1 + c_1) * d2 * d / 6.0 +
+                            (5.0 - 2.0 * c_1 + 28.0 * t_1 - 3.0 * c_1 * c_1 + 8.0 * EP2 + 24.0 * t_1 * t_1) * d2 * d2 *
+                                d / 120.0) /
+                               cos_phi_1;
+
+  latitude = phi / DEG_TO_RAD;
+  longitude = lambda / DEG_TO_RAD;
+}
+
+}  // namespace j2735_convertor
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <j2735_convertor/geofence_scheduler.h>
+
+/**
+ * CPP File containing GeofenceScheduler method definitions
+ */
+
+namespace j2735_convertor
+{
+namespace
+{
+constexpr int64_t SEC_PER_DAY = 86400;
+constexpr int64_t DAYS_PER_WEEK = 7;
+constexpr int64_t FOREVER = std::numeric_limits<int64_t>::max();
+
+// Day of week of day 0 of the epoch (1970-01-01), counting from Sunday
+constexpr int64_t EPOCH_WEEKDAY = 4;
+
+// Index into DayOfWeek::dow for each day of the week counting from Sunday
+const uint8_t DOW_INDEX[DAYS_PER_WEEK] = { j2735_msgs::DayOfWeek::SUN, j2735_msgs::DayOfWeek::MON,
+                                           j2735_msgs::DayOfWeek::TUE, j2735_msgs::DayOfWeek::WED,
+                                           j2735_msgs::DayOfWeek::THU, j2735_msgs::DayOfWeek::FRI,
+                                           j2735_msgs::DayOfWeek::SAT };
+
+bool isDayEnabled(const cav_msgs::TrafficControlSchedule& schedule, int64_t day)
+{
+  if (!schedule.dow_exists)
+  {
+    return true;
+  }
+  int64_t weekday = ((day + EPOCH_WEEKDAY) % DAYS_PER_WEEK + DAYS_PER_WEEK) % DAYS_PER_WEEK;
+  return schedule.dow.dow[DOW_INDEX[weekday]] != 0;
+}
+
+/**
+ * @brief Active interval search limited to the schedule start and end
+ */
+struct IntervalSearch
+{
+  int64_t from;   // Intervals must end after this time
+  int64_t start;  // Schedule start
+  int64_t end;    // Schedule end
+  bool found = false;
+  int64_t begin_sec = 0;
+  int64_t end_sec = 0;
+
+  /**
+   * @brief Keep the interval if it is the earliest one so far ending after from
+   */
+  void offer(int64_t begin, int64_t finish)
+  {
+    begin = std::max(begin, start);
+    finish = std::min(finish, end);
+    if (finish <= from || finish <= begin)
+    {
+      return;
+    }
+    if (!found || begin < begin_sec)
+    {
+      found = true;
+      begin_sec = begin;
+      end_sec = finish;
+    }
+  }
+
+  /**
+   * @brief Offer the repeat spans of a window or the whole window if the schedule does not repeat
+   */
+  void offerWindow(const cav_msgs::TrafficControlSchedule& schedule, int64_t window_begin, int64_t window_end)
+  {
+    int64_t period = schedule.repeat_exists ? schedule.repeat.period.sec : 0;
+    if (period <= 0)
+    {
+      offer(window_begin, window_end);
+      return;
+    }
+
+    int64_t base = window_begin + schedule.repeat.offset.sec;
+    int64_t span = schedule.repeat.span.sec;
+    int64_t first = from > base ? (from - base) / period : 0;
+    // The repetition containing from may already have ended, in which case the next one is the candidate
+    for (int64_t k = first; k <= first + 1; k++)
+    {
+      int64_t repeat_begin = base + k * period;
+      if (repeat_begin >= window_end)
+      {
+        return;
+      }
+      offer(repeat_begin, std::min(repeat_begin + span, window_end));
+    }
+  }
+};
+
+/**
+ * @brief Find the earliest active interval ending after from, without merging adjacent intervals
+ */
+bool firstInterval(const cav_msgs::TrafficControlSchedule& schedule, int64_t from, int64_t& begin, int64_t& end)
+{
+  IntervalSearch search;
+  search.from = from;
+  search.start = schedule.start.sec;
+  search.end = schedule.end_exists ? static_cast<int64_t>(schedule.end.sec) : FOREVER;
+
+  int64_t search_from = std::max(from, search.start);
+  if (search_from >= search.end)
+  {
+    return false;
+  }
+
+  // Windows of the previous day may run past midnight. The enabled days repeat every week.
+  int64_t first_day = search_from / SEC_PER_DAY - 1;
+  for (int64_t day = first_day; day <= first_day + DAYS_PER_WEEK + 1; day++)
+  {
+    int64_t day_begin = day * SEC_PER_DAY;
+    if (day_begin >= search.end || (search.found && day_begin >= search.begin_sec))
+    {
+      break;  // Nothing later can start earlier
+    }
+    if (!isDayEnabled(schedule, day))
+    {
+      continue;
+    }
+
+    if (schedule.between_exists && !schedule.between.empty())
+    {
+      for (const cav_msgs::DailySchedule& window : schedule.between)
+      {
+        int64_t window_begin = day_begin + window.begin.sec;
+        search.offerWindow(schedule, window_begin, window_begin + window.duration.sec);
+      }
+    }
+    else
+    {
+      search.offerWindow(schedule, day_begin, day_begin + SEC_PER_DAY);
+    }
+  }
+
+  begin = search.begin_sec;
+  end = search.end_sec;
+  return search.found;
+}
+}  // namespace
+
+bool nextActiveInterval(const cav_msgs::TrafficControlSchedule& schedule, const ros::Time& time, ros::Time& begin,
+                        ros::Time& end)
+{
+  int64_t begin_sec;
+  int64_t end_sec;
+  if (!firstInterval(schedule, time.sec, begin_sec, end_sec))
+  {
+    return false;
+  }
+
+  // Extend over intervals starting exactly where the previous one ends, such as consecutive enabled days.
+  // Limited to a week since a schedule which is active the whole week never ends before the schedule end.
+  for (int i = 0; i < DAYS_PER_WEEK && end_sec != FOREVER; i++)
+  {
+    int64_t next_begin;
+    int64_t next_end;
+    if (!firstInterval(schedule, end_sec, next_begin, next_end) || next_begin > end_sec)
+    {
+      break;
+    }
+    end_sec = next_end;
+  }
+
+  begin = ros::Time(begin_sec, 0);
+  end = end_sec == FOREVER ? ros::TIME_MAX : ros::Time(end_sec, 0);
+  return true;
+}
+
+GeofenceScheduler::GeofenceScheduler(const ros::Time& now) : wheel_(now.sec)
+{
+}
+
+std::string GeofenceScheduler::key(const j2735_msgs::Id128b& id)
+{
+  return std::string(id.id.begin(), id.id.end());
+}
+
+void GeofenceScheduler::update(const cav_msgs::TrafficControlMessageV01& geofence, const ros::Time& now,
+                               std::vector<ScheduleEvent>& events)
+{
+  uint32_t index;
+  auto it = entry_index_.find(key(geofence.id));
+  if (it != entry_index_.end())
+  {
+    index = it->second;
+  }
+  else
+  {
+    if (free_entries_.empty())
+    {
+      index = entries_.size();
+      entries_.emplace_back();
+    }
+    else
+    {
+      index = free_entries_.back();
+      free_entries_.pop_back();
+    }
+    entry_index_[key(geofence.id)] = index;
+    entries_[index].id = geofence.id;
+    entries_[index].active = false;
+    entries_[index].used = true;
+  }
+
+  Entry& entry = entries_[index];
+  entry.params_exists = geofence.params_exists;
+  entry.schedule = geofence.params.schedule;
+  entry.generation++;  // Forget the transition of the previous schedule
+  evaluate(index, now, events);
+}
+
+void GeofenceScheduler::evaluate(uint32_t index, const ros::Time& now, std::vector<ScheduleEvent>& events)
+{
+  Entry& entry = entries_[index];
+
+  bool active = true;
+  bool has_transition = false;
+  ros::Time transition;
+  if (entry.params_exists)
+  {
+    ros::Time begin;
+    ros::Time end;
+    has_transition = nextActiveInterval(entry.schedule, now, begin, end);
+    active = has_transition && begin <= now;
+    transition = active ? end : begin;
+    has_transition = has_transition && transition != ros::TIME_MAX;
+  }
+
+  if (active != entry.active)
+  {
+    entry.active = active;
+    events.push_back({ entry.id, active, now });
+  }
+
+  if (has_transition)
+  {
+    wheel_.add((static_cast<uint64_t>(entry.generation) << 32) | index, transition.sec);
+  }
+  else if (!active)
+  {
+    // Never active again
+    entry_index_.erase(key(entry.id));
+    entry.used = false;
+    entry.generation++;
+    free_entries_.push_back(index);
+  }
+}
+
+void GeofenceScheduler::advance(const ros::Time& now, std::vector<ScheduleEvent>& events)
+{
+  expired_.clear();
+  wheel_.advance(now.sec, expired_);
+  for (uint64_t timer_id : expired_)
+  {
+    uint32_t index = static_cast<uint32_t>(timer_id);
+    uint32_t generation = static_cast<uint32_t>(timer_id >> 32);
+    if (!entries_[index].used || entries_[index].generation != generation)
+    {
+      continue;  // Replaced or forgotten since the timer was added
+    }
+    evaluate(index, now, events);
+  }
+}
+
+bool GeofenceScheduler::isActive(const j2735_msgs::Id128b& id) const
+{
+  auto it = entry_index_.find(key(id));
+  return it != entry_index_.end() && entries_[it->second].active;
+}
+
+}  // namespace j2735_convertor
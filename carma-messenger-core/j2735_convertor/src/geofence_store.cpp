@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <j2735_convertor/geofence_store.h>
+
+/**
+ * CPP File containing GeofenceStore method definitions
+ */
+
+namespace j2735_convertor
+{
+namespace
+{
+constexpr double METERS_PER_DEG_LAT = 6378137.0 * M_PI / 180.0;
+
+/**
+ * @brief Convert a box of east/north offsets in meters around a reference point into degrees of longitude/latitude
+ */
+PackedRTree::Box toDegrees(const PackedRTree::Box& offsets, double reflat, double reflon)
+{
+  double meters_per_deg_lon = METERS_PER_DEG_LAT * cos(reflat * M_PI / 180.0);
+  PackedRTree::Box box;
+  box.min_x = reflon + offsets.min_x / meters_per_deg_lon;
+  box.max_x = reflon + offsets.max_x / meters_per_deg_lon;
+  box.min_y = reflat + offsets.min_y / METERS_PER_DEG_LAT;
+  box.max_y = reflat + offsets.max_y / METERS_PER_DEG_LAT;
+  return box;
+}
+}  // namespace
+
+PackedRTree::Box GeofenceStore::extent(const cav_msgs::TrafficControlGeometry& geometry)
+{
+  PackedRTree::Box offsets = { 0.0, 0.0, 0.0, 0.0 };
+  double x = 0.0;
+  double y = 0.0;
+  for (size_t i = 0; i < geometry.nodes.size(); i++)
+  {
+    const cav_msgs::PathNode& node = geometry.nodes[i];
+    x += node.x;
+    y += node.y;
+    double half_width = node.width_exists ? fabs(node.width) / 2.0 : 0.0;
+    if (i == 0)
+    {
+      offsets = { x - half_width, y - half_width, x + half_width, y + half_width };
+      continue;
+    }
+    offsets.min_x = std::min(offsets.min_x, x - half_width);
+    offsets.min_y = std::min(offsets.min_y, y - half_width);
+    offsets.max_x = std::max(offsets.max_x, x + half_width);
+    offsets.max_y = std::max(offsets.max_y, y + half_width);
+  }
+  return toDegrees(offsets, geometry.reflat, geometry.reflon);
+}
+
+PackedRTree::Box GeofenceStore::extent(const cav_msgs::TrafficControlBounds& bounds)
+{
+  // The reference point is one corner and the offsets locate the other three
+  PackedRTree::Box offsets = { 0.0, 0.0, 0.0, 0.0 };
+  for (const cav_msgs::OffsetPoint& offset : bounds.offsets)
+  {
+    offsets.min_x = std::min(offsets.min_x, offset.deltax);
+    offsets.min_y = std::min(offsets.min_y, offset.deltay);
+    offsets.max_x = std::max(offsets.max_x, offset.deltax);
+    offsets.max_y = std::max(offsets.max_y, offset.deltay);
+  }
+  return toDegrees(offsets, bounds.reflat, bounds.reflon);
+}
+
+std::string GeofenceStore::key(const cav_msgs::TrafficControlMessageV01& geofence)
+{
+  return std::string(geofence.id.id.begin(), geofence.id.id.end());
+}
+
+bool GeofenceStore::add(const cav_msgs::TrafficControlMessageV01& geofence)
+{
+  if (!geofence.geometry_exists)
+  {
+    return false;  // Nothing to index
+  }
+
+  Entry entry;
+  entry.geofence = std::make_shared<const cav_msgs::TrafficControlMessageV01>(geofence);
+  entry.extent = extent(geofence.geometry);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto result = entry_index_.emplace(key(geofence), entries_.size());
+  if (result.second)
+  {
+    entries_.push_back(entry);
+  }
+  else
+  {
+    Entry& stored = entries_[result.first->second];
+    if (stored.geofence->updated >= geofence.updated)
+    {
+      return false;  // Keep the stored version, rebroadcasts of it change nothing
+    }
+    stored = entry;
+  }
+  dirty_ = true;
+  return true;
+}
+
+bool GeofenceStore::holds(const cav_msgs::TrafficControlMessageV01& geofence) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entry_index_.find(key(geofence));
+  return it != entry_index_.end() && entries_[it->second].geofence->updated >= geofence.updated;
+}
+
+std::vector<j2735_msgs::Id128b> GeofenceStore::removeExpired(const ros::Time& now)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<j2735_msgs::Id128b> removed;
+  for (size_t i = 0; i < entries_.size();)
+  {
+    const cav_msgs::TrafficControlMessageV01& geofence = *entries_[i].geofence;
+    if (!geofence.params_exists || !geofence.params.schedule.end_exists || geofence.params.schedule.end >= now)
+    {
+      i++;
+      continue;
+    }
+
+    removed.push_back(geofence.id);
+
+    // Move the last entry into the removed slot
+    entry_index_.erase(key(geofence));
+    if (i + 1 < entries_.size())
+    {
+      entries_[i] = entries_.back();
+      entry_index_[key(*entries_[i].geofence)] = i;
+    }
+    entries_.pop_back();
+  }
+
+  if (!removed.empty())
+  {
+    dirty_ = true;
+  }
+  return removed;
+}
+
+template <typename Visitor>
+void GeofenceStore::visit(const cav_msgs::TrafficControlBounds& bounds, Visitor visitor) const
+{
+  if (dirty_)
+  {
+    std::vector<PackedRTree::Box> extents(entries_.size());
+    for (size_t i = 0; i < entries_.size(); i++)
+    {
+      extents[i] = entries_[i].extent;
+    }
+    tree_ = PackedRTree(extents);
+    dirty_ = false;
+  }
+
+  tree_.query(extent(bounds), [&](uint32_t index) {
+    if (entries_[index].geofence->updated >= bounds.oldest)
+    {
+      visitor(index);
+    }
+  });
+}
+
+std::vector<GeofenceStore::GeofencePtr> GeofenceStore::query(const cav_msgs::TrafficControlBounds& bounds) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<GeofencePtr> geofences;
+  visit(bounds, [&](uint32_t index) { geofences.push_back(entries_[index].geofence); });
+  return geofences;
+}
+
+std::vector<GeofenceStore::GeofencePtr> GeofenceStore::query(const cav_msgs::TrafficControlRequestV01& request) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<uint32_t> indices;
+  for (const cav_msgs::TrafficControlBounds& bounds : request.bounds)
+  {
+    visit(bounds, [&](uint32_t index) { indices.push_back(index); });
+  }
+
+  // A geofence may intersect several of the bounds
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  std::vector<GeofencePtr> geofences;
+  geofences.reserve(indices.size());
+  for (uint32_t index : indices)
+  {
+    geofences.push_back(entries_[index].geofence);
+  }
+  return geofences;
+}
+
+std::vector<GeofenceStore::GeofencePtr> GeofenceStore::getGeofences() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<GeofencePtr> geofences;
+  geofences.reserve(entries_.size());
+  for (const Entry& entry : entries_)
+  {
+    geofences.push_back(entry.geofence);
+  }
+  return geofences;
+}
+
+size_t GeofenceStore::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace j2735_convertor
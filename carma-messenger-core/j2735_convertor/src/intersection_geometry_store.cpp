@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <j2735_msgs/NodeOffsetPointXY.h>
+#include <j2735_convertor/intersection_geometry_store.h>
+
+/**
+ * CPP File containing IntersectionGeometryStore method definitions
+ */
+
+namespace j2735_convertor
+{
+namespace
+{
+constexpr double DEFAULT_LANE_WIDTH_M = 3.66;  // Used when the MAP does not provide a lane width
+}  // namespace
+
+int IntersectionGeometry::findLane(uint8_t lane_id) const
+{
+  for (size_t i = 0; i < lane_ids.size(); i++)
+  {
+    if (lane_ids[i] == lane_id)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+IntersectionGeometryStore::IntersectionGeometryStore(std::shared_ptr<LocalFrame> frame) : frame_(frame)
+{
+}
+
+void IntersectionGeometryStore::setOrigin(double latitude, double longitude)
+{
+  frame_->setOrigin(latitude, longitude);
+}
+
+bool IntersectionGeometryStore::getOrigin(double& latitude, double& longitude) const
+{
+  return frame_->getOrigin(latitude, longitude);
+}
+
+bool IntersectionGeometryStore::toLocal(double latitude, double longitude, double& x, double& y) const
+{
+  return frame_->toLocal(latitude, longitude, x, y);
+}
+
+std::shared_ptr<IntersectionGeometry> IntersectionGeometryStore::build(const cav_msgs::IntersectionGeometry& in_msg) const
+{
+  std::shared_ptr<IntersectionGeometry> out(new IntersectionGeometry());
+  out->id = in_msg.id.id;
+  out->revision = in_msg.revision;
+  frame_->toLocal(in_msg.ref_point.latitude, in_msg.ref_point.longitude, out->ref_x, out->ref_y);
+
+  double default_width = in_msg.lane_width_exists ? in_msg.lane_width : DEFAULT_LANE_WIDTH_M;
+
+  // Size the point arrays once
+  size_t point_count = 0;
+  for (const cav_msgs::GenericLane& lane : in_msg.lane_list)
+  {
+    point_count += lane.node_list.nodes.node_set_xy.size();
+  }
+  out->lane_ids.reserve(in_msg.lane_list.size());
+  out->lane_offsets.reserve(in_msg.lane_list.size() + 1);
+  out->x.reserve(point_count);
+  out->y.reserve(point_count);
+  out->width.reserve(point_count);
+
+  out->lane_offsets.push_back(0);
+  for (const cav_msgs::GenericLane& lane : in_msg.lane_list)
+  {
+    // The first node is relative to the reference point and each following node to the previous one
+    double x = out->ref_x;
+    double y = out->ref_y;
+    double width = default_width;
+    for (const cav_msgs::NodeXY& node : lane.node_list.nodes.node_set_xy)
+    {
+      if (node.delta.choice == j2735_msgs::NodeOffsetPointXY::NODE_LATLON)
+      {
+        frame_->toLocal(node.delta.latitude, node.delta.longitude, x, y);
+      }
+      else
+      {
+        x += node.delta.x;
+        y += node.delta.y;
+      }
+      if (node.attributes_exists && node.attributes.dWitdh_exists)
+      {
+        width += node.attributes.dWitdh;  // Width changes apply from this node onwards
+      }
+      out->x.push_back(x);
+      out->y.push_back(y);
+      out->width.push_back(width);
+    }
+    out->lane_ids.push_back(lane.lane_id);
+    out->lane_offsets.push_back(out->x.size());
+  }
+  return out;
+}
+
+bool IntersectionGeometryStore::update(const cav_msgs::MapData& map)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool changed = false;
+  for (const cav_msgs::IntersectionGeometry& intersection : map.intersections)
+  {
+    auto it = intersections_.find(intersection.id.id);
+    if (it != intersections_.end() && it->second->revision == intersection.revision)
+    {
+      continue;  // Revision already computed
+    }
+
+    frame_->setOrigin(intersection.ref_point.latitude, intersection.ref_point.longitude);  // Unless already set
+    intersections_[intersection.id.id] = build(intersection);
+    changed = true;
+  }
+  if (changed)
+  {
+    version_++;
+  }
+  return changed;
+}
+
+std::shared_ptr<const IntersectionGeometry> IntersectionGeometryStore::getIntersection(uint16_t intersection_id) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = intersections_.find(intersection_id);
+  if (it == intersections_.end())
+  {
+    return nullptr;
+  }
+  return it->second;
+}
+
+std::vector<std::shared_ptr<const IntersectionGeometry>> IntersectionGeometryStore::getIntersections() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::shared_ptr<const IntersectionGeometry>> out;
+  out.reserve(intersections_.size());
+  for (const auto& entry : intersections_)
+  {
+    out.push_back(entry.second);
+  }
+  return out;
+}
+
+uint64_t IntersectionGeometryStore::version() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return version_;
+}
+
+}  // namespace j2735_convertor
@@ -18,6 +18,9 @@
  * CPP File containing J2735Convertor method definitions
  */
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 #include "j2735_convertor.h"
 #include <j2735_convertor/control_message_convertor.h>
 #include <j2735_convertor/control_request_convertor.h>
@@ -66,6 +69,7 @@ void J2735Convertor::initialize()
 {
   // Setup node handles here if needed
   default_nh_.reset(new ros::CARMANodeHandle());
+  pnh_.reset(new ros::CARMANodeHandle("~"));
   bsm_nh_.reset(new ros::CARMANodeHandle());
   spat_nh_.reset(new ros::CARMANodeHandle());
   map_nh_.reset(new ros::CARMANodeHandle());
@@ -76,12 +80,118 @@ void J2735Convertor::initialize()
   map_nh_->setCallbackQueue(&map_queue_);
   geofence_nh_->setCallbackQueue(&geofence_queue_);
 
+  // Load parameters
+  pnh_->param<int>("spat_keyframe_interval", spat_keyframe_interval_, spat_keyframe_interval_);
+  if (spat_keyframe_interval_ < 1)
+  {
+    ROS_WARN_STREAM("Invalid spat_keyframe_interval " << spat_keyframe_interval_ << ", using 10");
+    spat_keyframe_interval_ = 10;
+  }
+  spat_delta_convertor_.reset(new SPATDeltaConvertor(spat_keyframe_interval_));
+  pnh_->param<bool>("demux_intersections", demux_intersections_, demux_intersections_);
+  if (demux_intersections_)
+  {
+    spat_demux_.reset(new IntersectionDemux<ros::Publisher>([this](uint16_t id) {
+      return spat_nh_->advertise<cav_msgs::SPAT>(IntersectionDemux<ros::Publisher>::topic("incoming_spat", id), 10);
+    }));
+    // MAP topics are latched so late subscribers get the current geometry
+    map_demux_.reset(new IntersectionDemux<ros::Publisher>([this](uint16_t id) {
+      return map_nh_->advertise<cav_msgs::MapData>(IntersectionDemux<ros::Publisher>::topic("incoming_map", id), 10,
+                                                   true);
+    }));
+  }
+  // Lanes and geofence polygons share one frame, whose origin is set by the parameters or the first MAP or geofence
+  std::shared_ptr<LocalFrame> local_frame = std::make_shared<LocalFrame>();
+  double origin_lat, origin_lon;
+  if (pnh_->getParam("geometry_origin_lat", origin_lat) && pnh_->getParam("geometry_origin_lon", origin_lon))
+  {
+    local_frame->setOrigin(origin_lat, origin_lon);
+  }
+  geometry_store_.reset(new IntersectionGeometryStore(local_frame));
+  signal_group_index_.reset(new SignalGroupIndex());
+  geofence_store_.reset(new GeofenceStore());
+  geofence_compiler_.reset(new GeofenceCompiler(local_frame));
+  pnh_->param<bool>("respond_to_geofence_requests", respond_to_geofence_requests_, respond_to_geofence_requests_);
+  std::string geofence_cache_path;
+  pnh_->param<std::string>("geofence_cache_path", geofence_cache_path, "");
+  if (!geofence_cache_path.empty())
+  {
+    geofence_cache_.reset(new GeofenceCache(geofence_cache_path));
+    geofence_cache_->load(*geofence_store_, ros::Time::now());
+    geofence_coverage_.reset(new GeofenceCoverage());
+    geofence_coverage_->restore(geofence_cache_->loadCoverage());
+  }
+
   // J2735 BSM Subscriber
   j2735_bsm_sub_ = bsm_nh_->subscribe("incoming_j2735_bsm", 100, &J2735Convertor::j2735BsmHandler, this);
 
   // BSM Publisher
   converted_bsm_pub_ = bsm_nh_->advertise<cav_msgs::BSM>("incoming_bsm", 100);
 
+  // Remote vehicle tracking on the bsm thread
+  int vehicle_tracker_capacity = 256;
+  double vehicle_max_age = 2.0, vehicle_snapshot_rate = 10.0;
+  pnh_->param<int>("vehicle_tracker_capacity", vehicle_tracker_capacity, vehicle_tracker_capacity);
+  pnh_->param<double>("vehicle_max_age", vehicle_max_age, vehicle_max_age);
+  pnh_->param<double>("vehicle_snapshot_rate", vehicle_snapshot_rate, vehicle_snapshot_rate);
+  vehicle_tracker_.reset(new VehicleTracker(std::max(vehicle_tracker_capacity, 1), ros::Duration(vehicle_max_age)));
+  vehicle_snapshot_msg_.vehicles.reserve(vehicle_tracker_->capacity());
+  // The mobility messages are only subscribed while the snapshot has subscribers, so cpp_message can still skip
+  // decoding them otherwise
+  vehicle_snapshot_pub_ = bsm_nh_->advertise<RemoteVehicleSnapshot>(
+      "remote_vehicles", 1, boost::bind(&J2735Convertor::vehicleSnapshotConnectCallback, this, _1),
+      boost::bind(&J2735Convertor::vehicleSnapshotDisconnectCallback, this, _1));
+  if (vehicle_snapshot_rate > 0)
+  {
+    vehicle_snapshot_timer_ = bsm_nh_->createTimer(ros::Duration(1.0 / vehicle_snapshot_rate),
+                                                   &J2735Convertor::vehicleSnapshotTimerCallback, this);
+  }
+  else
+  {
+    // Without snapshots the vehicles still have to expire to free their slots
+    vehicle_snapshot_timer_ = bsm_nh_->createTimer(ros::Duration(std::max(vehicle_max_age, 0.1)),
+                                                   &J2735Convertor::vehicleExpiryTimerCallback, this);
+  }
+
+  // Frame counters, registered before the spinners start counting
+  counter_types_.incoming_bsm = pipeline_counters_.add_type("incoming BSM");
+  counter_types_.outgoing_bsm = pipeline_counters_.add_type("outgoing BSM");
+  counter_types_.incoming_spat = pipeline_counters_.add_type("incoming SPAT");
+  counter_types_.incoming_map = pipeline_counters_.add_type("incoming MAP");
+  counter_types_.incoming_geofence_control = pipeline_counters_.add_type("incoming TrafficControlMessage");
+  counter_types_.outgoing_geofence_control = pipeline_counters_.add_type("outgoing TrafficControlMessage");
+  counter_types_.incoming_geofence_request = pipeline_counters_.add_type("incoming TrafficControlRequest");
+  counter_types_.outgoing_geofence_request = pipeline_counters_.add_type("outgoing TrafficControlRequest");
+  pnh_->param<double>("diagnostics_period", diagnostics_period_, diagnostics_period_);
+  diagnostics_pub_ = default_nh_->advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 10);
+  diagnostics_timer_ = default_nh_->createTimer(ros::Duration(diagnostics_period_),
+                                                &J2735Convertor::diagnosticsTimerCallback, this);
+  metrics_service_ = pnh_->advertiseService("get_metrics", &J2735Convertor::metricsCallback, this);
+
+  // Conversion latency tracing
+  bool latency_tracing = false;
+  int latency_trace_capacity = 10000;
+  pnh_->param<bool>("latency_tracing", latency_tracing, latency_tracing);
+  pnh_->param<int>("latency_trace_capacity", latency_trace_capacity, latency_trace_capacity);
+  pnh_->param<std::string>("latency_trace_file", latency_trace_file_, "/opt/carma/logs/j2735_convertor_trace.json");
+  if (latency_tracing)
+  {
+    latency_tracer_.reset(new cpp_message::Latency_Tracer(std::max(latency_trace_capacity, 0)));
+    bsm_trace_stages_.convert = latency_tracer_->add_stage("BSM", "convert");
+    bsm_trace_stages_.publish = latency_tracer_->add_stage("BSM", "publish");
+    bsm_trace_stages_.has_total = true;
+    bsm_trace_stages_.total = latency_tracer_->add_stage("BSM", "total");
+    spat_trace_stages_.convert = latency_tracer_->add_stage("SPAT", "convert");
+    spat_trace_stages_.publish = latency_tracer_->add_stage("SPAT", "publish");
+    spat_trace_stages_.has_total = false;
+    export_latency_trace_service_ =
+        pnh_->advertiseService("export_latency_trace", &J2735Convertor::exportLatencyTraceCallback, this);
+  }
+
+  // Lane matched BSM Publishers
+  bsm_lane_match_pub_ = bsm_nh_->advertise<BSMLaneMatch>("incoming_bsm_lane_match", 100);
+  ego_lane_match_pub_ = bsm_nh_->advertise<BSMLaneMatch>("outgoing_bsm_lane_match", 1);
+
   // Outgoing J2735 BSM Subscriber
   outbound_bsm_sub_ = bsm_nh_->subscribe("outgoing_bsm", 1, &J2735Convertor::BsmHandler,
                                          this);  // Queue size of 1 as we should never publish outdated BSMs
@@ -96,15 +206,25 @@ void J2735Convertor::initialize()
   // SPAT Publisher TODO think about queue sizes
   converted_spat_pub_ = spat_nh_->advertise<cav_msgs::SPAT>("incoming_spat", 100);
 
+  // SPAT Delta Publisher
+  converted_spat_delta_pub_ = spat_nh_->advertise<cav_msgs::SPAT>("incoming_spat_delta", 100);
+
+  // Lane Signal State Publisher
+  lane_signal_state_pub_ = spat_nh_->advertise<LaneSignalStateList>("incoming_lane_signal_state", 100);
+
   // J2735 MAP Subscriber
   j2735_map_sub_ = map_nh_->subscribe("incoming_j2735_map", 50, &J2735Convertor::j2735MapHandler, this);
 
   // MAP Publisher TODO think about queue sizes
   converted_map_pub_ = map_nh_->advertise<cav_msgs::MapData>("incoming_map", 50);
+  // Lane geometry of the IntersectionGeometryStore, latched for consumers starting after the MAP was received
+  intersection_geometry_pub_ = map_nh_->advertise<LaneGeometryList>("intersection_geometry", 1, true);
 
   // Incoming geofence pub/sub
   converted_geofence_control_pub_ = geofence_nh_->advertise<cav_msgs::TrafficControlMessage>("incoming_geofence_control", 50);
   converted_geofence_request_pub_ = geofence_nh_->advertise<cav_msgs::TrafficControlRequest>("incoming_geofence_request", 50);
+  // Responses to outgoing requests answered from the geofence cache rather than the radio
+  cached_geofence_control_pub_ = geofence_nh_->advertise<cav_msgs::TrafficControlMessage>("cached_geofence_control", 50);
 
   j2735_geofence_control_sub_ = geofence_nh_->subscribe("incoming_j2735_geofence_control", 50, &J2735Convertor::j2735ControlMessageHandler, this);
   j2735_geofence_request_sub_ = geofence_nh_->subscribe("incoming_j2735_geofence_request", 50, &J2735Convertor::j2735ControlRequestHandler, this);
@@ -113,60 +233,488 @@ void J2735Convertor::initialize()
   outbound_geofence_control_sub_ = geofence_nh_->subscribe("outgoing_geofence_control", 50, &J2735Convertor::ControlMessageHandler, this);
   outbound_geofence_request_sub_ = geofence_nh_->subscribe("outgoing_geofence_request", 50, &J2735Convertor::ControlRequestHandler, this);
 
-  outbound_j2735_geofence_control_pub_ = geofence_nh_->advertise<j2735_msgs::TrafficControlMessage>("outgoing_j2735_geofence_control", 10);
+  outbound_j2735_geofence_control_pub_ = geofence_nh_->advertise<j2735_msgs::TrafficControlMessage>("outgoing_j2735_geofence_control", 64);
   outbound_j2735_geofence_request_pub_ = geofence_nh_->advertise<j2735_msgs::TrafficControlRequest>("outgoing_j2735_geofence_request", 10);
+
+  // Geofence schedule transitions and polygons, produced on the geofence thread. Cached geofences are handled right away.
+  geofence_activation_pub_ = geofence_nh_->advertise<TrafficControlActivation>("geofence_activation", 50);
+  geofence_polygon_pub_ = geofence_nh_->advertise<TrafficControlPolygon>("geofence_polygon", 50);
+  geofence_scheduler_.reset(new GeofenceScheduler(ros::Time::now()));
+  for (const GeofenceStore::GeofencePtr& geofence : geofence_store_->getGeofences())
+  {
+    geofence_scheduler_->update(*geofence, ros::Time::now(), schedule_events_);
+    publishGeofencePolygon(*geofence);
+  }
+  publishScheduleEvents();
+  geofence_schedule_timer_ = geofence_nh_->createTimer(ros::Duration(1.0), &J2735Convertor::geofenceScheduleTimerCallback, this);
 }
 
 void J2735Convertor::BsmHandler(const cav_msgs::BSMConstPtr& message)
 {
+  countIncoming(counter_types_.outgoing_bsm, *message);
   j2735_msgs::BSM j2735_msg;
   BSMConvertor::convert(*message, j2735_msg);  // Convert message
   outbound_j2735_bsm_pub_.publish(j2735_msg);  // Publish converted message
+  pipeline_counters_.add(counter_types_.outgoing_bsm, cpp_message::Pipeline_Counter::FRAMES_OUT);
+  publishLaneMatch(*message, ego_lane_match_pub_);
 }
 
 void J2735Convertor::j2735BsmHandler(const j2735_msgs::BSMConstPtr& message)
 {
+  countIncoming(counter_types_.incoming_bsm, *message);
+  ros::Time convert_start = latency_tracer_ ? ros::Time::now() : ros::Time();
   cav_msgs::BSM converted_msg;
   BSMConvertor::convert(*message, converted_msg);  // Convert message
+  ros::Time convert_end = latency_tracer_ ? ros::Time::now() : ros::Time();
   converted_bsm_pub_.publish(converted_msg);       // Publish converted message
+  pipeline_counters_.add(counter_types_.incoming_bsm, cpp_message::Pipeline_Counter::FRAMES_OUT);
+  if (latency_tracer_)
+  {
+    // The header stamp is the radio receive stamp set by cpp_message
+    traceConversion(bsm_trace_stages_, message->header.stamp, convert_start, convert_end);
+  }
+  publishLaneMatch(converted_msg, bsm_lane_match_pub_);
+  VehicleTracker::Update update = vehicle_tracker_->update(converted_msg, ros::Time::now());
+  if (update == VehicleTracker::Update::FULL || update == VehicleTracker::Update::INVALID)
+  {
+    // Published, but the vehicle is not tracked
+    pipeline_counters_.add(counter_types_.incoming_bsm, cpp_message::Pipeline_Counter::DROPS);
+  }
+}
+
+void J2735Convertor::mobilityOperationHandler(const cav_msgs::MobilityOperationConstPtr& message)
+{
+  vehicle_tracker_->correlate(message->header.sender_bsm_id, message->header.sender_id);
+}
+
+void J2735Convertor::mobilityPathHandler(const cav_msgs::MobilityPathConstPtr& message)
+{
+  vehicle_tracker_->correlate(message->header.sender_bsm_id, message->header.sender_id);
+}
+
+void J2735Convertor::vehicleSnapshotConnectCallback(const ros::SingleSubscriberPublisher& pub)
+{
+  if (!mobility_operation_sub_)
+  {
+    mobility_operation_sub_ =
+        bsm_nh_->subscribe("incoming_mobility_operation", 50, &J2735Convertor::mobilityOperationHandler, this);
+    mobility_path_sub_ = bsm_nh_->subscribe("incoming_mobility_path", 50, &J2735Convertor::mobilityPathHandler, this);
+  }
+}
+
+void J2735Convertor::vehicleSnapshotDisconnectCallback(const ros::SingleSubscriberPublisher& pub)
+{
+  if (vehicle_snapshot_pub_.getNumSubscribers() == 0)
+  {
+    // Vehicles keep the static ids correlated so far
+    mobility_operation_sub_.shutdown();
+    mobility_path_sub_.shutdown();
+  }
+}
+
+void J2735Convertor::vehicleExpiryTimerCallback(const ros::TimerEvent& event)
+{
+  vehicle_tracker_->expire(ros::Time::now());
+}
+
+void J2735Convertor::vehicleSnapshotTimerCallback(const ros::TimerEvent& event)
+{
+  ros::Time now = ros::Time::now();
+  vehicle_tracker_->expire(now);
+  if (vehicle_snapshot_pub_.getNumSubscribers() == 0)
+  {
+    return;
+  }
+
+  // Resized rather than cleared so the nested BSMs keep their allocations between snapshots
+  size_t count = 0;
+  vehicle_snapshot_msg_.vehicles.resize(vehicle_tracker_->size());
+  vehicle_tracker_->forEach([this, &count](const TrackedVehicle& vehicle) {
+    RemoteVehicle& out = vehicle_snapshot_msg_.vehicles[count++];
+    out.bsm = vehicle.bsm;
+    out.static_id = vehicle.static_id;
+    out.stamp = vehicle.stamp;
+    out.bsm_count = vehicle.bsm_count;
+  });
+  vehicle_snapshot_msg_.stamp = now;
+  vehicle_snapshot_msg_.duplicates = vehicle_tracker_->duplicates();
+  vehicle_snapshot_msg_.dropped = vehicle_tracker_->dropped();
+  vehicle_snapshot_pub_.publish(vehicle_snapshot_msg_);
+}
+
+void J2735Convertor::traceConversion(const ConversionTraceStages& stages, const ros::Time& receive,
+                                     const ros::Time& convert_start, const ros::Time& convert_end)
+{
+  uint64_t published = ros::Time::now().toNSec();
+  latency_tracer_->record(stages.convert, convert_start.toNSec(), convert_end.toNSec());
+  latency_tracer_->record(stages.publish, convert_end.toNSec(), published);
+  if (stages.has_total && !receive.isZero())
+  {
+    latency_tracer_->record(stages.total, receive.toNSec(), published);
+  }
+}
+
+void J2735Convertor::diagnosticsTimerCallback(const ros::TimerEvent& event)
+{
+  pipeline_counters_.set_queue_depth(counter_types_.incoming_bsm, bsm_queue_.depth());
+  pipeline_counters_.set_queue_depth(counter_types_.outgoing_bsm, bsm_queue_.depth());
+  pipeline_counters_.set_queue_depth(counter_types_.incoming_spat, spat_queue_.depth());
+  pipeline_counters_.set_queue_depth(counter_types_.incoming_map, map_queue_.depth());
+  size_t geofence_depth = geofence_queue_.depth();
+  pipeline_counters_.set_queue_depth(counter_types_.incoming_geofence_control, geofence_depth);
+  pipeline_counters_.set_queue_depth(counter_types_.outgoing_geofence_control, geofence_depth);
+  pipeline_counters_.set_queue_depth(counter_types_.incoming_geofence_request, geofence_depth);
+  pipeline_counters_.set_queue_depth(counter_types_.outgoing_geofence_request, geofence_depth);
+
+  diagnostic_msgs::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = ros::Time::now();
+  double period = event.last_real.isZero() ? diagnostics_period_ : (event.current_real - event.last_real).toSec();
+  pipeline_counters_.report(ros::this_node::getName(), period, diagnostics.status);
+  // One line per message type and period instead of one per dropped frame
+  for (const diagnostic_msgs::DiagnosticStatus& status : diagnostics.status)
+  {
+    if (status.level == diagnostic_msgs::DiagnosticStatus::WARN)
+    {
+      ROS_WARN_STREAM(status.name << ": " << status.message);
+    }
+  }
+  if (latency_tracer_)
+  {
+    latency_tracer_->report(ros::this_node::getName(), diagnostics.status);
+  }
+  diagnostics_pub_.publish(diagnostics);
+}
+
+bool J2735Convertor::metricsCallback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp)
+{
+  std::ostringstream metrics;
+  pipeline_counters_.write_metrics(ros::this_node::getName(), metrics);
+  resp.success = true;
+  resp.message = metrics.str();
+  return true;
+}
+
+bool J2735Convertor::exportLatencyTraceCallback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp)
+{
+  std::ofstream file(latency_trace_file_);
+  resp.success = file && latency_tracer_->write_chrome_trace(file);
+  resp.message = resp.success ? "Latency trace written to " + latency_trace_file_ :
+                                "Cannot write latency trace to " + latency_trace_file_;
+  return true;
+}
+
+void J2735Convertor::publishLaneMatch(const cav_msgs::BSM& message, ros::Publisher& pub)
+{
+  if (pub.getNumSubscribers() == 0)
+  {
+    return;
+  }
+
+  std::shared_ptr<const LaneIndex> index;
+  {
+    std::lock_guard<std::mutex> lock(lane_index_mutex_);
+    index = lane_index_;
+  }
+
+  BSMLaneMatch lane_match;
+  lane_match.bsm = message;
+  const cav_msgs::BSMCoreData& core_data = message.core_data;
+  double x, y;
+  LaneMatch match;
+  if (index && (core_data.presence_vector & cav_msgs::BSMCoreData::LATITUDE_AVAILABLE) &&
+      (core_data.presence_vector & cav_msgs::BSMCoreData::LONGITUDE_AVAILABLE) &&
+      geometry_store_->toLocal(core_data.latitude, core_data.longitude, x, y) && index->match(x, y, match))
+  {
+    lane_match.matched = true;
+    lane_match.intersection_id = match.intersection_id;
+    lane_match.lane_id = match.lane_id;
+    lane_match.downtrack = match.downtrack;
+    lane_match.crosstrack = match.crosstrack;
+  }
+  pub.publish(lane_match);
 }
 
 void J2735Convertor::j2735SpatHandler(const j2735_msgs::SPATConstPtr& message)
 {
-  cav_msgs::SPAT converted_msg;
-  SPATConvertor::convert(*message, converted_msg);  // Convert message
-  converted_spat_pub_.publish(converted_msg);       // Publish converted message
+  // Convert message into the reused outputs
+  countIncoming(counter_types_.incoming_spat, *message);
+  ros::Time convert_start = latency_tracer_ ? ros::Time::now() : ros::Time();
+  bool has_delta = spat_delta_convertor_->convert(*message, ros::Time::now(), converted_spat_msg_,
+                                                  converted_spat_delta_msg_);
+  ros::Time convert_end = latency_tracer_ ? ros::Time::now() : ros::Time();
+  converted_spat_pub_.publish(converted_spat_msg_);  // Publish converted message
+  pipeline_counters_.add(counter_types_.incoming_spat, cpp_message::Pipeline_Counter::FRAMES_OUT);
+  if (latency_tracer_)
+  {
+    traceConversion(spat_trace_stages_, ros::Time(), convert_start, convert_end);
+  }
+  if (has_delta)
+  {
+    converted_spat_delta_pub_.publish(converted_spat_delta_msg_);  // Publish changed movement states
+  }
+  if (spat_demux_)
+  {
+    spat_demux_->publishSpat(converted_spat_msg_);
+  }
+  signal_group_index_->updateSpat(converted_spat_msg_);
+  publishLaneSignalStates(converted_spat_msg_);
+}
+
+void J2735Convertor::publishLaneSignalStates(const cav_msgs::SPAT& message)
+{
+  if (lane_signal_state_pub_.getNumSubscribers() == 0)
+  {
+    return;
+  }
+
+  size_t count = 0;
+  auto& lane_states = lane_signal_state_msg_.lane_signal_state_list;
+  for (const cav_msgs::IntersectionState& state : message.intersection_state_list)
+  {
+    for (const LaneConnection& connection : signal_group_index_->getConnections(state.id.id))
+    {
+      if (lane_states.size() <= count)
+      {
+        lane_states.resize(count + 1);
+      }
+      LaneSignalState& lane_state = lane_states[count++];
+      lane_state.intersection_id = state.id.id;
+      lane_state.lane_id = connection.lane_id;
+      lane_state.connecting_lane_id = connection.connecting_lane_id;
+      lane_state.maneuvers = connection.maneuvers;
+      lane_state.signal_group = connection.signal_group;
+      lane_state.movement_state_exists =
+          signal_group_index_->getMovementState(state.id.id, connection.signal_group, lane_state.movement_state);
+    }
+  }
+  lane_states.resize(count);
+  lane_signal_state_pub_.publish(lane_signal_state_msg_);
 }
 
 void J2735Convertor::j2735MapHandler(const j2735_msgs::MapDataConstPtr& message)
 {
-  cav_msgs::MapData converted_msg;
-  MapConvertor::convert(*message, converted_msg);  // Convert message
-  converted_map_pub_.publish(converted_msg);       // Publish converted message
+  countIncoming(counter_types_.incoming_map, *message);
+  MapConvertor::convert(*message, converted_map_msg_);  // Convert message into the reused output
+  converted_map_pub_.publish(converted_map_msg_);       // Publish converted message
+  pipeline_counters_.add(counter_types_.incoming_map, cpp_message::Pipeline_Counter::FRAMES_OUT);
+  if (geometry_store_->update(converted_map_msg_))      // Only new intersection revisions are recomputed
+  {
+    std::vector<std::shared_ptr<const IntersectionGeometry>> intersections = geometry_store_->getIntersections();
+    std::shared_ptr<const LaneIndex> index(new LaneIndex(intersections));
+    {
+      std::lock_guard<std::mutex> lock(lane_index_mutex_);
+      lane_index_ = index;
+    }
+    publishIntersectionGeometry(intersections);
+  }
+  signal_group_index_->updateMap(converted_map_msg_);
+  if (map_demux_)
+  {
+    map_demux_->publishMap(converted_map_msg_);
+  }
+}
+
+void J2735Convertor::publishIntersectionGeometry(
+    const std::vector<std::shared_ptr<const IntersectionGeometry>>& intersections)
+{
+  LaneGeometryList msg;
+  geometry_store_->getOrigin(msg.origin_latitude, msg.origin_longitude);
+  msg.version = geometry_store_->version();
+  msg.intersections.resize(intersections.size());
+  for (size_t i = 0; i < intersections.size(); i++)
+  {
+    const IntersectionGeometry& geometry = *intersections[i];
+    LaneGeometry& out = msg.intersections[i];
+    out.id = geometry.id;
+    out.revision = geometry.revision;
+    out.ref_x = geometry.ref_x;
+    out.ref_y = geometry.ref_y;
+    out.lane_ids = geometry.lane_ids;
+    out.lane_offsets = geometry.lane_offsets;
+    out.x = geometry.x;
+    out.y = geometry.y;
+    out.width = geometry.width;
+  }
+  intersection_geometry_pub_.publish(msg);
 }
 
 void J2735Convertor::ControlMessageHandler(const cav_msgs::TrafficControlMessageConstPtr& message) {
+  countIncoming(counter_types_.outgoing_geofence_control, *message);
   j2735_msgs::TrafficControlMessage converted_msg;
   j2735_convertor::geofence_control::convert(*message, converted_msg);  // Convert message
   outbound_j2735_geofence_control_pub_.publish(converted_msg);       // Publish converted message
+  pipeline_counters_.add(counter_types_.outgoing_geofence_control, cpp_message::Pipeline_Counter::FRAMES_OUT);
+  if (message->choice == cav_msgs::TrafficControlMessage::TCMV01)
+  {
+    storeGeofence(message->tcmV01);
+  }
 }
 
 void J2735Convertor::j2735ControlMessageHandler(const j2735_msgs::TrafficControlMessageConstPtr& message) {
+  countIncoming(counter_types_.incoming_geofence_control, *message);
   cav_msgs::TrafficControlMessage converted_msg;
   j2735_convertor::geofence_control::convert(*message, converted_msg);  // Convert message
-  converted_geofence_control_pub_.publish(converted_msg);       // Publish converted message
+  if (converted_msg.choice != cav_msgs::TrafficControlMessage::TCMV01)
+  {
+    converted_geofence_control_pub_.publish(converted_msg);
+    pipeline_counters_.add(counter_types_.incoming_geofence_control, cpp_message::Pipeline_Counter::FRAMES_OUT);
+    return;
+  }
+
+  // Responses already published on cached_geofence_control when the request was sent are not published again
+  if (!isCachedResponse(converted_msg.tcmV01))
+  {
+    converted_geofence_control_pub_.publish(converted_msg);       // Publish converted message
+    pipeline_counters_.add(counter_types_.incoming_geofence_control, cpp_message::Pipeline_Counter::FRAMES_OUT);
+    storeGeofence(converted_msg.tcmV01);
+  }
+  // Saved once the geofences of the completed request are in the cache
+  if (geofence_coverage_ && geofence_coverage_->addResponse(converted_msg.tcmV01))
+  {
+    geofence_cache_->saveCoverage(geofence_coverage_->getAreas());
+  }
+}
+
+bool J2735Convertor::isCachedResponse(const cav_msgs::TrafficControlMessageV01& geofence) const
+{
+  std::string reqid(geofence.reqid.id.begin(), geofence.reqid.id.end());
+  return std::find(cache_answered_requests_.begin(), cache_answered_requests_.end(), reqid) !=
+             cache_answered_requests_.end() &&
+         geofence_store_->holds(geofence);
 }
 
 void J2735Convertor::ControlRequestHandler(const cav_msgs::TrafficControlRequestConstPtr& message) {
+  countIncoming(counter_types_.outgoing_geofence_request, *message);
   j2735_msgs::TrafficControlRequest converted_msg;
-  j2735_convertor::geofence_request::convert(*message, converted_msg);  // Convert message
+  if (!geofence_cache_ || message->choice != cav_msgs::TrafficControlRequest::TCRV01)
+  {
+    j2735_convertor::geofence_request::convert(*message, converted_msg);  // Convert message
+  }
+  else
+  {
+    // Answer from the cache right away, then only ask the radio for what the cache may miss. Bounds outside the
+    // covered areas go out unchanged. Responses repeating cached versions are dropped when they come back.
+    publishControlResponses(message->tcrV01, cached_geofence_control_pub_, false);
+    cache_answered_requests_.emplace_back(message->tcrV01.reqid.id.begin(), message->tcrV01.reqid.id.end());
+    if (cache_answered_requests_.size() > MAX_CACHE_ANSWERED_REQUESTS)
+    {
+      cache_answered_requests_.pop_front();
+    }
+    cav_msgs::TrafficControlRequest narrowed_msg = *message;
+    size_t narrowed = geofence_coverage_->trackRequest(narrowed_msg.tcrV01, ros::Time::now());
+    ROS_DEBUG_STREAM("Narrowed " << narrowed << " of " << narrowed_msg.tcrV01.bounds.size()
+                                 << " geofence request bounds to the geofences missing from the cache");
+    j2735_convertor::geofence_request::convert(narrowed_msg, converted_msg);
+  }
   outbound_j2735_geofence_request_pub_.publish(converted_msg);       // Publish converted message
+  pipeline_counters_.add(counter_types_.outgoing_geofence_request, cpp_message::Pipeline_Counter::FRAMES_OUT);
 }
 
 void J2735Convertor::j2735ControlRequestHandler(const j2735_msgs::TrafficControlRequestConstPtr& message) {
+  countIncoming(counter_types_.incoming_geofence_request, *message);
   cav_msgs::TrafficControlRequest converted_msg;
   j2735_convertor::geofence_request::convert(*message, converted_msg);  // Convert message
   converted_geofence_request_pub_.publish(converted_msg);       // Publish converted message
+  pipeline_counters_.add(counter_types_.incoming_geofence_request, cpp_message::Pipeline_Counter::FRAMES_OUT);
+  if (respond_to_geofence_requests_ && converted_msg.choice == cav_msgs::TrafficControlRequest::TCRV01)
+  {
+    publishControlResponses(converted_msg.tcrV01, outbound_j2735_geofence_control_pub_, true);
+  }
+}
+
+void J2735Convertor::storeGeofence(const cav_msgs::TrafficControlMessageV01& geofence)
+{
+  if (!geofence_store_->add(geofence))
+  {
+    return;
+  }
+  geofence_scheduler_->update(geofence, ros::Time::now(), schedule_events_);
+  publishScheduleEvents();
+  publishGeofencePolygon(geofence);
+  if (!geofence_cache_)
+  {
+    return;
+  }
+  geofence_cache_->append(geofence);
+  if (geofence_cache_->needsCompaction(geofence_store_->size()))
+  {
+    geofence_cache_->compact(geofence_store_->getGeofences());
+  }
+}
+
+void J2735Convertor::geofenceScheduleTimerCallback(const ros::TimerEvent& event)
+{
+  geofence_scheduler_->advance(ros::Time::now(), schedule_events_);
+  publishScheduleEvents();
+}
+
+void J2735Convertor::publishGeofencePolygon(const cav_msgs::TrafficControlMessageV01& geofence)
+{
+  std::shared_ptr<const GeofencePolygon> previous = geofence_compiler_->lookup(geofence.id);
+  std::shared_ptr<const GeofencePolygon> polygon = geofence_compiler_->compile(geofence);
+  if (!polygon || polygon == previous)
+  {
+    return;  // Rebroadcast of a published version
+  }
+
+  TrafficControlPolygon msg;
+  msg.id = polygon->id;
+  msg.updated = polygon->updated;
+  msg.origin_latitude = polygon->origin_latitude;
+  msg.origin_longitude = polygon->origin_longitude;
+  msg.x = polygon->x;
+  msg.y = polygon->y;
+  msg.width = polygon->width;
+  msg.boundary_x = polygon->boundary_x;
+  msg.boundary_y = polygon->boundary_y;
+  geofence_polygon_pub_.publish(msg);
+}
+
+void J2735Convertor::publishScheduleEvents()
+{
+  for (const ScheduleEvent& event : schedule_events_)
+  {
+    TrafficControlActivation activation;
+    activation.id = event.id;
+    activation.active = event.active;
+    activation.stamp = event.stamp;
+    geofence_activation_pub_.publish(activation);
+  }
+  schedule_events_.clear();
+}
+
+void J2735Convertor::publishControlResponses(const cav_msgs::TrafficControlRequestV01& request, ros::Publisher& pub,
+                                             bool j2735)
+{
+  // Expired geofences are not answered and their polygons are not needed anymore
+  for (const j2735_msgs::Id128b& id : geofence_store_->removeExpired(ros::Time::now()))
+  {
+    geofence_compiler_->remove(id);
+  }
+  std::vector<GeofenceStore::GeofencePtr> geofences = geofence_store_->query(request);
+
+  cav_msgs::TrafficControlMessage response;
+  response.choice = cav_msgs::TrafficControlMessage::TCMV01;
+  for (size_t i = 0; i < geofences.size(); i++)
+  {
+    response.tcmV01 = *geofences[i];
+    response.tcmV01.reqid = request.reqid;
+    response.tcmV01.reqseq = request.reqseq;
+    response.tcmV01.msgtot = geofences.size();
+    response.tcmV01.msgnum = i + 1;
+    if (j2735)
+    {
+      j2735_msgs::TrafficControlMessage converted_msg;
+      j2735_convertor::geofence_control::convert(response, converted_msg);
+      pub.publish(converted_msg);
+    }
+    else
+    {
+      pub.publish(response);
+    }
+  }
+  ROS_DEBUG_STREAM("Answered geofence request with " << geofences.size() << " of " << geofence_store_->size()
+                                                     << " stored geofences");
 }
 
 }  // namespace j2735_convertor
@@ -15,15 +15,21 @@
  * the License.
  */
 
+#include <deque>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include <ros/ros.h>
 #include <ros/callback_queue.h>
+#include <ros/serialization.h>
 #include <j2735_msgs/BSM.h>
 #include <j2735_msgs/SPAT.h>
 #include <j2735_msgs/MapData.h>
 #include <j2735_msgs/TrafficControlMessage.h>
 #include <j2735_msgs/TrafficControlRequest.h>
 #include <cav_msgs/SystemAlert.h>
+#include <cav_msgs/MobilityOperation.h>
+#include <cav_msgs/MobilityPath.h>
 #include <cav_msgs/BSM.h>
 #include <cav_msgs/SPAT.h>
 #include <cav_msgs/MapData.h>
@@ -33,7 +39,29 @@
 #include <j2735_convertor/bsm_convertor.h>
 #include <j2735_convertor/map_convertor.h>
 #include <j2735_convertor/spat_convertor.h>
+#include <j2735_convertor/spat_delta_convertor.h>
+#include <j2735_convertor/intersection_demux.h>
+#include <j2735_convertor/intersection_geometry_store.h>
+#include <j2735_convertor/lane_index.h>
+#include <j2735_convertor/signal_group_index.h>
+#include <j2735_convertor/geofence_store.h>
+#include <j2735_convertor/geofence_cache.h>
+#include <j2735_convertor/geofence_coverage.h>
+#include <j2735_convertor/geofence_scheduler.h>
+#include <j2735_convertor/geofence_compiler.h>
+#include <j2735_convertor/vehicle_tracker.h>
+#include <j2735_convertor/measured_callback_queue.h>
+#include <j2735_convertor/BSMLaneMatch.h>
+#include <j2735_convertor/LaneSignalStateList.h>
+#include <j2735_convertor/LaneGeometryList.h>
+#include <j2735_convertor/TrafficControlActivation.h>
+#include <j2735_convertor/TrafficControlPolygon.h>
+#include <j2735_convertor/RemoteVehicleSnapshot.h>
 #include <carma_utils/CARMANodeHandle.h>
+#include <std_srvs/Trigger.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <Latency_Tracer.h>
+#include <Pipeline_Counters.h>
 
 namespace j2735_convertor
 {
@@ -49,6 +77,39 @@ namespace j2735_convertor
  *
  * Other subscribed topics like system_alert are handled on the default global queue
  *
+ * Converted SPAT and MAP messages are additionally split by intersection id onto incoming_spat/intersection_<id> and
+ * incoming_map/intersection_<id>, so consumers can subscribe only to the intersections they use
+ *
+ * The absolute lane polylines of the IntersectionGeometryStore are published latched on intersection_geometry whenever a
+ * new intersection revision is received
+ *
+ * Received and outgoing BSMs are matched against the lanes of the received MAP messages and published with the matched
+ * lane on incoming_bsm_lane_match and outgoing_bsm_lane_match
+ *
+ * The signal state of every signalized MAP lane connection is published on incoming_lane_signal_state for each SPAT
+ *
+ * Received and sent traffic control messages are kept in a GeofenceStore. When respond_to_geofence_requests is set
+ * the node answers incoming traffic control requests with the stored geofences within the requested bounds.
+ *
+ * When geofence_cache_path is set the stored geofences are persisted and restored at startup. Outgoing traffic control
+ * requests are then answered from the cache first on cached_geofence_control and sent to the radio narrowed to what the
+ * cache may miss: bounds within an area covered by an earlier completed request only ask for geofences updated since,
+ * see GeofenceCoverage. Responses from the radio repeating a cached version are not published again on
+ * incoming_geofence_control.
+ *
+ * The schedules of the stored geofences are tracked by a GeofenceScheduler and every activation or deactivation is
+ * published on geofence_activation
+ *
+ * Each new version of a stored geofence is compiled into a boundary polygon in the frame of the MAP lane geometry and
+ * published on geofence_polygon. Lanes and polygons share one LocalFrame whose origin is geometry_origin_lat and
+ * geometry_origin_lon if both are set, otherwise the reference point of the first MAP intersection or geofence.
+ *
+ * Received BSMs are tracked per vehicle in a VehicleTracker, correlated with the static ids of incoming mobility
+ * operations and paths, and the latest state of every vehicle is published as one snapshot on remote_vehicles at
+ * vehicle_snapshot_rate. Consumers needing all nearby vehicles can subscribe to it instead of every BSM. The mobility
+ * operations and paths are only subscribed while remote_vehicles has subscribers, as cpp_message decodes every
+ * mobility message that has a subscriber.
+ *
  * When an internal exception is triggered the node will first broadcast a FATAL message to the system_alert topic
  * before shutting itself down. This node will also shut itself down on recieve of a SHUTDOWN message from system_alert
  */
@@ -60,20 +121,108 @@ private:
   bool shutting_down_ = false;
   // Members used in ROS behavior
   int default_spin_rate_ = 10;
-  ros::Publisher converted_bsm_pub_, converted_spat_pub_, converted_map_pub_,
+  int spat_keyframe_interval_ = 10;
+  ros::Publisher converted_bsm_pub_, converted_spat_pub_, converted_spat_delta_pub_, converted_map_pub_,
       outbound_j2735_bsm_pub_, outbound_j2735_geofence_control_pub_, outbound_j2735_geofence_request_pub_, 
       converted_geofence_control_pub_, converted_geofence_request_pub_;
   ros::Subscriber j2735_bsm_sub_, j2735_spat_sub_, j2735_map_sub_, outbound_bsm_sub_,
       j2735_geofence_control_sub_, j2735_geofence_request_sub_, outbound_geofence_control_sub_, outbound_geofence_request_sub_;
   std::shared_ptr<ros::CARMANodeHandle> default_nh_;
+  std::shared_ptr<ros::CARMANodeHandle> pnh_;
   std::shared_ptr<ros::CARMANodeHandle> bsm_nh_;
   std::shared_ptr<ros::CARMANodeHandle> spat_nh_;
   std::shared_ptr<ros::CARMANodeHandle> map_nh_;
   std::shared_ptr<ros::CARMANodeHandle> geofence_nh_;
-  ros::CallbackQueue bsm_queue_;
-  ros::CallbackQueue spat_queue_;
-  ros::CallbackQueue map_queue_;
-  ros::CallbackQueue geofence_queue_;
+  MeasuredCallbackQueue bsm_queue_;
+  MeasuredCallbackQueue spat_queue_;
+  MeasuredCallbackQueue map_queue_;
+  MeasuredCallbackQueue geofence_queue_;
+
+  // Converted messages which are reused between callbacks so that nested lists keep their allocations.
+  // Each one is only accessed from the single spinner thread serving its callback queue.
+  cav_msgs::SPAT converted_spat_msg_;
+  cav_msgs::SPAT converted_spat_delta_msg_;
+  cav_msgs::MapData converted_map_msg_;
+
+  // Stateful SPAT conversion which tracks the last movement states of each intersection
+  std::shared_ptr<SPATDeltaConvertor> spat_delta_convertor_;
+
+  // Per intersection publishers, advertised when an intersection is first received. Null if demux_intersections is off
+  bool demux_intersections_ = true;
+  std::shared_ptr<IntersectionDemux<ros::Publisher>> spat_demux_;
+  std::shared_ptr<IntersectionDemux<ros::Publisher>> map_demux_;
+
+  // Absolute lane geometry of every received intersection, published latched on intersection_geometry for the
+  // consumers of the MAP
+  std::shared_ptr<IntersectionGeometryStore> geometry_store_;
+  ros::Publisher intersection_geometry_pub_;
+
+  // Lane index rebuilt on the map thread whenever the stored geometry changes and read on the bsm thread
+  std::mutex lane_index_mutex_;
+  std::shared_ptr<const LaneIndex> lane_index_;
+  ros::Publisher bsm_lane_match_pub_, ego_lane_match_pub_;
+
+  // Join of SPAT movement states onto MAP lane connections, updated from both the map and spat threads
+  std::shared_ptr<SignalGroupIndex> signal_group_index_;
+  ros::Publisher lane_signal_state_pub_;
+  LaneSignalStateList lane_signal_state_msg_;
+
+  // Received and sent geofences. Incoming requests are answered from it when respond_to_geofence_requests_ is set.
+  std::shared_ptr<GeofenceStore> geofence_store_;
+  bool respond_to_geofence_requests_ = false;
+
+  // Persistent copy of geofence_store_, only set if geofence_cache_path is provided
+  std::shared_ptr<GeofenceCache> geofence_cache_;
+  ros::Publisher cached_geofence_control_pub_;
+  // Ids of the latest outgoing requests answered from the cache
+  static constexpr size_t MAX_CACHE_ANSWERED_REQUESTS = 16;
+  std::deque<std::string> cache_answered_requests_;
+  // Areas the cache holds every geofence of, saved with the cache
+  std::shared_ptr<GeofenceCoverage> geofence_coverage_;
+
+  // Activation of the stored geofence schedules, advanced once per second on the geofence thread
+  std::shared_ptr<GeofenceScheduler> geofence_scheduler_;
+  std::vector<ScheduleEvent> schedule_events_;
+  ros::Timer geofence_schedule_timer_;
+  ros::Publisher geofence_activation_pub_;
+
+  // Boundary polygons of the stored geofences, published on geofence_polygon when a new version is compiled
+  std::shared_ptr<GeofenceCompiler> geofence_compiler_;
+  ros::Publisher geofence_polygon_pub_;
+
+  // Remote vehicles tracked from incoming BSMs. Fed, expired and published on the bsm thread only, where the
+  // connect callbacks of remote_vehicles run as well
+  std::shared_ptr<VehicleTracker> vehicle_tracker_;
+  ros::Subscriber mobility_operation_sub_, mobility_path_sub_;
+  ros::Timer vehicle_snapshot_timer_;
+  ros::Publisher vehicle_snapshot_pub_;
+  RemoteVehicleSnapshot vehicle_snapshot_msg_;
+
+  // Latency of incoming BSMs and SPATs through the conversion, only traced if latency_tracing is set
+  struct ConversionTraceStages
+  {
+    size_t convert, publish;
+    bool has_total;  // Set if the message carries the radio receive stamp of cpp_message in its header
+    size_t total;
+  };
+  std::shared_ptr<cpp_message::Latency_Tracer> latency_tracer_;
+  ConversionTraceStages bsm_trace_stages_, spat_trace_stages_;
+  std::string latency_trace_file_;
+  ros::ServiceServer export_latency_trace_service_;
+
+  // Frames of each message type converted by this node, reported on /diagnostics with the latency histograms.
+  // Outgoing types count the frames converted to J2735 for the radio.
+  struct CounterTypes
+  {
+    size_t incoming_bsm, outgoing_bsm, incoming_spat, incoming_map, incoming_geofence_control, outgoing_geofence_control,
+        incoming_geofence_request, outgoing_geofence_request;
+  };
+  cpp_message::Pipeline_Counters pipeline_counters_;
+  CounterTypes counter_types_;
+  double diagnostics_period_ = 1.0;
+  ros::Publisher diagnostics_pub_;
+  ros::Timer diagnostics_timer_;
+  ros::ServiceServer metrics_service_;
 
 public:
   /**
@@ -111,9 +260,86 @@ private:
    */
   void j2735BsmHandler(const j2735_msgs::BSMConstPtr& message);
 
+  /**
+   * @brief Correlates the sender of an incoming mobility message with its tracked BSMs
+   */
+  void mobilityOperationHandler(const cav_msgs::MobilityOperationConstPtr& message);
+  void mobilityPathHandler(const cav_msgs::MobilityPathConstPtr& message);
+
+  /**
+   * @brief Subscribe to the mobility messages for the first snapshot subscriber, unsubscribe after the last one
+   */
+  void vehicleSnapshotConnectCallback(const ros::SingleSubscriberPublisher& pub);
+  void vehicleSnapshotDisconnectCallback(const ros::SingleSubscriberPublisher& pub);
+
+  /**
+   * @brief Timer callback which expires the tracked vehicles and publishes a snapshot of the remaining ones
+   */
+  void vehicleSnapshotTimerCallback(const ros::TimerEvent& event);
+
+  /**
+   * @brief Timer callback which only expires the tracked vehicles, used if vehicle_snapshot_rate is not positive
+   */
+  void vehicleExpiryTimerCallback(const ros::TimerEvent& event);
+
+  /**
+   * @brief Records the conversion of an incoming message once it is published
+   *
+   * @param stages The stages of the message type
+   * @param receive The radio receive stamp of the message, zero if unknown
+   * @param convert_start Start of the conversion
+   * @param convert_end End of the conversion and start of the publication
+   */
+  void traceConversion(const ConversionTraceStages& stages, const ros::Time& receive, const ros::Time& convert_start,
+                       const ros::Time& convert_end);
+
+  /**
+   * @brief Counts a message to convert and its serialized size
+   */
+  template <class M>
+  void countIncoming(size_t type, const M& message)
+  {
+    pipeline_counters_.add(type, cpp_message::Pipeline_Counter::FRAMES_IN);
+    pipeline_counters_.add(type, cpp_message::Pipeline_Counter::BYTES_IN, ros::serialization::serializationLength(message));
+  }
+
+  /**
+   * @brief Timer callback which publishes the frame counters, callback queue depths and conversion latency histograms
+   * on /diagnostics. Message types with new drops are logged as one warning per type and period.
+   */
+  void diagnosticsTimerCallback(const ros::TimerEvent& event);
+
+  /**
+   * @brief Returns the frame counters in the Prometheus text format as the response message
+   */
+  bool metricsCallback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp);
+
+  /**
+   * @brief Writes the latest traced stages to latency_trace_file in the Chrome trace format
+   */
+  bool exportLatencyTraceCallback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp);
+
+  /**
+   * @brief Matches the position of a converted BSM to a MAP lane and publishes the result
+   *
+   * @param message The converted BSM
+   * @param pub The publisher of the BSMLaneMatch. Nothing is done if it has no subscribers
+   */
+  void publishLaneMatch(const cav_msgs::BSM& message, ros::Publisher& pub);
+
+  /**
+   * @brief Publishes the signal state of every signalized lane connection of the intersections in a converted SPAT
+   *
+   * @param message The converted SPAT. Nothing is done if incoming_lane_signal_state has no subscribers
+   */
+  void publishLaneSignalStates(const cav_msgs::SPAT& message);
+
   /**
    * @brief Converts j2735_msgs::SPAT messages to cav_msgs::SPAT and publishes the converted messages
    *
+   * The full SPAT is published on incoming_spat. The intersections and movement states which changed since the last
+   * SPAT are published on incoming_spat_delta, with a periodic keyframe carrying the full intersection state.
+   *
    * @param message The message to convert
    */
   void j2735SpatHandler(const j2735_msgs::SPATConstPtr& message);
@@ -125,6 +351,11 @@ private:
    */
   void j2735MapHandler(const j2735_msgs::MapDataConstPtr& message);
 
+  /**
+   * @brief Publishes the lane geometry of every stored intersection on intersection_geometry
+   */
+  void publishIntersectionGeometry(const std::vector<std::shared_ptr<const IntersectionGeometry>>& intersections);
+
   /**
    * @brief Converts cav_msgs::TrafficControlMessage messages to j2735_msgs::TrafficControlMessage and publishes the converted messages
    *
@@ -152,6 +383,40 @@ private:
    * @param message The message to convert
    */
   void j2735ControlRequestHandler(const j2735_msgs::TrafficControlRequestConstPtr& message);
+
+  /**
+   * @brief Adds a geofence to the store. If the store accepted it the geofence is scheduled, compiled and appended to the cache
+   */
+  void storeGeofence(const cav_msgs::TrafficControlMessageV01& geofence);
+
+  /**
+   * @brief Returns true if the geofence responds to a request answered from the cache and its version is stored
+   */
+  bool isCachedResponse(const cav_msgs::TrafficControlMessageV01& geofence) const;
+
+  /**
+   * @brief Timer callback which advances the geofence schedules and publishes their transitions
+   */
+  void geofenceScheduleTimerCallback(const ros::TimerEvent& event);
+
+  /**
+   * @brief Publishes and clears the pending schedule events
+   */
+  void publishScheduleEvents();
+
+  /**
+   * @brief Publishes the polygon of a geofence if this version of it was not compiled before
+   */
+  void publishGeofencePolygon(const cav_msgs::TrafficControlMessageV01& geofence);
+
+  /**
+   * @brief Publishes the stored geofences within the bounds of a traffic control request as a response to it
+   *
+   * @param request The converted request
+   * @param pub The publisher of the responses
+   * @param j2735 True if pub publishes j2735_msgs::TrafficControlMessage, false for cav_msgs::TrafficControlMessage
+   */
+  void publishControlResponses(const cav_msgs::TrafficControlRequestV01& request, ros::Publisher& pub, bool j2735);
 };
 
 }  // namespace j2735_convertor
\ No newline at end of file
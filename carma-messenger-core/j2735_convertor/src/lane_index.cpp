@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <j2735_convertor/lane_index.h>
+
+/**
+ * CPP File containing LaneIndex method definitions
+ */
+
+namespace j2735_convertor
+{
+LaneIndex::LaneIndex(const std::vector<std::shared_ptr<const IntersectionGeometry>>& intersections)
+  : intersections_(intersections)
+{
+  std::vector<PackedRTree::Box> boxes;
+  for (size_t i = 0; i < intersections_.size(); i++)
+  {
+    const IntersectionGeometry& geometry = *intersections_[i];
+    for (size_t lane = 0; lane < geometry.laneCount(); lane++)
+    {
+      double downtrack = 0.0;
+      for (size_t p = geometry.lane_offsets[lane]; p + 1 < geometry.lane_offsets[lane + 1]; p++)
+      {
+        double half_width = std::max(geometry.width[p], geometry.width[p + 1]) / 2.0;
+        PackedRTree::Box box;
+        box.min_x = std::min(geometry.x[p], geometry.x[p + 1]) - half_width;
+        box.max_x = std::max(geometry.x[p], geometry.x[p + 1]) + half_width;
+        box.min_y = std::min(geometry.y[p], geometry.y[p + 1]) - half_width;
+        box.max_y = std::max(geometry.y[p], geometry.y[p + 1]) + half_width;
+        boxes.push_back(box);
+
+        Segment segment;
+        segment.intersection = i;
+        segment.lane = lane;
+        segment.point = p;
+        segment.downtrack = downtrack;
+        segments_.push_back(segment);
+        downtrack += std::hypot(geometry.x[p + 1] - geometry.x[p], geometry.y[p + 1] - geometry.y[p]);
+      }
+    }
+  }
+  tree_ = PackedRTree(boxes);
+}
+
+bool LaneIndex::match(double x, double y, LaneMatch& match) const
+{
+  double best_distance = std::numeric_limits<double>::max();
+  PackedRTree::Box position = { x, y, x, y };
+
+  tree_.query(position, [&](uint32_t s) {
+    // Closest point on the segment
+    const Segment& segment = segments_[s];
+    const IntersectionGeometry& geometry = *intersections_[segment.intersection];
+    size_t p = segment.point;
+    double dx = geometry.x[p + 1] - geometry.x[p];
+    double dy = geometry.y[p + 1] - geometry.y[p];
+    double length_sq = dx * dx + dy * dy;
+    double t = 0.0;
+    if (length_sq > 0.0)
+    {
+      t = std::min(1.0, std::max(0.0, ((x - geometry.x[p]) * dx + (y - geometry.y[p]) * dy) / length_sq));
+    }
+    double distance = std::hypot(x - (geometry.x[p] + t * dx), y - (geometry.y[p] + t * dy));
+    double half_width = (geometry.width[p] + t * (geometry.width[p + 1] - geometry.width[p])) / 2.0;
+
+    if (distance > half_width || distance >= best_distance)
+    {
+      return;
+    }
+
+    best_distance = distance;
+    double side = dx * (y - geometry.y[p]) - dy * (x - geometry.x[p]);  // Positive when left of the segment
+    match.intersection_id = geometry.id;
+    match.lane_id = geometry.lane_ids[segment.lane];
+    match.downtrack = segment.downtrack + t * std::sqrt(length_sq);
+    match.crosstrack = side < 0.0 ? -distance : distance;
+  });
+
+  return best_distance != std::numeric_limits<double>::max();
+}
+
+}  // namespace j2735_convertor
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <j2735_convertor/local_frame.h>
+
+/**
+ * CPP File containing LocalFrame method definitions
+ */
+
+namespace j2735_convertor
+{
+namespace
+{
+constexpr double EARTH_RADIUS_M = 6378137.0;
+constexpr double DEG_TO_RAD = M_PI / 180.0;
+constexpr double METERS_PER_DEG_LAT = EARTH_RADIUS_M * DEG_TO_RAD;
+}  // namespace
+
+bool LocalFrame::setOrigin(double latitude, double longitude)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (origin_set_)
+  {
+    return false;
+  }
+  origin_set_ = true;
+  origin_latitude_ = latitude;
+  origin_longitude_ = longitude;
+  meters_per_deg_lon_ = METERS_PER_DEG_LAT * cos(latitude * DEG_TO_RAD);
+  return true;
+}
+
+bool LocalFrame::getOrigin(double& latitude, double& longitude) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  latitude = origin_latitude_;
+  longitude = origin_longitude_;
+  return origin_set_;
+}
+
+bool LocalFrame::toLocal(double latitude, double longitude, double& x, double& y) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!origin_set_)
+  {
+    return false;
+  }
+  x = (longitude - origin_longitude_) * meters_per_deg_lon_;
+  y = (latitude - origin_latitude_) * METERS_PER_DEG_LAT;
+  return true;
+}
+
+}  // namespace j2735_convertor
@@ -58,6 +58,11 @@ void MapConvertor::convertNodeOffsetPointXY(const j2735_msgs::NodeOffsetPointXY&
                                             cav_msgs::NodeOffsetPointXY& out_msg)
 {
   out_msg.choice = in_msg.choice;
+  // Reset every branch of the choice so a reused output message does not keep stale values
+  out_msg.x = 0.0;
+  out_msg.y = 0.0;
+  out_msg.latitude = 0.0;
+  out_msg.longitude = 0.0;
   // Convert XY or Lat/Lon points based on choice field
   switch (in_msg.choice)
   {
@@ -97,6 +102,13 @@ void MapConvertor::convertLaneDataAttribute(const j2735_msgs::LaneDataAttribute&
                                             cav_msgs::LaneDataAttribute& out_msg)
 {
   out_msg.choice = in_msg.choice;
+  // Reset every branch of the choice so a reused output message does not keep stale values
+  out_msg.path_end_point_angle = 0;
+  out_msg.lane_crown_point_center = 0;
+  out_msg.lane_crown_point_left = 0;
+  out_msg.lane_crown_point_right = 0;
+  out_msg.lane_angle = 0;
+  out_msg.speed_limits.clear();
   // Convert Angles
   // Do comparison to avoid duplicate math
   switch (in_msg.choice)
@@ -118,11 +130,10 @@ void MapConvertor::convertLaneDataAttribute(const j2735_msgs::LaneDataAttribute&
       break;
     case j2735_msgs::LaneDataAttribute::SPEED_LIMITS:
       // Convert SpeedLimitsList
-      for (j2735_msgs::RegulatorySpeedLimit limit : in_msg.speed_limits.speed_limits)
+      out_msg.speed_limits.resize(in_msg.speed_limits.speed_limits.size());
+      for (size_t i = 0; i < in_msg.speed_limits.speed_limits.size(); i++)
       {
-        cav_msgs::RegulatorySpeedLimit cav_limit;
-        convertRegulatorySpeedLimit(limit, cav_limit);
-        out_msg.speed_limits.push_back(cav_limit);
+        convertRegulatorySpeedLimit(in_msg.speed_limits.speed_limits[i], out_msg.speed_limits[i]);
       }
       break;
   }
@@ -132,22 +143,14 @@ void MapConvertor::convertLaneDataAttribute(const j2735_msgs::LaneDataAttribute&
 void MapConvertor::convertNodeAttributeSetXY(const j2735_msgs::NodeAttributeSetXY& in_msg,
                                              cav_msgs::NodeAttributeSetXY& out_msg)
 {
-  for (j2735_msgs::NodeAttributeXY attribute : in_msg.local_node.node_attribute_xy_List)
-  {
-    out_msg.local_node.push_back(attribute);
-  }
+  out_msg.local_node.assign(in_msg.local_node.node_attribute_xy_List.begin(),
+                            in_msg.local_node.node_attribute_xy_List.end());
   out_msg.local_node_exists = in_msg.local_node_exists;
 
-  for (j2735_msgs::SegmentAttributeXY attribute : in_msg.disabled.segment_attribute_xy)
-  {
-    out_msg.disabled.push_back(attribute);
-  }
+  out_msg.disabled.assign(in_msg.disabled.segment_attribute_xy.begin(), in_msg.disabled.segment_attribute_xy.end());
   out_msg.disabled_exists = in_msg.disabled_exists;
 
-  for (j2735_msgs::SegmentAttributeXY attribute : in_msg.enabled.segment_attribute_xy)
-  {
-    out_msg.enabled.push_back(attribute);
-  }
+  out_msg.enabled.assign(in_msg.enabled.segment_attribute_xy.begin(), in_msg.enabled.segment_attribute_xy.end());
   out_msg.enabled_exists = in_msg.enabled_exists;
 
   out_msg.data_exists = in_msg.data_exists;
@@ -155,11 +158,10 @@ void MapConvertor::convertNodeAttributeSetXY(const j2735_msgs::NodeAttributeSetX
   out_msg.dElevation_exists = in_msg.dElevation_exists;
 
   // Convert LaneDataAttributeList
-  for (j2735_msgs::LaneDataAttribute attribute : in_msg.data.lane_attribute_list)
+  out_msg.lane_attribute_list.resize(in_msg.data.lane_attribute_list.size());
+  for (size_t i = 0; i < in_msg.data.lane_attribute_list.size(); i++)
   {
-    cav_msgs::LaneDataAttribute cav_attribute;
-    convertLaneDataAttribute(attribute, cav_attribute);
-    out_msg.lane_attribute_list.push_back(cav_attribute);
+    convertLaneDataAttribute(in_msg.data.lane_attribute_list[i], out_msg.lane_attribute_list[i]);
   }
   // Convert dWidth
   out_msg.dWitdh = (double)in_msg.dWitdh / units::CM_PER_M;
@@ -177,11 +179,10 @@ void MapConvertor::convertNodeXY(const j2735_msgs::NodeXY& in_msg, cav_msgs::Nod
 
 void MapConvertor::convertNodeSetXY(const j2735_msgs::NodeSetXY& in_msg, cav_msgs::NodeSetXY& out_msg)
 {
-  for (j2735_msgs::NodeXY node : in_msg.node_set_xy)
+  out_msg.node_set_xy.resize(in_msg.node_set_xy.size());
+  for (size_t i = 0; i < in_msg.node_set_xy.size(); i++)
   {
-    cav_msgs::NodeXY cav_node;
-    convertNodeXY(node, cav_node);
-    out_msg.node_set_xy.push_back(cav_node);
+    convertNodeXY(in_msg.node_set_xy[i], out_msg.node_set_xy[i]);
   }
 }
 
@@ -251,18 +252,16 @@ void MapConvertor::convertIntersectionGeometry(const j2735_msgs::IntersectionGeo
   // Convert LaneWidth
   out_msg.lane_width = (double)in_msg.lane_width / units::CM_PER_M;
   // Convert SpeedLimitsList
-  for (j2735_msgs::RegulatorySpeedLimit limit : in_msg.speed_limits.speed_limits)
+  out_msg.speed_limits.resize(in_msg.speed_limits.speed_limits.size());
+  for (size_t i = 0; i < in_msg.speed_limits.speed_limits.size(); i++)
   {
-    cav_msgs::RegulatorySpeedLimit cav_limit;
-    convertRegulatorySpeedLimit(limit, cav_limit);
-    out_msg.speed_limits.push_back(cav_limit);
+    convertRegulatorySpeedLimit(in_msg.speed_limits.speed_limits[i], out_msg.speed_limits[i]);
   }
   // Convert RoadLaneSet
-  for (j2735_msgs::GenericLane lane : in_msg.lane_set.lane_list)
+  out_msg.lane_list.resize(in_msg.lane_set.lane_list.size());
+  for (size_t i = 0; i < in_msg.lane_set.lane_list.size(); i++)
   {
-    cav_msgs::GenericLane cav_lane;
-    convertGenericLane(lane, cav_lane);
-    out_msg.lane_list.push_back(cav_lane);
+    convertGenericLane(in_msg.lane_set.lane_list[i], out_msg.lane_list[i]);
   }
   // Done Convertion
 
@@ -284,20 +283,18 @@ void MapConvertor::convertRoadSegment(const j2735_msgs::RoadSegment& in_msg, cav
   // Done Convertion
   out_msg.lane_width_exists = in_msg.lane_width_exists;
   // Convert SpeedLimitList
-  for (j2735_msgs::RegulatorySpeedLimit limit : in_msg.speed_limits.speed_limits)
+  out_msg.speed_limits.resize(in_msg.speed_limits.speed_limits.size());
+  for (size_t i = 0; i < in_msg.speed_limits.speed_limits.size(); i++)
   {
-    cav_msgs::RegulatorySpeedLimit cav_limit;
-    convertRegulatorySpeedLimit(limit, cav_limit);
-    out_msg.speed_limits.push_back(cav_limit);
+    convertRegulatorySpeedLimit(in_msg.speed_limits.speed_limits[i], out_msg.speed_limits[i]);
   }
   // Done Convertion
   out_msg.speed_limits_exists = in_msg.speed_limits_exists;
   // Convert RoadLaneSet
-  for (j2735_msgs::GenericLane lane : in_msg.road_lane_set.road_lane_set_list)
+  out_msg.road_lane_set_list.resize(in_msg.road_lane_set.road_lane_set_list.size());
+  for (size_t i = 0; i < in_msg.road_lane_set.road_lane_set_list.size(); i++)
   {
-    cav_msgs::GenericLane cav_lane;
-    convertGenericLane(lane, cav_lane);
-    out_msg.road_lane_set_list.push_back(cav_lane);
+    convertGenericLane(in_msg.road_lane_set.road_lane_set_list[i], out_msg.road_lane_set_list[i]);
   }
   // Done Convertion
 }
@@ -314,22 +311,20 @@ void MapConvertor::convert(const j2735_msgs::MapData& in_msg, cav_msgs::MapData&
   out_msg.intersections_exists = in_msg.intersections_exists;
 
   // Convert IntersectionGeometryList
-  for (j2735_msgs::IntersectionGeometry geometry : in_msg.intersections)
+  out_msg.intersections.resize(in_msg.intersections.size());
+  for (size_t i = 0; i < in_msg.intersections.size(); i++)
   {
-    cav_msgs::IntersectionGeometry cav_geometry;
-    convertIntersectionGeometry(geometry, cav_geometry);
-    out_msg.intersections.push_back(cav_geometry);
+    convertIntersectionGeometry(in_msg.intersections[i], out_msg.intersections[i]);
   }
   // Done Conversion
 
   out_msg.road_segments_exists = in_msg.road_segments_exists;
 
   // Convert RoadSegmentList
-  for (j2735_msgs::RoadSegment seg : in_msg.road_segments.road_segment_list)
+  out_msg.road_segment_list.resize(in_msg.road_segments.road_segment_list.size());
+  for (size_t i = 0; i < in_msg.road_segments.road_segment_list.size(); i++)
   {
-    cav_msgs::RoadSegment cav_seg;
-    convertRoadSegment(seg, cav_seg);
-    out_msg.road_segment_list.push_back(cav_seg);
+    convertRoadSegment(in_msg.road_segments.road_segment_list[i], out_msg.road_segment_list[i]);
   }
   // Done Conversion
 
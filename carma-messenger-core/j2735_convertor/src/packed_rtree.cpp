@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <j2735_convertor/packed_rtree.h>
+
+/**
+ * CPP File containing PackedRTree method definitions
+ */
+
+namespace j2735_convertor
+{
+constexpr size_t PackedRTree::NODE_CAPACITY;
+constexpr size_t PackedRTree::MAX_QUERY_STACK;
+
+namespace
+{
+template <typename T>
+bool lessCenterX(const T& a, const T& b)
+{
+  return a.box.min_x + a.box.max_x < b.box.min_x + b.box.max_x;
+}
+
+template <typename T>
+bool lessCenterY(const T& a, const T& b)
+{
+  return a.box.min_y + a.box.max_y < b.box.min_y + b.box.max_y;
+}
+}  // namespace
+
+template <typename T>
+void PackedRTree::pack(std::vector<T>& children, size_t begin, size_t end)
+{
+  // Sort-Tile-Recursive: split into vertical slices by x, then fill nodes along each slice by y
+  size_t count = end - begin;
+  size_t parent_count = (count + NODE_CAPACITY - 1) / NODE_CAPACITY;
+  size_t slice_size = static_cast<size_t>(std::ceil(std::sqrt(parent_count))) * NODE_CAPACITY;
+
+  std::sort(children.begin() + begin, children.begin() + end, lessCenterX<T>);
+  for (size_t i = begin; i < end; i += slice_size)
+  {
+    std::sort(children.begin() + i, children.begin() + std::min(i + slice_size, end), lessCenterY<T>);
+  }
+
+  for (size_t i = begin; i < end; i += NODE_CAPACITY)
+  {
+    Node node;
+    node.first = i;
+    node.count = std::min(NODE_CAPACITY, end - i);
+    node.box = children[i].box;
+    for (size_t j = i + 1; j < i + node.count; j++)
+    {
+      node.box.min_x = std::min(node.box.min_x, children[j].box.min_x);
+      node.box.min_y = std::min(node.box.min_y, children[j].box.min_y);
+      node.box.max_x = std::max(node.box.max_x, children[j].box.max_x);
+      node.box.max_y = std::max(node.box.max_y, children[j].box.max_y);
+    }
+    nodes_.push_back(node);  // children may be nodes_, so the node is complete before it is appended
+  }
+}
+
+PackedRTree::PackedRTree(const std::vector<Box>& boxes)
+{
+  if (boxes.empty())
+  {
+    return;
+  }
+
+  items_.resize(boxes.size());
+  for (size_t i = 0; i < boxes.size(); i++)
+  {
+    items_[i].box = boxes[i];
+    items_[i].index = i;
+  }
+
+  // Pack the items into leaves and then each level into its parents until only the root is left
+  pack(items_, 0, items_.size());
+  leaf_count_ = nodes_.size();
+  size_t begin = 0;
+  while (nodes_.size() - begin > 1)
+  {
+    size_t end = nodes_.size();
+    pack(nodes_, begin, end);
+    begin = end;
+  }
+}
+
+}  // namespace j2735_convertor
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <j2735_msgs/Connection.h>
+#include <j2735_convertor/signal_group_index.h>
+
+/**
+ * CPP File containing SignalGroupIndex method definitions
+ */
+
+namespace j2735_convertor
+{
+bool SignalGroupIndex::updateMap(const cav_msgs::MapData& map)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool changed = false;
+  for (const cav_msgs::IntersectionGeometry& geometry : map.intersections)
+  {
+    uint16_t id = geometry.id.id;
+    auto result = intersections_.emplace(id, IntersectionConnections());
+    IntersectionConnections& intersection = result.first->second;
+    if (!result.second && intersection.revision == geometry.revision)
+    {
+      continue;  // Revision already indexed
+    }
+
+    // Drop the lanes of the previous revision
+    for (const LaneConnection& connection : intersection.connections)
+    {
+      lanes_.erase(laneKey(id, connection.lane_id));
+    }
+    intersection.revision = geometry.revision;
+    intersection.connections.clear();
+
+    for (const cav_msgs::GenericLane& lane : geometry.lane_list)
+    {
+      uint32_t begin = intersection.connections.size();
+      for (const j2735_msgs::Connection& in_connection : lane.connect_to_list)
+      {
+        if (!in_connection.signal_group_exists)
+        {
+          continue;  // Unsignalized connections have no movement state
+        }
+        LaneConnection connection;
+        connection.lane_id = lane.lane_id;
+        connection.connecting_lane_id = in_connection.connecting_lane.lane;
+        connection.maneuvers =
+            in_connection.connecting_lane.maneuver_exists ? in_connection.connecting_lane.maneuver.maneuvers : 0;
+        connection.signal_group = in_connection.signal_group;
+        intersection.connections.push_back(connection);
+      }
+      if (intersection.connections.size() > begin)
+      {
+        lanes_.emplace(laneKey(id, lane.lane_id), std::make_pair(begin, intersection.connections.size()));
+      }
+    }
+    changed = true;
+  }
+  return changed;
+}
+
+void SignalGroupIndex::updateSpat(const cav_msgs::SPAT& spat)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const cav_msgs::IntersectionState& state : spat.intersection_state_list)
+  {
+    IntersectionSignals& signals = signals_[state.id.id];
+    for (const cav_msgs::MovementState& movement : signals.movements)
+    {
+      signals.slots[movement.signal_group] = -1;
+    }
+
+    signals.movements.resize(state.movement_list.size());
+    for (size_t i = 0; i < state.movement_list.size(); i++)
+    {
+      signals.movements[i] = state.movement_list[i];  // Assignment reuses the nested lists of the previous SPAT
+      signals.slots[state.movement_list[i].signal_group] = i;
+    }
+  }
+}
+
+const LaneConnection* SignalGroupIndex::findConnection(uint16_t intersection_id, uint8_t lane_id,
+                                                       uint16_t maneuver) const
+{
+  auto lane = lanes_.find(laneKey(intersection_id, lane_id));
+  if (lane == lanes_.end())
+  {
+    return nullptr;
+  }
+
+  const std::vector<LaneConnection>& connections = intersections_.at(intersection_id).connections;
+  for (uint32_t i = lane->second.first; i < lane->second.second; i++)
+  {
+    if ((connections[i].maneuvers & maneuver) == maneuver)
+    {
+      return &connections[i];
+    }
+  }
+  return nullptr;
+}
+
+const cav_msgs::MovementState* SignalGroupIndex::findMovement(uint16_t intersection_id, uint8_t signal_group) const
+{
+  auto signals = signals_.find(intersection_id);
+  if (signals == signals_.end() || signals->second.slots[signal_group] < 0)
+  {
+    return nullptr;
+  }
+  return &signals->second.movements[signals->second.slots[signal_group]];
+}
+
+bool SignalGroupIndex::getSignalGroup(uint16_t intersection_id, uint8_t lane_id, uint16_t maneuver,
+                                      uint8_t& signal_group) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const LaneConnection* connection = findConnection(intersection_id, lane_id, maneuver);
+  if (!connection)
+  {
+    return false;
+  }
+  signal_group = connection->signal_group;
+  return true;
+}
+
+bool SignalGroupIndex::getMovementState(uint16_t intersection_id, uint8_t signal_group,
+                                        cav_msgs::MovementState& state) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const cav_msgs::MovementState* movement = findMovement(intersection_id, signal_group);
+  if (!movement)
+  {
+    return false;
+  }
+  state = *movement;
+  return true;
+}
+
+bool SignalGroupIndex::getLaneMovementState(uint16_t intersection_id, uint8_t lane_id, uint16_t maneuver,
+                                            cav_msgs::MovementState& state) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const LaneConnection* connection = findConnection(intersection_id, lane_id, maneuver);
+  if (!connection)
+  {
+    return false;
+  }
+  const cav_msgs::MovementState* movement = findMovement(intersection_id, connection->signal_group);
+  if (!movement)
+  {
+    return false;
+  }
+  state = *movement;
+  return true;
+}
+
+std::vector<LaneConnection> SignalGroupIndex::getConnections(uint16_t intersection_id) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto intersection = intersections_.find(intersection_id);
+  if (intersection == intersections_.end())
+  {
+    return std::vector<LaneConnection>();
+  }
+  return intersection->second.connections;
+}
+
+}  // namespace j2735_convertor
@@ -64,11 +64,10 @@ void SPATConvertor::convertMovementEvent(const j2735_msgs::MovementEvent& in_msg
 
   out_msg.speeds_exists = in_msg.speeds_exists;
   // Convert AdvisorySpeedList
-  for (j2735_msgs::AdvisorySpeed speed : in_msg.speeds.advisory_speed_list)
+  out_msg.advisory_speed_list.resize(in_msg.speeds.advisory_speed_list.size());
+  for (size_t i = 0; i < in_msg.speeds.advisory_speed_list.size(); i++)
   {
-    cav_msgs::AdvisorySpeed cav_speed;
-    convertAdvisorySpeed(speed, cav_speed);
-    out_msg.advisory_speed_list.push_back(cav_speed);
+    convertAdvisorySpeed(in_msg.speeds.advisory_speed_list[i], out_msg.advisory_speed_list[i]);
   }
 }
 
@@ -78,19 +77,18 @@ void SPATConvertor::convertMovementState(const j2735_msgs::MovementState& in_msg
   out_msg.movement_name_exists = in_msg.movement_name_exists;
   out_msg.signal_group = in_msg.signal_group;
   // Convert MovementEvent
-  for (j2735_msgs::MovementEvent event : in_msg.state_time_speed.movement_event_list)
+  out_msg.movement_event_list.resize(in_msg.state_time_speed.movement_event_list.size());
+  for (size_t i = 0; i < in_msg.state_time_speed.movement_event_list.size(); i++)
   {
-    cav_msgs::MovementEvent cav_event;
-    convertMovementEvent(event, cav_event);
-    out_msg.movement_event_list.push_back(cav_event);
+    convertMovementEvent(in_msg.state_time_speed.movement_event_list[i], out_msg.movement_event_list[i]);
   }
   // Done Conversion
   out_msg.connection_maneuver_assist_list = in_msg.maneuver_assist_list.connection_maneuver_assist_list;
   out_msg.maneuver_assist_list_exists = in_msg.maneuver_assist_list_exists;
 }
 
-void SPATConvertor::convertIntersectionState(const j2735_msgs::IntersectionState& in_msg,
-                                             cav_msgs::IntersectionState& out_msg)
+void SPATConvertor::convertIntersectionStateHeader(const j2735_msgs::IntersectionState& in_msg,
+                                                   cav_msgs::IntersectionState& out_msg)
 {
   out_msg.name = in_msg.name;
   out_msg.name_exists = in_msg.name_exists;
@@ -105,18 +103,22 @@ void SPATConvertor::convertIntersectionState(const j2735_msgs::IntersectionState
   // Done conversion
   out_msg.lane_id_list = in_msg.enabled_lanes.lane_id_list;
   out_msg.enabled_lanes_exists = in_msg.enabled_lanes_exists;
+  out_msg.connection_maneuver_assist_list = in_msg.maneuever_assist_list.connection_maneuver_assist_list;
+  out_msg.maneuever_assist_list_exists = in_msg.maneuever_assist_list_exists;
+}
+
+void SPATConvertor::convertIntersectionState(const j2735_msgs::IntersectionState& in_msg,
+                                             cav_msgs::IntersectionState& out_msg)
+{
+  convertIntersectionStateHeader(in_msg, out_msg);
 
   // Convert MovementState
-  for (j2735_msgs::MovementState state : in_msg.states.movement_list)
+  out_msg.movement_list.resize(in_msg.states.movement_list.size());
+  for (size_t i = 0; i < in_msg.states.movement_list.size(); i++)
   {
-    cav_msgs::MovementState cav_state;
-    convertMovementState(state, cav_state);
-    out_msg.movement_list.push_back(cav_state);
+    convertMovementState(in_msg.states.movement_list[i], out_msg.movement_list[i]);
   }
   // Done Conversion
-
-  out_msg.connection_maneuver_assist_list = in_msg.maneuever_assist_list.connection_maneuver_assist_list;
-  out_msg.maneuever_assist_list_exists = in_msg.maneuever_assist_list_exists;
 }
 
 void SPATConvertor::convert(const j2735_msgs::SPAT& in_msg, cav_msgs::SPAT& out_msg)
@@ -127,11 +129,10 @@ void SPATConvertor::convert(const j2735_msgs::SPAT& in_msg, cav_msgs::SPAT& out_
   out_msg.name_exists = in_msg.name_exists;
 
   // Convert Intersection State List
-  for (j2735_msgs::IntersectionState state : in_msg.intersections.intersection_state_list)
+  out_msg.intersection_state_list.resize(in_msg.intersections.intersection_state_list.size());
+  for (size_t i = 0; i < in_msg.intersections.intersection_state_list.size(); i++)
   {
-    cav_msgs::IntersectionState cav_state;
-    convertIntersectionState(state, cav_state);
-    out_msg.intersection_state_list.push_back(cav_state);
+    convertIntersectionState(in_msg.intersections.intersection_state_list[i], out_msg.intersection_state_list[i]);
   }
 }
 
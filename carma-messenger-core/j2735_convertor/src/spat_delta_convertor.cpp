@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <ros/serialization.h>
+#include <j2735_convertor/spat_delta_convertor.h>
+
+/**
+ * CPP File containing SPATDeltaConvertor method definitions
+ */
+
+namespace j2735_convertor
+{
+constexpr double SPATDeltaConvertor::MAX_AGE_SEC;
+
+SPATDeltaConvertor::SPATDeltaConvertor(uint32_t keyframe_interval) : keyframe_interval_(keyframe_interval)
+{
+}
+
+bool SPATDeltaConvertor::updateMovement(const j2735_msgs::MovementState& in_msg, MovementCache& cache)
+{
+  // Serialize into the scratch buffer so the comparison covers every field without allocating
+  uint32_t length = ros::serialization::serializationLength(in_msg);
+  scratch_.resize(length);
+  ros::serialization::OStream stream(scratch_.data(), length);
+  ros::serialization::serialize(stream, in_msg);
+
+  if (!swapIfChanged(cache.serialized))
+  {
+    return false;  // Unchanged, keep the previous conversion
+  }
+
+  SPATConvertor::convertMovementState(in_msg, cache.converted);
+  return true;
+}
+
+bool SPATDeltaConvertor::updateHeader(const cav_msgs::IntersectionState& header, IntersectionCache& cache)
+{
+  namespace ser = ros::serialization;
+  // Only the state subscribers keep, the time stamps change with every SPAT
+  uint32_t length = ser::serializationLength(header.name) + ser::serializationLength(header.name_exists) +
+                    ser::serializationLength(header.status) + ser::serializationLength(header.lane_id_list) +
+                    ser::serializationLength(header.enabled_lanes_exists) +
+                    ser::serializationLength(header.connection_maneuver_assist_list) +
+                    ser::serializationLength(header.maneuever_assist_list_exists);
+  scratch_.resize(length);
+  ser::OStream stream(scratch_.data(), length);
+  ser::serialize(stream, header.name);
+  ser::serialize(stream, header.name_exists);
+  ser::serialize(stream, header.status);
+  ser::serialize(stream, header.lane_id_list);
+  ser::serialize(stream, header.enabled_lanes_exists);
+  ser::serialize(stream, header.connection_maneuver_assist_list);
+  ser::serialize(stream, header.maneuever_assist_list_exists);
+
+  return swapIfChanged(cache.header);
+}
+
+bool SPATDeltaConvertor::swapIfChanged(std::vector<uint8_t>& serialized)
+{
+  if (serialized.size() == scratch_.size() && std::equal(scratch_.begin(), scratch_.end(), serialized.begin()))
+  {
+    return false;
+  }
+  serialized.swap(scratch_);  // The old buffer becomes the next scratch buffer
+  return true;
+}
+
+size_t SPATDeltaConvertor::intersectionCount() const
+{
+  return intersections_.size();
+}
+
+bool SPATDeltaConvertor::convert(const j2735_msgs::SPAT& in_msg, const ros::Time& now, cav_msgs::SPAT& full_msg,
+                                 cav_msgs::SPAT& delta_msg)
+{
+  full_msg.time_stamp = in_msg.time_stamp;
+  full_msg.time_stamp_exists = in_msg.time_stamp_exists;
+  full_msg.name = in_msg.name;
+  full_msg.name_exists = in_msg.name_exists;
+
+  delta_msg.time_stamp = in_msg.time_stamp;
+  delta_msg.time_stamp_exists = in_msg.time_stamp_exists;
+  delta_msg.name = in_msg.name;
+  delta_msg.name_exists = in_msg.name_exists;
+
+  const auto& in_states = in_msg.intersections.intersection_state_list;
+  full_msg.intersection_state_list.resize(in_states.size());
+  size_t delta_count = 0;
+
+  for (size_t i = 0; i < in_states.size(); i++)
+  {
+    const j2735_msgs::IntersectionState& in_state = in_states[i];
+    IntersectionCache& cache = intersections_[in_state.id.id];
+    cache.received++;
+    cache.last_seen = now;
+
+    bool keyframe = cache.revision != in_state.revision || ++cache.since_keyframe >= keyframe_interval_;
+
+    cav_msgs::IntersectionState& full_state = full_msg.intersection_state_list[i];
+    SPATConvertor::convertIntersectionStateHeader(in_state, full_state);
+    bool header_changed = updateHeader(full_state, cache);
+
+    // Convert MovementState, reusing the cached conversion of unchanged movements
+    const auto& in_movements = in_state.states.movement_list;
+    full_state.movement_list.resize(in_movements.size());
+    changed_.clear();
+    for (size_t j = 0; j < in_movements.size(); j++)
+    {
+      auto result = cache.movements.emplace(in_movements[j].signal_group, MovementCache());
+      MovementCache& movement = result.first->second;
+      keyframe = keyframe || result.second;  // A new signal group changes the set of movements
+
+      if (updateMovement(in_movements[j], movement))
+      {
+        changed_.push_back(&movement);
+      }
+      movement.last_seen = cache.received;
+      full_state.movement_list[j] = movement.converted;
+    }
+    // Done Conversion
+
+    // Forget signal groups which are no longer broadcast
+    for (auto it = cache.movements.begin(); it != cache.movements.end();)
+    {
+      if (it->second.last_seen != cache.received)
+      {
+        it = cache.movements.erase(it);
+        keyframe = true;
+      }
+      else
+      {
+        it++;
+      }
+    }
+
+    if (keyframe)
+    {
+      cache.revision = in_state.revision;
+      cache.since_keyframe = 0;
+    }
+    else if (changed_.empty() && !header_changed)
+    {
+      continue;  // Nothing to report for this intersection
+    }
+
+    if (delta_msg.intersection_state_list.size() <= delta_count)
+    {
+      delta_msg.intersection_state_list.resize(delta_count + 1);
+    }
+    cav_msgs::IntersectionState& delta_state = delta_msg.intersection_state_list[delta_count++];
+    SPATConvertor::convertIntersectionStateHeader(in_state, delta_state);
+
+    if (keyframe)
+    {
+      delta_state.movement_list = full_state.movement_list;
+    }
+    else
+    {
+      delta_state.movement_list.resize(changed_.size());
+      for (size_t j = 0; j < changed_.size(); j++)
+      {
+        delta_state.movement_list[j] = changed_[j]->converted;
+      }
+    }
+  }
+
+  delta_msg.intersection_state_list.resize(delta_count);
+
+  // Forget intersections which are no longer broadcast, checked about once a second and after the clock went back
+  if (now >= next_sweep_ || next_sweep_ - now > ros::Duration(1.0))
+  {
+    next_sweep_ = now + ros::Duration(1.0);
+    for (auto it = intersections_.begin(); it != intersections_.end();)
+    {
+      if (now - it->second.last_seen > ros::Duration(MAX_AGE_SEC))
+      {
+        it = intersections_.erase(it);
+      }
+      else
+      {
+        it++;
+      }
+    }
+  }
+  return delta_count > 0;
+}
+
+}  // namespace j2735_convertor
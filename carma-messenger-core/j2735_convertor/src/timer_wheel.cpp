@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <j2735_convertor/timer_wheel.h>
+
+/**
+ * CPP File containing TimerWheel method definitions
+ */
+
+namespace j2735_convertor
+{
+constexpr uint32_t TimerWheel::SLOT_BITS;
+constexpr uint32_t TimerWheel::SLOTS;
+constexpr uint32_t TimerWheel::LEVELS;
+
+TimerWheel::TimerWheel(uint64_t now) : now_(now)
+{
+}
+
+void TimerWheel::add(uint64_t timer_id, uint64_t expiry)
+{
+  size_++;
+  insert({ timer_id, expiry });
+}
+
+void TimerWheel::insert(const Timer& timer)
+{
+  if (timer.expiry <= now_)
+  {
+    due_.push_back(timer);
+    return;
+  }
+
+  uint64_t remaining = timer.expiry - now_;
+  for (uint32_t level = 0; level < LEVELS; level++)
+  {
+    if (remaining < (uint64_t(1) << (SLOT_BITS * (level + 1))))
+    {
+      slots_[level][(timer.expiry >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back(timer);
+      return;
+    }
+  }
+  overflow_.push_back(timer);
+}
+
+void TimerWheel::cascade(uint32_t level)
+{
+  if (level == LEVELS)
+  {
+    scratch_.swap(overflow_);
+  }
+  else
+  {
+    uint64_t slot = (now_ >> (SLOT_BITS * level)) & (SLOTS - 1);
+    if (slot == 0)
+    {
+      cascade(level + 1);  // The higher level moved to its next slot as well
+    }
+    scratch_.swap(slots_[level][slot]);
+  }
+
+  // Reinsert with the new current tick. Each timer lands on a lower level or back in the overflow.
+  std::vector<Timer> timers;
+  timers.swap(scratch_);
+  for (const Timer& timer : timers)
+  {
+    insert(timer);
+  }
+  timers.clear();
+  scratch_.swap(timers);  // Keep the allocation
+}
+
+void TimerWheel::fireDue(std::vector<uint64_t>& expired)
+{
+  for (const Timer& timer : due_)
+  {
+    expired.push_back(timer.id);
+  }
+  size_ -= due_.size();
+  due_.clear();
+}
+
+void TimerWheel::jump(uint64_t now, std::vector<uint64_t>& expired)
+{
+  std::vector<Timer> timers;
+  timers.swap(overflow_);
+  for (uint32_t level = 0; level < LEVELS; level++)
+  {
+    for (std::vector<Timer>& slot : slots_[level])
+    {
+      timers.insert(timers.end(), slot.begin(), slot.end());
+      slot.clear();
+    }
+  }
+
+  now_ = now;
+  auto pending = std::partition(timers.begin(), timers.end(), [now](const Timer& timer) { return timer.expiry <= now; });
+  std::stable_sort(timers.begin(), pending,
+                   [](const Timer& a, const Timer& b) { return a.expiry < b.expiry; });
+  for (auto it = timers.begin(); it != pending; ++it)
+  {
+    expired.push_back(it->id);
+  }
+  size_ -= pending - timers.begin();
+  for (auto it = pending; it != timers.end(); ++it)
+  {
+    insert(*it);
+  }
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<uint64_t>& expired)
+{
+  fireDue(expired);
+  if (size_ == 0)
+  {
+    now_ = std::max(now_, now);
+    return;
+  }
+
+  if (now > now_ && now - now_ > SLOTS)
+  {
+    jump(now, expired);
+    return;
+  }
+
+  while (now_ < now)
+  {
+    now_++;
+    if ((now_ & (SLOTS - 1)) == 0)
+    {
+      cascade(1);
+      fireDue(expired);  // Timers expiring exactly on the boundary of a higher level
+    }
+
+    std::vector<Timer>& slot = slots_[0][now_ & (SLOTS - 1)];
+    for (const Timer& timer : slot)
+    {
+      expired.push_back(timer.id);
+    }
+    size_ -= slot.size();
+    slot.clear();
+
+    if (size_ == 0)
+    {
+      now_ = now;  // Nothing left to fire on the way
+    }
+  }
+}
+
+}  // namespace j2735_convertor
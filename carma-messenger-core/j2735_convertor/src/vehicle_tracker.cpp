@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <utility>
+#include <j2735_convertor/vehicle_tracker.h>
+
+namespace j2735_convertor
+{
+constexpr uint8_t VehicleTracker::MSG_COUNT_MODULO;
+constexpr uint8_t VehicleTracker::REORDER_WINDOW;
+
+VehicleTracker::VehicleTracker(size_t capacity, const ros::Duration& max_age)
+  : capacity_(capacity > 0 ? capacity : 1), max_age_(max_age)
+{
+  // Power of two table at twice the capacity, indexed by the top bits of a multiplicative hash
+  size_t slots = 2;
+  shift_ = 31;
+  while (slots < capacity_ * 2)
+  {
+    slots <<= 1;
+    shift_--;
+  }
+  slots_.resize(slots);
+  mask_ = slots - 1;
+}
+
+size_t VehicleTracker::home(uint32_t id) const
+{
+  return static_cast<uint32_t>(id * 2654435769u) >> shift_;
+}
+
+size_t VehicleTracker::probe(uint32_t id) const
+{
+  size_t slot = home(id);
+  while (slots_[slot].used && slots_[slot].id != id)
+  {
+    slot = (slot + 1) & mask_;
+  }
+  return slot;
+}
+
+VehicleTracker::Update VehicleTracker::update(const cav_msgs::BSM& bsm, const ros::Time& now)
+{
+  uint32_t id;
+  if (!bsmId(bsm, id))
+  {
+    return Update::INVALID;
+  }
+
+  TrackedVehicle& vehicle = slots_[probe(id)];
+  if (vehicle.used)
+  {
+    // msgCnt of an expired vehicle says nothing about the order of its messages
+    uint8_t behind = (vehicle.bsm.core_data.msg_count - bsm.core_data.msg_count) & (MSG_COUNT_MODULO - 1);
+    if (now - vehicle.stamp <= max_age_ && behind <= REORDER_WINDOW)
+    {
+      duplicates_++;
+      return Update::DUPLICATE;
+    }
+  }
+  else
+  {
+    if (size_ == capacity_)
+    {
+      dropped_++;
+      return Update::FULL;
+    }
+    vehicle.used = true;
+    vehicle.id = id;
+    vehicle.static_id.clear();
+    vehicle.bsm_count = 0;
+    size_++;
+  }
+
+  vehicle.bsm = bsm;
+  vehicle.stamp = now;
+  vehicle.bsm_count++;
+  return Update::ACCEPTED;
+}
+
+bool VehicleTracker::correlate(const std::string& sender_bsm_id, const std::string& static_id)
+{
+  uint32_t id;
+  if (!parseBsmId(sender_bsm_id, id))
+  {
+    return false;
+  }
+  TrackedVehicle& vehicle = slots_[probe(id)];
+  if (!vehicle.used)
+  {
+    return false;
+  }
+  vehicle.static_id = static_id;
+  return true;
+}
+
+size_t VehicleTracker::expire(const ros::Time& now)
+{
+  size_t expired = 0;
+  size_t slot = 0;
+  while (slot < slots_.size())
+  {
+    // erase shifts a later vehicle into this slot, which has to be checked as well
+    if (slots_[slot].used && now - slots_[slot].stamp > max_age_)
+    {
+      erase(slot);
+      expired++;
+    }
+    else
+    {
+      slot++;
+    }
+  }
+  return expired;
+}
+
+const TrackedVehicle* VehicleTracker::find(uint32_t id) const
+{
+  const TrackedVehicle& vehicle = slots_[probe(id)];
+  return vehicle.used ? &vehicle : nullptr;
+}
+
+void VehicleTracker::erase(size_t slot)
+{
+  size_t hole = slot;
+  size_t next = (hole + 1) & mask_;
+  while (slots_[next].used)
+  {
+    // A vehicle can fill the hole if the hole lies between its home slot and its current slot
+    size_t distance_to_hole = (hole - home(slots_[next].id)) & mask_;
+    size_t distance_to_next = (next - home(slots_[next].id)) & mask_;
+    if (distance_to_hole < distance_to_next)
+    {
+      std::swap(slots_[hole], slots_[next]);
+      hole = next;
+    }
+    next = (next + 1) & mask_;
+  }
+  // Swapping keeps the allocations of the removed BSM for the next vehicle in this slot
+  slots_[hole].used = false;
+  size_--;
+}
+
+bool VehicleTracker::bsmId(const cav_msgs::BSM& bsm, uint32_t& id)
+{
+  if (bsm.core_data.id.size() != 4)
+  {
+    return false;
+  }
+  id = 0;
+  for (size_t i = 0; i < 4; i++)
+  {
+    id = (id << 8) | bsm.core_data.id[i];
+  }
+  return true;
+}
+
+bool VehicleTracker::parseBsmId(const std::string& sender_bsm_id, uint32_t& id)
+{
+  if (sender_bsm_id.size() != 8)
+  {
+    return false;
+  }
+  id = 0;
+  for (char c : sender_bsm_id)
+  {
+    uint32_t digit;
+    if (c >= '0' && c <= '9')
+    {
+      digit = c - '0';
+    }
+    else if (c >= 'a' && c <= 'f')
+    {
+      digit = c - 'a' + 10;
+    }
+    else if (c >= 'A' && c <= 'F')
+    {
+      digit = c - 'A' + 10;
+    }
+    else
+    {
+      return false;
+    }
+    id = (id << 4) | digit;
+  }
+  return true;
+}
+}  // namespace j2735_convertor
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+#include <j2735_convertor/geofence_cache.h>
+
+namespace j2735_convertor
+{
+cav_msgs::TrafficControlMessageV01 makeCachedGeofence(uint8_t id, uint32_t updated, uint32_t end)
+{
+  cav_msgs::TrafficControlMessageV01 geofence;
+  geofence.id.id[0] = id;
+  geofence.updated = ros::Time(updated, 0);
+  geofence.geometry_exists = true;
+  geofence.geometry.reflat = 38.95;
+  geofence.geometry.reflon = -77.15;
+  cav_msgs::PathNode node;
+  node.y = 10.0;
+  geofence.geometry.nodes.push_back(node);
+  geofence.geometry.nodes.push_back(node);
+  geofence.params_exists = true;
+  geofence.params.schedule.end_exists = true;
+  geofence.params.schedule.end = ros::Time(end, 0);
+  return geofence;
+}
+
+TEST(GeofenceCache, restoreStore)
+{
+  const std::string path = "geofence_cache_test.bin";
+  std::remove(path.c_str());
+
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    EXPECT_EQ(0, cache.load(store, ros::Time(0, 0)));  // Creates the file
+
+    ASSERT_TRUE(cache.append(makeCachedGeofence(1, 100, 10000)));
+    ASSERT_TRUE(cache.append(makeCachedGeofence(2, 100, 2000)));
+    ASSERT_TRUE(cache.append(makeCachedGeofence(1, 200, 10000)));  // Supersedes the first record
+  }
+
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    EXPECT_EQ(2, cache.load(store, ros::Time(1000, 0)));
+    std::vector<GeofenceStore::GeofencePtr> geofences = store.getGeofences();
+    ASSERT_EQ(2, geofences.size());
+    for (const GeofenceStore::GeofencePtr& geofence : geofences)
+    {
+      if (geofence->id.id[0] == 1)
+      {
+        EXPECT_EQ(200, geofence->updated.sec);
+      }
+      EXPECT_NEAR(38.95, geofence->geometry.reflat, 0.0000001);
+      EXPECT_EQ(2, geofence->geometry.nodes.size());
+    }
+  }
+
+  // Geofence 2 has expired by the next start
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    EXPECT_EQ(1, cache.load(store, ros::Time(3000, 0)));
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST(GeofenceCache, ignoreTruncatedRecord)
+{
+  const std::string path = "geofence_cache_truncated_test.bin";
+  std::remove(path.c_str());
+
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    cache.load(store, ros::Time(0, 0));
+    cache.append(makeCachedGeofence(1, 100, 10000));
+    cache.append(makeCachedGeofence(2, 100, 10000));
+  }
+
+  // Simulate a crash during an append by cutting the last record short
+  std::string contents;
+  {
+    std::ifstream in(path, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size() - 5);
+  }
+
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    EXPECT_EQ(1, cache.load(store, ros::Time(0, 0)));
+    ASSERT_TRUE(cache.append(makeCachedGeofence(3, 100, 10000)));  // The rewritten file accepts appends
+  }
+
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    EXPECT_EQ(2, cache.load(store, ros::Time(0, 0)));
+  }
+
+  std::remove(path.c_str());
+}
+
+}  // namespace j2735_convertor
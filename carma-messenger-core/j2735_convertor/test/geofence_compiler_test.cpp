@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/geofence_compiler.h>
+#include <j2735_convertor/intersection_geometry_store.h>
+
+namespace j2735_convertor
+{
+cav_msgs::TrafficControlMessageV01 makeCompiledGeofence(uint8_t id, uint32_t updated, const std::string& proj)
+{
+  cav_msgs::TrafficControlMessageV01 geofence;
+  geofence.id.id[0] = id;
+  geofence.updated = ros::Time(updated, 0);
+  geofence.geometry_exists = true;
+  geofence.geometry.proj = proj;
+  geofence.geometry.reflat = 38.95;
+  geofence.geometry.reflon = -77.15;
+  cav_msgs::PathNode node;
+  node.width = 2.0;
+  node.width_exists = true;
+  geofence.geometry.nodes.push_back(node);
+  node.y = 10.0;
+  node.width_exists = false;
+  geofence.geometry.nodes.push_back(node);
+  geofence.geometry.nodes.push_back(node);
+  return geofence;
+}
+
+TEST(GeofenceProjection, parse)
+{
+  EXPECT_TRUE(GeofenceProjection::parse("+proj=tmerc +lat_0=38.95 +lon_0=-77.15 +k=1 +x_0=0 +y_0=0 +datum=WGS84 "
+                                        "+units=m +vunits=m +no_defs"));
+  EXPECT_TRUE(GeofenceProjection::parse("+proj=utm +zone=18 +ellps=GRS80"));
+  EXPECT_FALSE(GeofenceProjection::parse(""));
+  EXPECT_FALSE(GeofenceProjection::parse("+proj=lcc +lat_1=33 +lat_2=45"));
+  EXPECT_FALSE(GeofenceProjection::parse("+proj=tmerc +datum=NAD27"));
+  EXPECT_FALSE(GeofenceProjection::parse("+proj=tmerc +lat_0=north"));
+  EXPECT_FALSE(GeofenceProjection::parse("+proj=utm +zone=61"));
+}
+
+TEST(GeofenceProjection, roundTrip)
+{
+  std::shared_ptr<const GeofenceProjection> utm = GeofenceProjection::parse("+proj=utm +zone=18");
+  ASSERT_TRUE(utm);
+
+  // The central meridian of the zone on the equator is at the false easting
+  double x, y;
+  utm->forward(0.0, -75.0, x, y);
+  EXPECT_NEAR(500000.0, x, 0.001);
+  EXPECT_NEAR(0.0, y, 0.001);
+
+  utm->forward(38.95, -77.15, x, y);
+  double latitude, longitude;
+  utm->inverse(x, y, latitude, longitude);
+  EXPECT_NEAR(38.95, latitude, 0.00000001);
+  EXPECT_NEAR(-77.15, longitude, 0.00000001);
+
+  // One degree of latitude is about 111 km
+  double north_x, north_y;
+  utm->forward(39.95, -75.0, north_x, north_y);
+  utm->forward(38.95, -75.0, x, y);
+  EXPECT_NEAR(111000.0, north_y - y, 200.0);
+}
+
+TEST(GeofenceCompiler, boundary)
+{
+  GeofenceCompiler compiler;
+  std::shared_ptr<const GeofencePolygon> polygon = compiler.compile(makeCompiledGeofence(1, 100, ""));
+  ASSERT_TRUE(polygon);
+
+  // The frame origin defaults to the reference point of the first geofence
+  ASSERT_EQ(3, polygon->x.size());
+  EXPECT_NEAR(0.0, polygon->x[2], 0.001);
+  EXPECT_NEAR(20.0, polygon->y[2], 0.001);
+  EXPECT_NEAR(2.0, polygon->width[2], 0.001);
+
+  // Left edge west of the northbound centerline, right edge east of it and in reverse order
+  ASSERT_EQ(6, polygon->boundary_x.size());
+  EXPECT_NEAR(-1.0, polygon->boundary_x[0], 0.001);
+  EXPECT_NEAR(0.0, polygon->boundary_y[0], 0.001);
+  EXPECT_NEAR(-1.0, polygon->boundary_x[2], 0.001);
+  EXPECT_NEAR(20.0, polygon->boundary_y[2], 0.001);
+  EXPECT_NEAR(1.0, polygon->boundary_x[3], 0.001);
+  EXPECT_NEAR(20.0, polygon->boundary_y[3], 0.001);
+  EXPECT_NEAR(1.0, polygon->boundary_x[5], 0.001);
+  EXPECT_NEAR(0.0, polygon->boundary_y[5], 0.001);
+
+  cav_msgs::TrafficControlMessageV01 no_geometry;
+  EXPECT_FALSE(compiler.compile(no_geometry));
+}
+
+TEST(GeofenceCompiler, projectedOffsets)
+{
+  GeofenceCompiler compiler;
+  compiler.setOrigin(38.95, -77.15);
+  std::shared_ptr<const GeofencePolygon> polygon = compiler.compile(makeCompiledGeofence(
+      1, 100, "+proj=tmerc +lat_0=38.95 +lon_0=-77.15 +k=1 +x_0=0 +y_0=0 +datum=WGS84 +units=m +no_defs"));
+  ASSERT_TRUE(polygon);
+  EXPECT_NEAR(0.0, polygon->x[0], 0.01);
+  EXPECT_NEAR(0.0, polygon->y[0], 0.01);
+
+  // The spherical compiler frame differs from the ellipsoidal projection by a fraction of a percent
+  EXPECT_NEAR(0.0, polygon->x[2], 0.01);
+  EXPECT_NEAR(20.0, polygon->y[2], 0.1);
+}
+
+TEST(GeofenceCompiler, unsupportedProjection)
+{
+  GeofenceCompiler compiler;
+  EXPECT_TRUE(compiler.compile(makeCompiledGeofence(1, 100, "")));
+
+  // Offsets in an unknown frame cannot be placed, the older version is dropped as well
+  EXPECT_FALSE(compiler.compile(makeCompiledGeofence(1, 200, "+proj=lcc +lat_1=33 +lat_2=45")));
+  EXPECT_EQ(0, compiler.size());
+  EXPECT_EQ(2, compiler.projectionCount());
+
+  // Proj strings received over the air do not grow the cache without bound
+  for (size_t i = 0; i < GeofenceCompiler::MAX_PROJECTIONS; i++)
+  {
+    compiler.compile(makeCompiledGeofence(2, 100, "+proj=lcc +lat_1=" + std::to_string(i)));
+  }
+  EXPECT_LE(compiler.projectionCount(), GeofenceCompiler::MAX_PROJECTIONS);
+}
+
+TEST(GeofenceCompiler, cache)
+{
+  const std::string proj = "+proj=utm +zone=18";
+  GeofenceCompiler compiler;
+  std::shared_ptr<const GeofencePolygon> first = compiler.compile(makeCompiledGeofence(1, 100, proj));
+  ASSERT_TRUE(first);
+
+  // A rebroadcast returns the compiled polygon and a new version replaces it
+  EXPECT_EQ(first, compiler.compile(makeCompiledGeofence(1, 100, proj)));
+  std::shared_ptr<const GeofencePolygon> second = compiler.compile(makeCompiledGeofence(1, 200, proj));
+  EXPECT_NE(first, second);
+  EXPECT_EQ(second, compiler.lookup(first->id));
+
+  // Projections are shared between geofences
+  compiler.compile(makeCompiledGeofence(2, 100, proj));
+  EXPECT_EQ(2, compiler.size());
+  EXPECT_EQ(1, compiler.projectionCount());
+
+  compiler.remove(first->id);
+  EXPECT_EQ(1, compiler.size());
+  EXPECT_FALSE(compiler.lookup(first->id));
+}
+
+TEST(GeofenceCompiler, sharedFrame)
+{
+  std::shared_ptr<LocalFrame> frame = std::make_shared<LocalFrame>();
+  GeofenceCompiler compiler(frame);
+  IntersectionGeometryStore store(frame);
+
+  // The first geofence sets the origin of the lanes as well
+  std::shared_ptr<const GeofencePolygon> polygon = compiler.compile(makeCompiledGeofence(1, 100, ""));
+  ASSERT_TRUE(polygon);
+  EXPECT_EQ(38.95, polygon->origin_latitude);
+  EXPECT_EQ(-77.15, polygon->origin_longitude);
+
+  cav_msgs::MapData map;
+  cav_msgs::IntersectionGeometry geometry;
+  geometry.id.id = 9001;
+  geometry.ref_point.latitude = 38.95;
+  geometry.ref_point.longitude = -77.151;
+  map.intersections.push_back(geometry);
+  store.update(map);
+  EXPECT_NEAR(-86.6, store.getIntersection(9001)->ref_x, 0.5);  // 0.001 degrees of longitude at this latitude
+  EXPECT_NEAR(0.0, store.getIntersection(9001)->ref_y, 0.00001);
+
+  // Once set the origin no longer moves
+  store.setOrigin(0.0, 0.0);
+  double latitude, longitude;
+  ASSERT_TRUE(frame->getOrigin(latitude, longitude));
+  EXPECT_EQ(38.95, latitude);
+  EXPECT_EQ(-77.15, longitude);
+}
+
+}  // namespace j2735_convertor
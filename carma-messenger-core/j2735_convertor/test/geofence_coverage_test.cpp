@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdio>
+#include <gmock/gmock.h>
+#include <j2735_convertor/geofence_cache.h>
+#include <j2735_convertor/geofence_coverage.h>
+
+namespace j2735_convertor
+{
+/**
+ * Builds a request with square bounds of the provided size in meters and south west corner
+ */
+cav_msgs::TrafficControlRequestV01 makeCoverageRequest(uint8_t reqid, double size, double reflat, uint32_t oldest)
+{
+  cav_msgs::TrafficControlRequestV01 request;
+  request.reqid.id[0] = reqid;
+  cav_msgs::TrafficControlBounds bounds;
+  bounds.oldest = ros::Time(oldest, 0);
+  bounds.reflat = reflat;
+  bounds.reflon = -77.15;
+  bounds.offsets[0].deltax = size;
+  bounds.offsets[1].deltax = size;
+  bounds.offsets[1].deltay = size;
+  bounds.offsets[2].deltay = size;
+  request.bounds.push_back(bounds);
+  return request;
+}
+
+cav_msgs::TrafficControlMessageV01 makeResponse(uint8_t reqid, uint16_t msgnum, uint16_t msgtot)
+{
+  cav_msgs::TrafficControlMessageV01 response;
+  response.reqid.id[0] = reqid;
+  response.msgnum = msgnum;
+  response.msgtot = msgtot;
+  return response;
+}
+
+TEST(GeofenceCoverage, unchangedWithoutCoverage)
+{
+  GeofenceCoverage coverage;
+  cav_msgs::TrafficControlRequestV01 request = makeCoverageRequest(1, 1000.0, 38.95, 0);
+  EXPECT_EQ(0, coverage.trackRequest(request, ros::Time(1000, 0)));
+  EXPECT_EQ(ros::Time(0, 0), request.bounds[0].oldest);
+
+  // An incomplete request covers nothing
+  EXPECT_FALSE(coverage.addResponse(makeResponse(1, 1, 2)));
+  EXPECT_FALSE(coverage.addResponse(makeResponse(1, 1, 2)));  // Repeated
+  EXPECT_FALSE(coverage.addResponse(makeResponse(2, 1, 1)));  // Not tracked
+  EXPECT_TRUE(coverage.getAreas().empty());
+
+  request = makeCoverageRequest(3, 500.0, 38.951, 0);
+  EXPECT_EQ(0, coverage.trackRequest(request, ros::Time(1100, 0)));
+  EXPECT_EQ(ros::Time(0, 0), request.bounds[0].oldest);
+}
+
+TEST(GeofenceCoverage, narrowCoveredBounds)
+{
+  GeofenceCoverage coverage;
+  cav_msgs::TrafficControlRequestV01 request = makeCoverageRequest(1, 1000.0, 38.95, 0);
+  coverage.trackRequest(request, ros::Time(1000, 0));
+  EXPECT_FALSE(coverage.addResponse(makeResponse(1, 2, 2)));
+  EXPECT_TRUE(coverage.addResponse(makeResponse(1, 1, 2)));
+  ASSERT_EQ(1, coverage.getAreas().size());
+
+  // Bounds within the covered area only ask for what was updated since, less the clock margin
+  request = makeCoverageRequest(2, 500.0, 38.951, 0);
+  cav_msgs::TrafficControlBounds outside = makeCoverageRequest(2, 500.0, 38.96, 0).bounds[0];
+  request.bounds.push_back(outside);
+  EXPECT_EQ(1, coverage.trackRequest(request, ros::Time(2000, 0)));
+  EXPECT_NEAR(1000.0 - GeofenceCoverage::CLOCK_MARGIN, request.bounds[0].oldest.toSec(), 0.001);
+  EXPECT_EQ(ros::Time(0, 0), request.bounds[1].oldest);
+
+  // Bounds already asking for newer geofences are unchanged
+  request = makeCoverageRequest(3, 500.0, 38.951, 1500);
+  EXPECT_EQ(0, coverage.trackRequest(request, ros::Time(2000, 0)));
+  EXPECT_EQ(ros::Time(1500, 0), request.bounds[0].oldest);
+
+  // Completing the narrowed request covers both bounds since their requested oldest time
+  EXPECT_TRUE(coverage.addResponse(makeResponse(2, 1, 1)));
+  request = makeCoverageRequest(4, 100.0, 38.9601, 0);
+  EXPECT_EQ(1, coverage.trackRequest(request, ros::Time(3000, 0)));
+  EXPECT_NEAR(2000.0 - GeofenceCoverage::CLOCK_MARGIN, request.bounds[0].oldest.toSec(), 0.001);
+}
+
+TEST(GeofenceCoverage, saveWithCache)
+{
+  const std::string path = "geofence_coverage_test.bin";
+  std::remove(path.c_str());
+  std::remove((path + ".coverage").c_str());
+
+  GeofenceCoverage coverage;
+  cav_msgs::TrafficControlRequestV01 request = makeCoverageRequest(1, 1000.0, 38.95, 0);
+  coverage.trackRequest(request, ros::Time(1000, 0));
+  ASSERT_TRUE(coverage.addResponse(makeResponse(1, 1, 1)));
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    cache.load(store, ros::Time(0, 0));
+    EXPECT_TRUE(cache.loadCoverage().empty());  // The cache file did not exist
+    ASSERT_TRUE(cache.saveCoverage(coverage.getAreas()));
+  }
+
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    cache.load(store, ros::Time(0, 0));
+    GeofenceCoverage restored;
+    restored.restore(cache.loadCoverage());
+    ASSERT_EQ(1, restored.getAreas().size());
+    EXPECT_EQ(ros::Time(1000, 0), restored.getAreas()[0].complete);
+    EXPECT_DOUBLE_EQ(coverage.getAreas()[0].extent.max_y, restored.getAreas()[0].extent.max_y);
+
+    request = makeCoverageRequest(2, 500.0, 38.951, 0);
+    EXPECT_EQ(1, restored.trackRequest(request, ros::Time(2000, 0)));
+  }
+
+  // Without the geofences the coverage is not trusted
+  std::remove(path.c_str());
+  {
+    GeofenceStore store;
+    GeofenceCache cache(path);
+    cache.load(store, ros::Time(0, 0));
+    EXPECT_TRUE(cache.loadCoverage().empty());
+  }
+
+  std::remove(path.c_str());
+  std::remove((path + ".coverage").c_str());
+}
+
+}  // namespace j2735_convertor
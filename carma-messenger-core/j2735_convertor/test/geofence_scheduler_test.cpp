@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/geofence_scheduler.h>
+
+namespace j2735_convertor
+{
+namespace
+{
+const uint32_t DAY = 86400;
+const uint32_t HOUR = 3600;
+const uint32_t MINUTE = 60;
+const uint32_t WED_2020_01_01 = 18262 * DAY;
+}  // namespace
+
+cav_msgs::TrafficControlSchedule makeDailySchedule(uint32_t begin, uint32_t duration)
+{
+  cav_msgs::TrafficControlSchedule schedule;
+  schedule.start = ros::Time(WED_2020_01_01, 0);
+  schedule.between_exists = true;
+  cav_msgs::DailySchedule window;
+  window.begin = ros::Duration(begin, 0);
+  window.duration = ros::Duration(duration, 0);
+  schedule.between.push_back(window);
+  return schedule;
+}
+
+TEST(GeofenceScheduler, dailyWindow)
+{
+  cav_msgs::TrafficControlSchedule schedule = makeDailySchedule(8 * HOUR, 2 * HOUR);
+  ros::Time begin, end;
+
+  ASSERT_TRUE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + 7 * HOUR, 0), begin, end));
+  EXPECT_EQ(WED_2020_01_01 + 8 * HOUR, begin.sec);
+  EXPECT_EQ(WED_2020_01_01 + 10 * HOUR, end.sec);
+
+  ASSERT_TRUE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + 9 * HOUR, 0), begin, end));
+  EXPECT_EQ(WED_2020_01_01 + 8 * HOUR, begin.sec);
+
+  ASSERT_TRUE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + 10 * HOUR, 0), begin, end));
+  EXPECT_EQ(WED_2020_01_01 + DAY + 8 * HOUR, begin.sec);
+
+  // No interval after the end of the schedule
+  schedule.end_exists = true;
+  schedule.end = ros::Time(WED_2020_01_01 + 9 * HOUR, 0);
+  ASSERT_TRUE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + 7 * HOUR, 0), begin, end));
+  EXPECT_EQ(WED_2020_01_01 + 9 * HOUR, end.sec);
+  EXPECT_FALSE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + 9 * HOUR, 0), begin, end));
+}
+
+TEST(GeofenceScheduler, daysOfWeek)
+{
+  cav_msgs::TrafficControlSchedule schedule;
+  schedule.start = ros::Time(WED_2020_01_01, 0);
+  schedule.dow_exists = true;
+  schedule.dow.dow[j2735_msgs::DayOfWeek::SAT] = 1;
+  schedule.dow.dow[j2735_msgs::DayOfWeek::SUN] = 1;
+
+  // The whole weekend is a single interval
+  ros::Time begin, end;
+  ASSERT_TRUE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + HOUR, 0), begin, end));
+  EXPECT_EQ(WED_2020_01_01 + 3 * DAY, begin.sec);
+  EXPECT_EQ(WED_2020_01_01 + 5 * DAY, end.sec);
+}
+
+TEST(GeofenceScheduler, repeat)
+{
+  cav_msgs::TrafficControlSchedule schedule = makeDailySchedule(8 * HOUR, 2 * HOUR);
+  schedule.repeat_exists = true;
+  schedule.repeat.offset = ros::Duration(5 * MINUTE, 0);
+  schedule.repeat.period = ros::Duration(30 * MINUTE, 0);
+  schedule.repeat.span = ros::Duration(10 * MINUTE, 0);
+
+  ros::Time begin, end;
+  ASSERT_TRUE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + 8 * HOUR + 10 * MINUTE, 0), begin, end));
+  EXPECT_EQ(WED_2020_01_01 + 8 * HOUR + 5 * MINUTE, begin.sec);
+  EXPECT_EQ(WED_2020_01_01 + 8 * HOUR + 15 * MINUTE, end.sec);
+
+  ASSERT_TRUE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + 8 * HOUR + 20 * MINUTE, 0), begin, end));
+  EXPECT_EQ(WED_2020_01_01 + 8 * HOUR + 35 * MINUTE, begin.sec);
+
+  // The last repetition of the window is followed by the first one of the next day
+  ASSERT_TRUE(nextActiveInterval(schedule, ros::Time(WED_2020_01_01 + 9 * HOUR + 50 * MINUTE, 0), begin, end));
+  EXPECT_EQ(WED_2020_01_01 + DAY + 8 * HOUR + 5 * MINUTE, begin.sec);
+}
+
+TEST(GeofenceScheduler, transitions)
+{
+  GeofenceScheduler scheduler(ros::Time(WED_2020_01_01, 0));
+  std::vector<ScheduleEvent> events;
+
+  cav_msgs::TrafficControlMessageV01 scheduled;
+  scheduled.id.id[0] = 1;
+  scheduled.params_exists = true;
+  scheduled.params.schedule = makeDailySchedule(8 * HOUR, 2 * HOUR);
+  scheduled.params.schedule.end_exists = true;
+  scheduled.params.schedule.end = ros::Time(WED_2020_01_01 + DAY, 0);
+  scheduler.update(scheduled, ros::Time(WED_2020_01_01 + 7 * HOUR, 0), events);
+  EXPECT_TRUE(events.empty());
+
+  cav_msgs::TrafficControlMessageV01 unscheduled;
+  unscheduled.id.id[0] = 2;
+  scheduler.update(unscheduled, ros::Time(WED_2020_01_01 + 7 * HOUR, 0), events);
+  ASSERT_EQ(1, events.size());
+  EXPECT_EQ(2, events[0].id.id[0]);
+  EXPECT_TRUE(events[0].active);
+  EXPECT_EQ(2, scheduler.size());
+
+  events.clear();
+  scheduler.advance(ros::Time(WED_2020_01_01 + 8 * HOUR - 1, 0), events);
+  EXPECT_TRUE(events.empty());
+  scheduler.advance(ros::Time(WED_2020_01_01 + 8 * HOUR, 0), events);
+  ASSERT_EQ(1, events.size());
+  EXPECT_EQ(1, events[0].id.id[0]);
+  EXPECT_TRUE(events[0].active);
+  EXPECT_TRUE(scheduler.isActive(scheduled.id));
+
+  // Deactivated for good once the window ends since the schedule ends before the next one
+  events.clear();
+  scheduler.advance(ros::Time(WED_2020_01_01 + 10 * HOUR + 30, 0), events);
+  ASSERT_EQ(1, events.size());
+  EXPECT_FALSE(events[0].active);
+  EXPECT_EQ(WED_2020_01_01 + 10 * HOUR + 30, events[0].stamp.sec);
+  EXPECT_EQ(1, scheduler.size());
+}
+
+TEST(GeofenceScheduler, replaceSchedule)
+{
+  GeofenceScheduler scheduler(ros::Time(WED_2020_01_01, 0));
+  std::vector<ScheduleEvent> events;
+
+  cav_msgs::TrafficControlMessageV01 geofence;
+  geofence.params_exists = true;
+  geofence.params.schedule = makeDailySchedule(8 * HOUR, 2 * HOUR);
+  scheduler.update(geofence, ros::Time(WED_2020_01_01, 0), events);
+
+  // The new version moves the window so the transition of the old one must not fire
+  geofence.params.schedule = makeDailySchedule(12 * HOUR, HOUR);
+  scheduler.update(geofence, ros::Time(WED_2020_01_01, 0), events);
+  scheduler.advance(ros::Time(WED_2020_01_01 + 9 * HOUR, 0), events);
+  EXPECT_TRUE(events.empty());
+
+  scheduler.advance(ros::Time(WED_2020_01_01 + 12 * HOUR, 0), events);
+  ASSERT_EQ(1, events.size());
+  EXPECT_TRUE(events[0].active);
+  scheduler.advance(ros::Time(WED_2020_01_01 + 13 * HOUR, 0), events);
+  ASSERT_EQ(2, events.size());
+  EXPECT_FALSE(events[1].active);
+  EXPECT_EQ(1, scheduler.size());
+}
+
+}  // namespace j2735_convertor
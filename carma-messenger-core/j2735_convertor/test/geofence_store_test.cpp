@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/geofence_store.h>
+
+namespace j2735_convertor
+{
+/**
+ * Builds a geofence running 100 meters north from the provided reference point
+ */
+cav_msgs::TrafficControlMessageV01 makeGeofence(uint8_t id, double reflat, double reflon, uint32_t updated)
+{
+  cav_msgs::TrafficControlMessageV01 geofence;
+  geofence.id.id[0] = id;
+  geofence.updated = ros::Time(updated, 0);
+  geofence.geometry_exists = true;
+  geofence.geometry.reflat = reflat;
+  geofence.geometry.reflon = reflon;
+  for (size_t i = 0; i < 3; i++)
+  {
+    cav_msgs::PathNode node;
+    node.y = i == 0 ? 0.0 : 50.0;
+    node.width = 4.0;
+    node.width_exists = true;
+    geofence.geometry.nodes.push_back(node);
+  }
+  return geofence;
+}
+
+/**
+ * Builds 20 by 20 meter bounds with the provided south west corner
+ */
+cav_msgs::TrafficControlBounds makeBounds(double reflat, double reflon, uint32_t oldest)
+{
+  cav_msgs::TrafficControlBounds bounds;
+  bounds.oldest = ros::Time(oldest, 0);
+  bounds.reflat = reflat;
+  bounds.reflon = reflon;
+  bounds.offsets[0].deltax = 20.0;
+  bounds.offsets[1].deltax = 20.0;
+  bounds.offsets[1].deltay = 20.0;
+  bounds.offsets[2].deltay = 20.0;
+  return bounds;
+}
+
+TEST(GeofenceStore, queryBounds)
+{
+  GeofenceStore store;
+  ASSERT_TRUE(store.add(makeGeofence(1, 38.95, -77.15, 100)));
+  ASSERT_TRUE(store.add(makeGeofence(2, 38.96, -77.15, 100)));
+
+  cav_msgs::TrafficControlMessageV01 no_geometry = makeGeofence(3, 38.95, -77.15, 100);
+  no_geometry.geometry_exists = false;
+  EXPECT_FALSE(store.add(no_geometry));
+  EXPECT_EQ(2, store.size());
+
+  // Bounds 80 meters north of the first geofence reference point overlap it
+  std::vector<GeofenceStore::GeofencePtr> result = store.query(makeBounds(38.95072, -77.15005, 0));
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ(1, result[0]->id.id[0]);
+
+  // Bounds 120 meters north do not
+  EXPECT_TRUE(store.query(makeBounds(38.95108, -77.15005, 0)).empty());
+
+  // Geofences updated before the oldest time of the bounds are not returned
+  EXPECT_TRUE(store.query(makeBounds(38.95072, -77.15005, 200)).empty());
+}
+
+TEST(GeofenceStore, replaceAndExpire)
+{
+  GeofenceStore store;
+  store.add(makeGeofence(1, 38.95, -77.15, 100));
+
+  // An older version does not replace the stored geofence
+  EXPECT_FALSE(store.add(makeGeofence(1, 38.96, -77.15, 50)));
+  EXPECT_EQ(1, store.query(makeBounds(38.95072, -77.15005, 0)).size());
+
+  // A rebroadcast of the stored version is not a change
+  EXPECT_FALSE(store.add(makeGeofence(1, 38.95, -77.15, 100)));
+  EXPECT_EQ(1, store.size());
+  EXPECT_TRUE(store.holds(makeGeofence(1, 38.95, -77.15, 100)));
+  EXPECT_FALSE(store.holds(makeGeofence(1, 38.95, -77.15, 150)));
+  EXPECT_FALSE(store.holds(makeGeofence(2, 38.95, -77.15, 100)));
+
+  // A newer version moves it
+  EXPECT_TRUE(store.add(makeGeofence(1, 38.96, -77.15, 150)));
+  EXPECT_EQ(1, store.size());
+  EXPECT_TRUE(store.query(makeBounds(38.95072, -77.15005, 0)).empty());
+  EXPECT_EQ(1, store.query(makeBounds(38.96072, -77.15005, 0)).size());
+
+  cav_msgs::TrafficControlMessageV01 expiring = makeGeofence(2, 38.95, -77.15, 100);
+  expiring.params_exists = true;
+  expiring.params.schedule.end_exists = true;
+  expiring.params.schedule.end = ros::Time(1000, 0);
+  store.add(expiring);
+  EXPECT_TRUE(store.removeExpired(ros::Time(500, 0)).empty());
+  std::vector<j2735_msgs::Id128b> removed = store.removeExpired(ros::Time(1500, 0));
+  ASSERT_EQ(1, removed.size());
+  EXPECT_EQ(expiring.id.id, removed[0].id);
+  EXPECT_EQ(1, store.size());
+  EXPECT_EQ(1, store.query(makeBounds(38.96072, -77.15005, 0)).size());
+}
+
+TEST(GeofenceStore, queryRequest)
+{
+  GeofenceStore store;
+  for (uint8_t i = 0; i < 100; i++)
+  {
+    store.add(makeGeofence(i, 38.95 + i * 0.01, -77.15, 100));
+  }
+
+  // Overlapping bounds return each geofence once
+  cav_msgs::TrafficControlRequestV01 request;
+  request.bounds.push_back(makeBounds(38.95072, -77.15005, 0));
+  request.bounds.push_back(makeBounds(38.95073, -77.15005, 0));
+  request.bounds.push_back(makeBounds(39.00072, -77.15005, 0));
+  std::vector<GeofenceStore::GeofencePtr> result = store.query(request);
+  ASSERT_EQ(2, result.size());
+  EXPECT_NE(result[0]->id.id[0], result[1]->id.id[0]);
+}
+
+}  // namespace j2735_convertor
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/intersection_demux.h>
+
+namespace j2735_convertor
+{
+/**
+ * @brief Sink recording what a publisher would have sent
+ */
+struct RecordingSink
+{
+  uint16_t intersection_id = 0;
+  uint32_t subscribers = 1;
+  std::vector<cav_msgs::SPAT> spats;
+  std::vector<cav_msgs::MapData> maps;
+
+  uint32_t getNumSubscribers() const
+  {
+    return subscribers;
+  }
+
+  void publish(const cav_msgs::SPAT& message)
+  {
+    spats.push_back(message);
+  }
+
+  void publish(const cav_msgs::MapData& message)
+  {
+    maps.push_back(message);
+  }
+};
+
+IntersectionDemux<RecordingSink> makeDemux(std::vector<uint16_t>& created, uint16_t without_subscribers = 0)
+{
+  return IntersectionDemux<RecordingSink>([&created, without_subscribers](uint16_t id) {
+    created.push_back(id);
+    RecordingSink sink;
+    sink.intersection_id = id;
+    sink.subscribers = id == without_subscribers ? 0 : 1;
+    return sink;
+  });
+}
+
+cav_msgs::SPAT makeSplitSpat(const std::vector<uint16_t>& ids)
+{
+  cav_msgs::SPAT spat;
+  spat.name = "corridor";
+  spat.name_exists = true;
+  for (uint16_t id : ids)
+  {
+    cav_msgs::IntersectionState state;
+    state.id.id = id;
+    state.revision = id % 7;
+    spat.intersection_state_list.push_back(state);
+  }
+  return spat;
+}
+
+TEST(IntersectionDemux, topic)
+{
+  EXPECT_EQ("incoming_spat/intersection_9001", IntersectionDemux<RecordingSink>::topic("incoming_spat", 9001));
+}
+
+TEST(IntersectionDemux, routeSpatByIntersectionId)
+{
+  std::vector<uint16_t> created;
+  IntersectionDemux<RecordingSink> demux = makeDemux(created);
+
+  // Several intersections in one SPAT each go to their own sink, alone
+  demux.publishSpat(makeSplitSpat({ 9001, 9002, 9003 }));
+  ASSERT_EQ(3, demux.size());
+  for (uint16_t id : { 9001, 9002, 9003 })
+  {
+    RecordingSink* sink = demux.findSink(id);
+    ASSERT_NE(nullptr, sink);
+    EXPECT_EQ(id, sink->intersection_id);
+    ASSERT_EQ(1, sink->spats.size());
+    ASSERT_EQ(1, sink->spats[0].intersection_state_list.size());
+    EXPECT_EQ(id, sink->spats[0].intersection_state_list[0].id.id);
+    EXPECT_EQ(id % 7, sink->spats[0].intersection_state_list[0].revision);
+    EXPECT_EQ("corridor", sink->spats[0].name);
+    EXPECT_TRUE(sink->spats[0].name_exists);
+  }
+
+  // Sinks are created once per intersection id
+  demux.publishSpat(makeSplitSpat({ 9002 }));
+  EXPECT_THAT(created, testing::ElementsAre(9001, 9002, 9003));
+  EXPECT_EQ(1, demux.findSink(9001)->spats.size());
+  EXPECT_EQ(2, demux.findSink(9002)->spats.size());
+}
+
+TEST(IntersectionDemux, unknownIntersection)
+{
+  std::vector<uint16_t> created;
+  IntersectionDemux<RecordingSink> demux = makeDemux(created, 9002);
+
+  // No sink exists for an intersection which was never received
+  EXPECT_EQ(nullptr, demux.findSink(9001));
+  EXPECT_EQ(0, demux.size());
+  demux.publishSpat(cav_msgs::SPAT());
+  EXPECT_TRUE(created.empty());
+
+  // A new id gets a sink, but nothing is published to it without subscribers
+  demux.publishSpat(makeSplitSpat({ 9001, 9002 }));
+  EXPECT_EQ(nullptr, demux.findSink(1234));
+  ASSERT_NE(nullptr, demux.findSink(9002));
+  EXPECT_TRUE(demux.findSink(9002)->spats.empty());
+  EXPECT_EQ(1, demux.findSink(9001)->spats.size());
+}
+
+TEST(IntersectionDemux, routeMapByIntersectionId)
+{
+  std::vector<uint16_t> created;
+  IntersectionDemux<RecordingSink> demux = makeDemux(created, 9002);
+
+  cav_msgs::MapData map;
+  map.msg_issue_revision = 3;
+  for (uint16_t id : { 9001, 9002 })
+  {
+    cav_msgs::IntersectionGeometry geometry;
+    geometry.id.id = id;
+    map.intersections.push_back(geometry);
+  }
+  demux.publishMap(map);
+
+  // MAP sinks are latched, so they are published even without subscribers
+  for (uint16_t id : { 9001, 9002 })
+  {
+    RecordingSink* sink = demux.findSink(id);
+    ASSERT_NE(nullptr, sink);
+    ASSERT_EQ(1, sink->maps.size());
+    EXPECT_TRUE(sink->maps[0].intersections_exists);
+    ASSERT_EQ(1, sink->maps[0].intersections.size());
+    EXPECT_EQ(id, sink->maps[0].intersections[0].id.id);
+    EXPECT_EQ(3, sink->maps[0].msg_issue_revision);
+  }
+}
+
+}  // namespace j2735_convertor
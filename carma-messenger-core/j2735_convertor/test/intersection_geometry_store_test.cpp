@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_msgs/NodeOffsetPointXY.h>
+#include <j2735_convertor/intersection_geometry_store.h>
+
+namespace j2735_convertor
+{
+cav_msgs::MapData makeMap(uint16_t id, uint8_t revision)
+{
+  cav_msgs::MapData map;
+  cav_msgs::IntersectionGeometry geometry;
+  geometry.id.id = id;
+  geometry.revision = revision;
+  geometry.ref_point.latitude = 38.95;
+  geometry.ref_point.longitude = -77.15;
+  geometry.lane_width = 3.0;
+  geometry.lane_width_exists = true;
+
+  cav_msgs::GenericLane lane;
+  lane.lane_id = 7;
+  cav_msgs::NodeXY node;
+  node.delta.choice = j2735_msgs::NodeOffsetPointXY::NODE_XY1;
+  node.delta.x = 10.0;
+  node.delta.y = 5.0;
+  lane.node_list.nodes.node_set_xy.push_back(node);
+  node.delta.x = 0.0;
+  node.delta.y = 20.0;
+  node.attributes_exists = true;
+  node.attributes.dWitdh_exists = true;
+  node.attributes.dWitdh = 0.5;
+  lane.node_list.nodes.node_set_xy.push_back(node);
+  geometry.lane_list.push_back(lane);
+
+  cav_msgs::GenericLane computed;  // Computed lanes carry no nodes
+  computed.lane_id = 8;
+  geometry.lane_list.push_back(computed);
+
+  map.intersections.push_back(geometry);
+  return map;
+}
+
+TEST(IntersectionGeometryStore, accumulateNodeOffsets)
+{
+  IntersectionGeometryStore store;
+  ASSERT_TRUE(store.update(makeMap(9001, 1)));
+  EXPECT_EQ(1, store.version());
+
+  std::shared_ptr<const IntersectionGeometry> geometry = store.getIntersection(9001);
+  ASSERT_TRUE(geometry != nullptr);
+  EXPECT_NEAR(0.0, geometry->ref_x, 0.00001);  // The first reference point is the origin
+  EXPECT_NEAR(0.0, geometry->ref_y, 0.00001);
+  ASSERT_EQ(2, geometry->laneCount());
+  ASSERT_EQ(3, geometry->lane_offsets.size());
+
+  int lane = geometry->findLane(7);
+  ASSERT_EQ(0, lane);
+  ASSERT_EQ(2, geometry->lane_offsets[lane + 1] - geometry->lane_offsets[lane]);
+  EXPECT_NEAR(10.0, geometry->x[0], 0.00001);
+  EXPECT_NEAR(5.0, geometry->y[0], 0.00001);
+  EXPECT_NEAR(3.0, geometry->width[0], 0.00001);
+  EXPECT_NEAR(10.0, geometry->x[1], 0.00001);
+  EXPECT_NEAR(25.0, geometry->y[1], 0.00001);
+  EXPECT_NEAR(3.5, geometry->width[1], 0.00001);
+
+  lane = geometry->findLane(8);
+  ASSERT_EQ(1, lane);
+  EXPECT_EQ(geometry->lane_offsets[lane], geometry->lane_offsets[lane + 1]);
+  EXPECT_EQ(-1, geometry->findLane(9));
+}
+
+TEST(IntersectionGeometryStore, recomputeOnlyNewRevisions)
+{
+  IntersectionGeometryStore store;
+  store.update(makeMap(9001, 1));
+  std::shared_ptr<const IntersectionGeometry> first = store.getIntersection(9001);
+
+  // A rebroadcast of the same revision keeps the stored geometry
+  EXPECT_FALSE(store.update(makeMap(9001, 1)));
+  EXPECT_EQ(1, store.version());
+  EXPECT_EQ(first, store.getIntersection(9001));
+
+  // A new revision replaces it while readers keep their snapshot
+  EXPECT_TRUE(store.update(makeMap(9001, 2)));
+  EXPECT_EQ(2, store.version());
+  EXPECT_NE(first, store.getIntersection(9001));
+  EXPECT_EQ(1, first->revision);
+
+  EXPECT_TRUE(store.update(makeMap(9002, 1)));
+  EXPECT_EQ(2, store.getIntersections().size());
+  EXPECT_TRUE(store.getIntersection(1234) == nullptr);
+}
+
+TEST(IntersectionGeometryStore, explicitOrigin)
+{
+  IntersectionGeometryStore store;
+  double x, y;
+  EXPECT_FALSE(store.toLocal(38.95, -77.15, x, y));
+  EXPECT_FALSE(store.getOrigin(x, y));
+
+  store.setOrigin(38.95, -77.151);
+  ASSERT_TRUE(store.getOrigin(y, x));
+  EXPECT_EQ(38.95, y);
+  EXPECT_EQ(-77.151, x);
+  store.update(makeMap(9001, 1));
+  std::shared_ptr<const IntersectionGeometry> geometry = store.getIntersection(9001);
+  EXPECT_NEAR(86.6, geometry->ref_x, 0.5);  // 0.001 degrees of longitude at this latitude
+  EXPECT_NEAR(0.0, geometry->ref_y, 0.00001);
+  EXPECT_NEAR(geometry->ref_x + 10.0, geometry->x[0], 0.00001);
+}
+
+}  // namespace j2735_convertor
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/lane_index.h>
+
+namespace j2735_convertor
+{
+/**
+ * Builds a geometry with parallel lanes heading north, spaced lane_width apart, each with nodes every 10 meters
+ */
+std::shared_ptr<const IntersectionGeometry> makeGrid(uint16_t id, double origin_x, size_t lanes, size_t nodes)
+{
+  std::shared_ptr<IntersectionGeometry> geometry(new IntersectionGeometry());
+  geometry->id = id;
+  geometry->lane_offsets.push_back(0);
+  for (size_t lane = 0; lane < lanes; lane++)
+  {
+    for (size_t node = 0; node < nodes; node++)
+    {
+      geometry->x.push_back(origin_x + lane * 3.0);
+      geometry->y.push_back(node * 10.0);
+      geometry->width.push_back(3.0);
+    }
+    geometry->lane_ids.push_back(lane + 1);
+    geometry->lane_offsets.push_back(geometry->x.size());
+  }
+  return geometry;
+}
+
+TEST(LaneIndex, matchPosition)
+{
+  std::vector<std::shared_ptr<const IntersectionGeometry>> intersections;
+  intersections.push_back(makeGrid(1, 0.0, 4, 5));
+  intersections.push_back(makeGrid(2, 1000.0, 4, 5));
+  LaneIndex index(intersections);
+  EXPECT_EQ(2 * 4 * 4, index.segmentCount());
+
+  LaneMatch match;
+  ASSERT_TRUE(index.match(3.5, 25.0, match));
+  EXPECT_EQ(1, match.intersection_id);
+  EXPECT_EQ(2, match.lane_id);
+  EXPECT_NEAR(25.0, match.downtrack, 0.00001);
+  EXPECT_NEAR(-0.5, match.crosstrack, 0.00001);  // East of a northbound lane is to its right
+
+  ASSERT_TRUE(index.match(1008.0, 5.0, match));
+  EXPECT_EQ(2, match.intersection_id);
+  EXPECT_EQ(4, match.lane_id);
+  EXPECT_NEAR(1.0, match.crosstrack, 0.00001);
+
+  // Outside of every lane
+  EXPECT_FALSE(index.match(11.0, 5.0, match));
+  EXPECT_FALSE(index.match(1.0, 45.0, match));
+  EXPECT_FALSE(index.match(500.0, 5.0, match));
+}
+
+TEST(LaneIndex, manyLanes)
+{
+  // Enough segments for a multi level tree
+  std::vector<std::shared_ptr<const IntersectionGeometry>> intersections;
+  for (uint16_t i = 0; i < 50; i++)
+  {
+    intersections.push_back(makeGrid(i, i * 100.0, 10, 20));
+  }
+  LaneIndex index(intersections);
+
+  LaneMatch match;
+  for (uint16_t i = 0; i < 50; i++)
+  {
+    ASSERT_TRUE(index.match(i * 100.0 + 27.2, 123.0, match));
+    EXPECT_EQ(i, match.intersection_id);
+    EXPECT_EQ(10, match.lane_id);
+    EXPECT_NEAR(123.0, match.downtrack, 0.00001);
+  }
+}
+
+TEST(LaneIndex, empty)
+{
+  LaneIndex index(std::vector<std::shared_ptr<const IntersectionGeometry>>{});
+  LaneMatch match;
+  EXPECT_EQ(0, index.segmentCount());
+  EXPECT_FALSE(index.match(0.0, 0.0, match));
+}
+
+}  // namespace j2735_convertor
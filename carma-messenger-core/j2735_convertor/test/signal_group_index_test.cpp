@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/signal_group_index.h>
+
+namespace j2735_convertor
+{
+constexpr uint16_t STRAIGHT = 1;
+constexpr uint16_t LEFT = 2;
+
+j2735_msgs::Connection makeConnection(uint8_t connecting_lane, uint16_t maneuvers, uint8_t signal_group)
+{
+  j2735_msgs::Connection connection;
+  connection.connecting_lane.lane = connecting_lane;
+  connection.connecting_lane.maneuver.maneuvers = maneuvers;
+  connection.connecting_lane.maneuver_exists = true;
+  connection.signal_group = signal_group;
+  connection.signal_group_exists = true;
+  return connection;
+}
+
+cav_msgs::MapData makeConnectedMap(uint8_t revision, uint8_t straight_signal_group)
+{
+  cav_msgs::MapData map;
+  cav_msgs::IntersectionGeometry geometry;
+  geometry.id.id = 9001;
+  geometry.revision = revision;
+
+  cav_msgs::GenericLane lane;
+  lane.lane_id = 1;
+  lane.connect_to_list.push_back(makeConnection(10, STRAIGHT, straight_signal_group));
+  lane.connect_to_list.push_back(makeConnection(11, LEFT, 4));
+  j2735_msgs::Connection unsignalized = makeConnection(12, STRAIGHT, 0);
+  unsignalized.signal_group_exists = false;
+  lane.connect_to_list.push_back(unsignalized);
+  geometry.lane_list.push_back(lane);
+
+  lane.lane_id = 10;  // Egress lanes have no connections
+  lane.connect_to_list.clear();
+  geometry.lane_list.push_back(lane);
+
+  map.intersections.push_back(geometry);
+  return map;
+}
+
+cav_msgs::SPAT makeSignalSpat(uint16_t intersection_id, const std::vector<uint8_t>& signal_groups)
+{
+  cav_msgs::SPAT spat;
+  cav_msgs::IntersectionState state;
+  state.id.id = intersection_id;
+  for (uint8_t signal_group : signal_groups)
+  {
+    cav_msgs::MovementState movement;
+    movement.signal_group = signal_group;
+    movement.movement_event_list.resize(1);
+    movement.movement_event_list[0].timing.min_end_time = signal_group;
+    state.movement_list.push_back(movement);
+  }
+  spat.intersection_state_list.push_back(state);
+  return spat;
+}
+
+TEST(SignalGroupIndex, laneToSignalGroup)
+{
+  SignalGroupIndex index;
+  ASSERT_TRUE(index.updateMap(makeConnectedMap(1, 2)));
+  EXPECT_FALSE(index.updateMap(makeConnectedMap(1, 2)));
+
+  uint8_t signal_group = 0;
+  ASSERT_TRUE(index.getSignalGroup(9001, 1, STRAIGHT, signal_group));
+  EXPECT_EQ(2, signal_group);
+  ASSERT_TRUE(index.getSignalGroup(9001, 1, LEFT, signal_group));
+  EXPECT_EQ(4, signal_group);
+  ASSERT_TRUE(index.getSignalGroup(9001, 1, 0, signal_group));  // Any maneuver
+  EXPECT_EQ(2, signal_group);
+  EXPECT_FALSE(index.getSignalGroup(9001, 1, STRAIGHT | LEFT, signal_group));
+  EXPECT_FALSE(index.getSignalGroup(9001, 10, 0, signal_group));
+  EXPECT_FALSE(index.getSignalGroup(1234, 1, 0, signal_group));
+
+  EXPECT_EQ(2, index.getConnections(9001).size());  // The unsignalized connection is not indexed
+
+  // A new revision replaces the connections
+  ASSERT_TRUE(index.updateMap(makeConnectedMap(2, 6)));
+  ASSERT_TRUE(index.getSignalGroup(9001, 1, STRAIGHT, signal_group));
+  EXPECT_EQ(6, signal_group);
+}
+
+TEST(SignalGroupIndex, laneMovementState)
+{
+  SignalGroupIndex index;
+  index.updateMap(makeConnectedMap(1, 2));
+
+  cav_msgs::MovementState state;
+  EXPECT_FALSE(index.getLaneMovementState(9001, 1, STRAIGHT, state));
+
+  index.updateSpat(makeSignalSpat(9001, { 2, 4 }));
+  ASSERT_TRUE(index.getLaneMovementState(9001, 1, STRAIGHT, state));
+  EXPECT_EQ(2, state.signal_group);
+  ASSERT_TRUE(index.getLaneMovementState(9001, 1, LEFT, state));
+  EXPECT_EQ(4, state.signal_group);
+  EXPECT_NEAR(4.0, state.movement_event_list[0].timing.min_end_time, 0.00001);
+
+  // Signal groups missing from the latest SPAT are forgotten
+  index.updateSpat(makeSignalSpat(9001, { 4 }));
+  EXPECT_FALSE(index.getLaneMovementState(9001, 1, STRAIGHT, state));
+  ASSERT_TRUE(index.getMovementState(9001, 4, state));
+  EXPECT_EQ(4, state.signal_group);
+
+  // Other intersections are not affected
+  index.updateSpat(makeSignalSpat(9002, { 2 }));
+  EXPECT_TRUE(index.getMovementState(9001, 4, state));
+  EXPECT_FALSE(index.getLaneMovementState(9002, 1, STRAIGHT, state));
+}
+
+}  // namespace j2735_convertor
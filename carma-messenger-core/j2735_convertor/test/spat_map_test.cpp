@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/spat_convertor.h>
+#include <j2735_convertor/spat_delta_convertor.h>
+#include <j2735_convertor/map_convertor.h>
+
+namespace j2735_convertor
+{
+j2735_msgs::SPAT makeSpat(size_t movement_count, uint16_t min_end_time)
+{
+  j2735_msgs::SPAT spat;
+  j2735_msgs::IntersectionState state;
+  state.id.id = 9001;
+  state.time_stamp = 2500;
+  for (size_t i = 0; i < movement_count; i++)
+  {
+    j2735_msgs::MovementState movement;
+    movement.signal_group = i + 1;
+    j2735_msgs::MovementEvent event;
+    event.timing.min_end_time = min_end_time;
+    movement.state_time_speed.movement_event_list.push_back(event);
+    state.states.movement_list.push_back(movement);
+  }
+  spat.intersections.intersection_state_list.push_back(state);
+  return spat;
+}
+
+TEST(SPATConvertor, convertIntoReusedMessage)
+{
+  cav_msgs::SPAT reused;
+
+  SPATConvertor::convert(makeSpat(4, 100), reused);
+  ASSERT_EQ(4, reused.intersection_state_list[0].movement_list.size());
+
+  // Converting a smaller SPAT into the same output must drop the extra movements and overwrite the rest
+  SPATConvertor::convert(makeSpat(2, 250), reused);
+
+  ASSERT_EQ(1, reused.intersection_state_list.size());
+  ASSERT_EQ(2, reused.intersection_state_list[0].movement_list.size());
+  EXPECT_EQ(9001, reused.intersection_state_list[0].id.id);
+  EXPECT_NEAR(2.5, reused.intersection_state_list[0].time_stamp, 0.00001);
+  for (size_t i = 0; i < 2; i++)
+  {
+    const cav_msgs::MovementState& movement = reused.intersection_state_list[0].movement_list[i];
+    EXPECT_EQ(i + 1, movement.signal_group);
+    ASSERT_EQ(1, movement.movement_event_list.size());
+    EXPECT_NEAR(25.0, movement.movement_event_list[0].timing.min_end_time, 0.00001);
+  }
+}
+
+TEST(MapConvertor, convertIntoReusedMessage)
+{
+  j2735_msgs::MapData map;
+  j2735_msgs::IntersectionGeometry geometry;
+  geometry.id.id = 9001;
+  j2735_msgs::GenericLane lane;
+  lane.lane_id = 3;
+  j2735_msgs::NodeXY node;
+  node.delta.choice = j2735_msgs::NodeOffsetPointXY::NODE_XY1;
+  node.delta.node_xy1.x = 150;
+  node.delta.node_xy1.y = -50;
+  lane.node_list.nodes.node_set_xy.push_back(node);
+  lane.node_list.nodes.node_set_xy.push_back(node);
+  geometry.lane_set.lane_list.push_back(lane);
+  map.intersections.push_back(geometry);
+
+  cav_msgs::MapData reused;
+  MapConvertor::convert(map, reused);
+
+  // Switch the second node to a lat/lon offset. Stale x/y values must not survive the reuse.
+  j2735_msgs::NodeXY& second = map.intersections[0].lane_set.lane_list[0].node_list.nodes.node_set_xy[1];
+  second.delta.choice = j2735_msgs::NodeOffsetPointXY::NODE_LATLON;
+  second.delta.node_latlon.latitude = 450000000;
+  second.delta.node_latlon.longitude = 400000000;
+
+  MapConvertor::convert(map, reused);
+
+  const auto& nodes = reused.intersections[0].lane_list[0].node_list.nodes.node_set_xy;
+  ASSERT_EQ(2, nodes.size());
+  EXPECT_NEAR(1.5, nodes[0].delta.x, 0.00001);
+  EXPECT_NEAR(-0.5, nodes[0].delta.y, 0.00001);
+  EXPECT_NEAR(0.0, nodes[1].delta.x, 0.00001);
+  EXPECT_NEAR(45.0, nodes[1].delta.latitude, 0.00001);
+}
+
+TEST(SPATDeltaConvertor, publishOnlyChangedMovements)
+{
+  SPATDeltaConvertor convertor(3);
+  ros::Time now(1000, 0);
+  cav_msgs::SPAT full, delta;
+
+  // The first SPAT of an intersection is always a keyframe
+  j2735_msgs::SPAT spat = makeSpat(3, 100);
+  ASSERT_TRUE(convertor.convert(spat, now, full, delta));
+  ASSERT_EQ(1, delta.intersection_state_list.size());
+  EXPECT_EQ(3, delta.intersection_state_list[0].movement_list.size());
+
+  // An identical SPAT produces no delta but still a full SPAT
+  EXPECT_FALSE(convertor.convert(spat, now, full, delta));
+  EXPECT_TRUE(delta.intersection_state_list.empty());
+  ASSERT_EQ(3, full.intersection_state_list[0].movement_list.size());
+
+  // Changing a single movement only reports that movement
+  spat.intersections.intersection_state_list[0].states.movement_list[1].state_time_speed.movement_event_list[0]
+      .timing.min_end_time = 200;
+  ASSERT_TRUE(convertor.convert(spat, now, full, delta));
+  ASSERT_EQ(1, delta.intersection_state_list[0].movement_list.size());
+  EXPECT_EQ(2, delta.intersection_state_list[0].movement_list[0].signal_group);
+  EXPECT_NEAR(20.0, delta.intersection_state_list[0].movement_list[0].movement_event_list[0].timing.min_end_time,
+              0.00001);
+  EXPECT_NEAR(20.0, full.intersection_state_list[0].movement_list[1].movement_event_list[0].timing.min_end_time,
+              0.00001);
+  EXPECT_NEAR(10.0, full.intersection_state_list[0].movement_list[0].movement_event_list[0].timing.min_end_time,
+              0.00001);
+
+  // The third SPAT after the keyframe is a keyframe again
+  ASSERT_TRUE(convertor.convert(spat, now, full, delta));
+  EXPECT_EQ(3, delta.intersection_state_list[0].movement_list.size());
+}
+
+TEST(SPATDeltaConvertor, keyframeOnMovementSetChange)
+{
+  SPATDeltaConvertor convertor(100);
+  ros::Time now(1000, 0);
+  cav_msgs::SPAT full, delta;
+
+  convertor.convert(makeSpat(3, 100), now, full, delta);
+  EXPECT_FALSE(convertor.convert(makeSpat(3, 100), now, full, delta));
+
+  // Removing a signal group sends the full intersection so subscribers can drop it
+  ASSERT_TRUE(convertor.convert(makeSpat(2, 100), now, full, delta));
+  EXPECT_EQ(2, delta.intersection_state_list[0].movement_list.size());
+  EXPECT_EQ(2, full.intersection_state_list[0].movement_list.size());
+
+  // A revision change is a keyframe as well
+  j2735_msgs::SPAT spat = makeSpat(2, 100);
+  spat.intersections.intersection_state_list[0].revision = 1;
+  ASSERT_TRUE(convertor.convert(spat, now, full, delta));
+  EXPECT_EQ(2, delta.intersection_state_list[0].movement_list.size());
+}
+
+TEST(SPATDeltaConvertor, publishHeaderChanges)
+{
+  SPATDeltaConvertor convertor(100);
+  ros::Time now(1000, 0);
+  cav_msgs::SPAT full, delta;
+  j2735_msgs::SPAT spat = makeSpat(3, 100);
+  convertor.convert(spat, now, full, delta);
+
+  // A new time stamp alone is not reported
+  spat.intersections.intersection_state_list[0].time_stamp = 2600;
+  EXPECT_FALSE(convertor.convert(spat, now, full, delta));
+
+  // Enabling a lane reports the intersection without movement states
+  spat.intersections.intersection_state_list[0].enabled_lanes_exists = true;
+  spat.intersections.intersection_state_list[0].enabled_lanes.lane_id_list.push_back(4);
+  ASSERT_TRUE(convertor.convert(spat, now, full, delta));
+  ASSERT_EQ(1, delta.intersection_state_list.size());
+  EXPECT_TRUE(delta.intersection_state_list[0].movement_list.empty());
+  ASSERT_EQ(1, delta.intersection_state_list[0].lane_id_list.size());
+  EXPECT_EQ(4, delta.intersection_state_list[0].lane_id_list[0]);
+  EXPECT_FALSE(convertor.convert(spat, now, full, delta));
+}
+
+TEST(SPATDeltaConvertor, forgetMissingIntersections)
+{
+  SPATDeltaConvertor convertor(100);
+  cav_msgs::SPAT full, delta;
+  ros::Time now(1000, 0);
+  j2735_msgs::SPAT first = makeSpat(3, 100);
+  j2735_msgs::SPAT second = makeSpat(3, 100);
+  second.intersections.intersection_state_list[0].id.id = 9002;
+  j2735_msgs::SPAT both = makeSpat(3, 100);
+  both.intersections.intersection_state_list.push_back(second.intersections.intersection_state_list[0]);
+
+  // Several intersections in range at 10 Hz each are all kept, whether they share a SPAT or not
+  for (int i = 0; i < 300; i++)
+  {
+    now = now + ros::Duration(0.05);
+    convertor.convert(i % 3 == 0 ? both : i % 2 ? first : second, now, full, delta);
+  }
+  EXPECT_EQ(2, convertor.intersectionCount());
+
+  // The first intersection is dropped once it was not received for MAX_AGE_SEC
+  ros::Time last_first = now;
+  while (now - last_first <= ros::Duration(SPATDeltaConvertor::MAX_AGE_SEC + 1.0))
+  {
+    now = now + ros::Duration(0.1);
+    convertor.convert(second, now, full, delta);
+  }
+  EXPECT_EQ(1, convertor.intersectionCount());
+
+  // A dropped intersection starts again with a keyframe
+  ASSERT_TRUE(convertor.convert(first, now, full, delta));
+  EXPECT_EQ(3, delta.intersection_state_list[0].movement_list.size());
+  EXPECT_EQ(2, convertor.intersectionCount());
+}
+
+}  // namespace j2735_convertor
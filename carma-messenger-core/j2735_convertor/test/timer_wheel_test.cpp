@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/timer_wheel.h>
+
+namespace j2735_convertor
+{
+TEST(TimerWheel, fireOnExpiry)
+{
+  TimerWheel wheel(100);
+  std::vector<uint64_t> expired;
+
+  wheel.add(1, 105);             // Level 0
+  wheel.add(2, 100 + 200);       // Level 1
+  wheel.add(3, 100 + 5000);      // Level 2
+  wheel.add(4, 100 + 20000000);  // Overflow
+  wheel.add(5, 50);              // Already due
+  EXPECT_EQ(5, wheel.size());
+
+  wheel.advance(104, expired);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(5, expired[0]);
+
+  expired.clear();
+  wheel.advance(105, expired);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(1, expired[0]);
+
+  expired.clear();
+  wheel.advance(299, expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.advance(300, expired);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(2, expired[0]);
+
+  expired.clear();
+  wheel.advance(5099, expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.advance(5100, expired);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(3, expired[0]);
+
+  expired.clear();
+  wheel.advance(20000099, expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.advance(20000100, expired);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(4, expired[0]);
+  EXPECT_EQ(0, wheel.size());
+}
+
+TEST(TimerWheel, matchesSortedExpiries)
+{
+  TimerWheel wheel(12345);
+  std::vector<uint64_t> expiries;
+  uint64_t seed = 1;
+  for (uint64_t id = 0; id < 2000; id++)
+  {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint64_t expiry = 12345 + 1 + (seed >> 33) % 300000;
+    expiries.push_back(expiry);
+    wheel.add(id, expiry);
+  }
+
+  // Every timer fires exactly at its expiry when advancing in uneven steps
+  std::vector<uint64_t> expired;
+  size_t fired = 0;
+  for (uint64_t now = 12345; fired < expiries.size(); now += 1 + now % 7)
+  {
+    expired.clear();
+    uint64_t previous = wheel.now();
+    wheel.advance(now, expired);
+    for (uint64_t id : expired)
+    {
+      EXPECT_GT(expiries[id], previous);
+      EXPECT_LE(expiries[id], now);
+    }
+    fired += expired.size();
+  }
+  EXPECT_EQ(expiries.size(), fired);
+  EXPECT_EQ(0, wheel.size());
+}
+
+TEST(TimerWheel, jumpFromSimTimeZero)
+{
+  // Created before the first sim time, the first advance goes straight to the wall clock
+  TimerWheel wheel(0);
+  std::vector<uint64_t> expired;
+  const uint64_t start = 1600000000;
+  wheel.add(1, start + 30);
+  wheel.add(2, start - 5);
+  wheel.add(3, start - 10);
+  wheel.add(4, start + 100000000);
+
+  wheel.advance(start, expired);
+  EXPECT_EQ(start, wheel.now());
+  ASSERT_EQ(2, expired.size());
+  EXPECT_EQ(3, expired[0]);  // In order of expiry
+  EXPECT_EQ(2, expired[1]);
+  EXPECT_EQ(2, wheel.size());
+
+  // The remaining timers were placed relative to the new current tick
+  expired.clear();
+  wheel.advance(start + 29, expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.advance(start + 30, expired);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(1, expired[0]);
+
+  expired.clear();
+  wheel.advance(start + 100000000, expired);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(4, expired[0]);
+  EXPECT_EQ(0, wheel.size());
+}
+
+}  // namespace j2735_convertor
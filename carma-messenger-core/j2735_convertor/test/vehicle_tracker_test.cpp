@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gmock/gmock.h>
+#include <j2735_convertor/vehicle_tracker.h>
+
+namespace j2735_convertor
+{
+cav_msgs::BSM makeBSM(uint32_t id, uint8_t msg_count)
+{
+  cav_msgs::BSM bsm;
+  bsm.core_data.msg_count = msg_count;
+  bsm.core_data.id.resize(4);
+  for (size_t i = 0; i < 4; i++)
+  {
+    bsm.core_data.id[i] = (id >> (24 - 8 * i)) & 0xFF;
+  }
+  return bsm;
+}
+
+TEST(VehicleTracker, msgCountDedup)
+{
+  VehicleTracker tracker(4, ros::Duration(1.0));
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(0x10ABCDEF, 126), ros::Time(10.0)));
+  EXPECT_EQ(VehicleTracker::Update::DUPLICATE, tracker.update(makeBSM(0x10ABCDEF, 126), ros::Time(10.05)));
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(0x10ABCDEF, 127), ros::Time(10.1)));
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(0x10ABCDEF, 0), ros::Time(10.2)));
+  // Reordered across the wrap of msgCnt
+  EXPECT_EQ(VehicleTracker::Update::DUPLICATE, tracker.update(makeBSM(0x10ABCDEF, 127), ros::Time(10.25)));
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(0x10ABCDEF, 5), ros::Time(10.3)));
+  // A vehicle heard again after the maximum age may have restarted its count
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(0x10ABCDEF, 1), ros::Time(11.5)));
+
+  const TrackedVehicle* vehicle = tracker.find(0x10ABCDEF);
+  ASSERT_NE(nullptr, vehicle);
+  EXPECT_EQ(5u, vehicle->bsm_count);
+  EXPECT_EQ(1, vehicle->bsm.core_data.msg_count);
+  EXPECT_EQ(2u, tracker.duplicates());
+
+  cav_msgs::BSM no_id;
+  EXPECT_EQ(VehicleTracker::Update::INVALID, tracker.update(no_id, ros::Time(11.5)));
+}
+
+TEST(VehicleTracker, capacityAndExpiry)
+{
+  VehicleTracker tracker(3, ros::Duration(1.0));
+  EXPECT_EQ(3u, tracker.capacity());
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(1, 0), ros::Time(1.0)));
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(2, 0), ros::Time(1.5)));
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(3, 0), ros::Time(2.0)));
+  EXPECT_EQ(VehicleTracker::Update::FULL, tracker.update(makeBSM(4, 0), ros::Time(2.0)));
+  EXPECT_EQ(1u, tracker.dropped());
+  EXPECT_EQ(3u, tracker.size());
+
+  EXPECT_EQ(0u, tracker.expire(ros::Time(2.0)));
+  EXPECT_EQ(2u, tracker.expire(ros::Time(2.6)));
+  EXPECT_EQ(nullptr, tracker.find(1));
+  EXPECT_EQ(nullptr, tracker.find(2));
+  EXPECT_NE(nullptr, tracker.find(3));
+  EXPECT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(4, 0), ros::Time(2.6)));
+  EXPECT_EQ(2u, tracker.size());
+}
+
+TEST(VehicleTracker, probeSequencesSurviveRemoval)
+{
+  // Fill and drain the table in rounds so vehicles collide, wrap around and get shifted back after removals
+  VehicleTracker tracker(64, ros::Duration(1.0));
+  std::vector<uint32_t> ids;
+  for (uint32_t round = 0; round < 8; round++)
+  {
+    for (uint32_t i = 0; i < 64; i++)
+    {
+      uint32_t id = round * 1000003u + i * 7919u;
+      ros::Time now(round * 10.0 + (i % 2) * 2.0);
+      ASSERT_EQ(VehicleTracker::Update::ACCEPTED, tracker.update(makeBSM(id, 0), now));
+    }
+    // Expire every other vehicle and check the rest are still found
+    EXPECT_EQ(32u, tracker.expire(ros::Time(round * 10.0 + 2.5)));
+    for (uint32_t i = 0; i < 64; i++)
+    {
+      uint32_t id = round * 1000003u + i * 7919u;
+      EXPECT_EQ(i % 2 == 1, tracker.find(id) != nullptr) << "round " << round << " vehicle " << i;
+    }
+    EXPECT_EQ(32u, tracker.expire(ros::Time(round * 10.0 + 9.0)));
+    EXPECT_EQ(0u, tracker.size());
+  }
+}
+
+TEST(VehicleTracker, correlation)
+{
+  VehicleTracker tracker(4, ros::Duration(1.0));
+  tracker.update(makeBSM(0x10ABCDEF, 0), ros::Time(1.0));
+  EXPECT_TRUE(tracker.correlate("10abcdef", "USDOT-45100"));
+  EXPECT_FALSE(tracker.correlate("00000001", "USDOT-45101"));
+  EXPECT_FALSE(tracker.correlate("10ABCDE", "USDOT-45100"));
+  EXPECT_FALSE(tracker.correlate("10ABCDEG", "USDOT-45100"));
+  EXPECT_EQ("USDOT-45100", tracker.find(0x10ABCDEF)->static_id);
+
+  uint32_t id;
+  ASSERT_TRUE(VehicleTracker::parseBsmId("10ABCDEF", id));
+  EXPECT_EQ(0x10ABCDEFu, id);
+
+  size_t visited = 0;
+  tracker.forEach([&visited](const TrackedVehicle& vehicle) { visited++; });
+  EXPECT_EQ(1u, visited);
+}
+}  // namespace j2735_convertor
@@ -0,0 +1,119 @@
+#pragma once
+
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <ros/time.h>
+#include <boost/uuid/random_generator.hpp>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace truck_inspection_plugin
+{
+
+    // an inspection request to send to one truck
+    struct InspectionAttempt
+    {
+        std::string vin;
+        std::string static_id;
+        std::string plan_id;
+        // 1 for the first request, counting up with every retry
+        int attempt = 0;
+        // time the truck has to answer this request
+        ros::Duration timeout;
+    };
+
+    // outcome of the inspection of one truck
+    struct InspectionOutcome
+    {
+        std::string vin;
+        std::string static_id;
+        std::string plan_id;
+        bool success = false;
+        int attempts = 0;
+        // time from the first request to the safety log, zero on failure
+        ros::Duration latency;
+    };
+
+    /**
+     * @class InspectionScheduler
+     * @brief Runs the inspection request/response sessions of many trucks at once
+     *
+     * Every truck under inspection has its own session with a plan id. A request not answered within its timeout is
+     * sent again with the timeout doubled up to max_timeout, and the session fails after max_attempts requests.
+     * Sending the requests is left to the caller, the scheduler only decides when.
+     */
+    class InspectionScheduler
+    {
+
+    public:
+
+        InspectionScheduler(size_t max_sessions, const ros::Duration& timeout, const ros::Duration& max_timeout, int max_attempts);
+
+        /**
+         * @brief Start the inspection of a truck
+         * @return the first request to send, or an empty optional if the truck is already under inspection or too
+         *         many inspections are running
+         */
+        std::optional<InspectionAttempt> start(const std::string& vin, const std::string& static_id, const ros::Time& now);
+
+        /**
+         * @brief Collect the retries due and the sessions which ran out of attempts
+         * @param retries Receives the requests to send again
+         * @param failures Receives the failed inspections, which are removed from the scheduler
+         */
+        void poll(const ros::Time& now, std::vector<InspectionAttempt>& retries, std::vector<InspectionOutcome>& failures);
+
+        /**
+         * @brief Finish the inspection answered by a safety log
+         * @param plan_id Plan id of the answer, matched before the VIN as trucks may not echo it
+         * @return the result, or an empty optional if no inspection of the truck is running
+         */
+        std::optional<InspectionOutcome> complete(const std::string& plan_id, const std::string& vin, const ros::Time& now);
+
+        // returns the plan id of the running inspection of a truck, or an empty string
+        std::string planId(const std::string& vin) const;
+
+        size_t size() const;
+
+    private:
+
+        struct Session
+        {
+            std::string static_id;
+            std::string plan_id;
+            ros::Time started;
+            ros::Time deadline;
+            int attempts = 0;
+            ros::Duration timeout;
+        };
+
+        // build the request of the next attempt and advance the session deadline
+        InspectionAttempt nextAttempt(const std::string& vin, Session& session, const ros::Time& now);
+
+        size_t max_sessions_;
+        ros::Duration timeout_;
+        ros::Duration max_timeout_;
+        int max_attempts_;
+        // running sessions keyed by VIN
+        std::unordered_map<std::string, Session> sessions_;
+        boost::uuids::random_generator uuid_generator_;
+
+    };
+
+}
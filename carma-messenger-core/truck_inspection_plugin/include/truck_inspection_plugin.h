@@ -16,14 +16,17 @@
  * the License.
  */
 
-#include <sstream>
-
 #include <ros/ros.h>
 #include <std_msgs/String.h>
 #include <std_srvs/Trigger.h>
 #include <carma_utils/CARMAUtils.h>
 #include <cav_msgs/MobilityRequest.h>
 #include <cav_msgs/MobilityOperation.h>
+#include <Strategy_Params.h>
+#include <truck_inspection_plugin/InspectionResult.h>
+#include <truck_inspection_plugin/RequestInspection.h>
+#include "truck_session_table.h"
+#include "inspection_scheduler.h"
 
 namespace truck_inspection_plugin
 {
@@ -50,11 +53,15 @@ namespace truck_inspection_plugin
         ros::Publisher content_pub_;
         ros::Publisher cav_detection_pub_;
 
+        // publisher for the outcome and latency of inspections
+        ros::Publisher inspection_result_pub_;
+
         // subscriber for incoming mobility operation messages
         ros::Subscriber mo_sub_;
 
-        // service server for sending inspection request
+        // service servers for inspecting every truck in range and selected trucks
         ros::ServiceServer inspection_request_service_server_;
+        ros::ServiceServer request_inspection_service_server_;
 
         // initialize this node
         void initialize();
@@ -64,16 +71,46 @@ namespace truck_inspection_plugin
 
         // callbacks for the service
         bool inspectionRequestCallback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp);
+        bool requestInspectionCallback(RequestInspectionRequest& req, RequestInspectionResponse& resp);
+
+        // start the inspections of trucks in range, returns the number of trucks under inspection
+        size_t startInspections(const std::vector<std::string>& vins, std::vector<std::string>& plan_ids, std::string& message);
 
-        // helper function to verify safety log
-        bool isSafetyLogValid(const std::string& log);
+        // helper functions to publish an inspection request and the outcome of an inspection
+        void sendInspectionRequest(const InspectionAttempt& attempt);
+        void publishInspectionResult(const InspectionOutcome& result);
+
+        // helper function to verify a safety log from the result of parsing it into params
+        bool isSafetyLogValid(cpp_message::Strategy_Params_Error parse_result, const cpp_message::Strategy_Params& params) const;
 
         // helper function to check ads_auto_status
         bool isADSAutoEngaged(const std::string& log);
 
+        // helper function to identify the sending truck by the VIN of its parsed params, or by its static id
+        std::string truckId(const cav_msgs::MobilityOperation& msg, const cpp_message::Strategy_Params& params) const;
+
+        // safety info as published on truck_safety_info
+        static std::string safetyInfo(const TruckSession& session);
+
+        // send the latest safety log of every tracked truck to a new subscriber of truck_safety_info
+        void safetyInfoConnectCallback(const ros::SingleSubscriberPublisher& pub);
+
+        // drop the sessions of trucks out of range and retry unanswered inspection requests
+        bool spinCallback();
+
         int number_of_entries;
 
-        std::string safety_log_;
+        // trucks in range and their latest safety logs
+        std::shared_ptr<TruckSessionTable> sessions_;
+
+        // running inspections
+        std::shared_ptr<InspectionScheduler> scheduler_;
+
+        // static id of this vehicle, the sender of inspection requests
+        std::string host_id_;
+
+        // tokenizer reused for every incoming mobility operation
+        cpp_message::Strategy_Params safety_log_params_;
 
     };
 
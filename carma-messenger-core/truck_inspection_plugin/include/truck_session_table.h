@@ -0,0 +1,91 @@
+#pragma once
+
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <ros/time.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace truck_inspection_plugin
+{
+
+    // state of one truck in radio range, keyed by VIN
+    struct TruckSession
+    {
+        // safety log as received in strategy_params, empty until the truck answered an inspection request
+        std::string safety_log;
+        // mobility header timestamp of the message carrying the safety log
+        uint64_t safety_log_timestamp = 0;
+        // static id of the truck in mobility message headers, the recipient of inspection requests
+        std::string static_id;
+        ros::Time last_seen;
+    };
+
+    /**
+     * @class TruckSessionTable
+     * @brief Tracks the trucks in radio range and their latest safety log
+     *
+     * The table holds at most max_sessions trucks. A new truck arriving at a full table replaces the truck seen least
+     * recently, and trucks not heard from within the timeout are dropped by expire().
+     */
+    class TruckSessionTable
+    {
+
+    public:
+
+        TruckSessionTable(size_t max_sessions, const ros::Duration& timeout);
+
+        /**
+         * @brief Record a message from a truck, creating its session if needed
+         */
+        TruckSession& touch(const std::string& vin, const ros::Time& now);
+
+        /**
+         * @brief Record a safety log from a truck
+         * @return true if the log differs from the last one stored for this truck
+         */
+        bool updateSafetyLog(const std::string& vin, const std::string& safety_log, const ros::Time& now);
+
+        /**
+         * @brief Forget the stored safety log of a truck so its next log counts as changed
+         */
+        void clearSafetyLog(const std::string& vin);
+
+        /**
+         * @brief Drop the sessions not seen within the timeout
+         * @return number of dropped sessions
+         */
+        size_t expire(const ros::Time& now);
+
+        // returns the session of a truck, or nullptr if it is not tracked
+        const TruckSession* find(const std::string& vin) const;
+
+        // returns the VINs of all tracked trucks
+        std::vector<std::string> vins() const;
+
+        size_t size() const;
+
+    private:
+
+        size_t max_sessions_;
+        ros::Duration timeout_;
+        std::unordered_map<std::string, TruckSession> sessions_;
+
+    };
+
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <boost/uuid/uuid_io.hpp>
+#include "inspection_scheduler.h"
+
+namespace truck_inspection_plugin
+{
+
+    InspectionScheduler::InspectionScheduler(size_t max_sessions, const ros::Duration& timeout, const ros::Duration& max_timeout, int max_attempts)
+        : max_sessions_(max_sessions), timeout_(timeout), max_timeout_(std::max(timeout, max_timeout)), max_attempts_(std::max(max_attempts, 1))
+    {
+    }
+
+    std::optional<InspectionAttempt> InspectionScheduler::start(const std::string& vin, const std::string& static_id, const ros::Time& now)
+    {
+        if(sessions_.count(vin) || sessions_.size() >= max_sessions_)
+        {
+            return std::nullopt;
+        }
+        Session& session = sessions_[vin];
+        session.static_id = static_id;
+        session.plan_id = boost::uuids::to_string(uuid_generator_());
+        session.started = now;
+        return nextAttempt(vin, session, now);
+    }
+
+    InspectionAttempt InspectionScheduler::nextAttempt(const std::string& vin, Session& session, const ros::Time& now)
+    {
+        session.timeout = session.attempts == 0 ? timeout_ : std::min(session.timeout * 2.0, max_timeout_);
+        session.attempts++;
+        session.deadline = now + session.timeout;
+
+        InspectionAttempt attempt;
+        attempt.vin = vin;
+        attempt.static_id = session.static_id;
+        attempt.plan_id = session.plan_id;
+        attempt.attempt = session.attempts;
+        attempt.timeout = session.timeout;
+        return attempt;
+    }
+
+    void InspectionScheduler::poll(const ros::Time& now, std::vector<InspectionAttempt>& retries, std::vector<InspectionOutcome>& failures)
+    {
+        for(auto it = sessions_.begin(); it != sessions_.end();)
+        {
+            Session& session = it->second;
+            if(now < session.deadline)
+            {
+                ++it;
+            } else if(session.attempts < max_attempts_) {
+                retries.push_back(nextAttempt(it->first, session, now));
+                ++it;
+            } else {
+                InspectionOutcome result;
+                result.vin = it->first;
+                result.static_id = session.static_id;
+                result.plan_id = session.plan_id;
+                result.attempts = session.attempts;
+                failures.push_back(result);
+                it = sessions_.erase(it);
+            }
+        }
+    }
+
+    std::optional<InspectionOutcome> InspectionScheduler::complete(const std::string& plan_id, const std::string& vin, const ros::Time& now)
+    {
+        auto it = sessions_.end();
+        if(!plan_id.empty())
+        {
+            it = std::find_if(sessions_.begin(), sessions_.end(), [&plan_id](const auto& entry) {
+                return entry.second.plan_id == plan_id;
+            });
+        }
+        if(it == sessions_.end())
+        {
+            it = sessions_.find(vin);
+        }
+        if(it == sessions_.end())
+        {
+            return std::nullopt;
+        }
+
+        InspectionOutcome result;
+        result.vin = it->first;
+        result.static_id = it->second.static_id;
+        result.plan_id = it->second.plan_id;
+        result.success = true;
+        result.attempts = it->second.attempts;
+        result.latency = now - it->second.started;
+        sessions_.erase(it);
+        return result;
+    }
+
+    std::string InspectionScheduler::planId(const std::string& vin) const
+    {
+        auto it = sessions_.find(vin);
+        return it == sessions_.end() ? std::string() : it->second.plan_id;
+    }
+
+    size_t InspectionScheduler::size() const
+    {
+        return sessions_.size();
+    }
+
+}
@@ -15,6 +15,8 @@
  */
 
 
+#include <algorithm>
+#include <functional>
 #include "truck_inspection_plugin.h"
 
 namespace truck_inspection_plugin
@@ -25,19 +27,28 @@ namespace truck_inspection_plugin
         nh_.reset(new ros::CARMANodeHandle());
         pnh_.reset(new ros::CARMANodeHandle("~"));
         pnh_->getParam("num_of_entries", number_of_entries);
+        int max_trucks = 16;
+        double truck_session_timeout = 60.0;
+        pnh_->param<int>("max_trucks", max_trucks, max_trucks);
+        pnh_->param<double>("truck_session_timeout", truck_session_timeout, truck_session_timeout);
+        sessions_.reset(new TruckSessionTable(std::max(max_trucks, 1), ros::Duration(truck_session_timeout)));
+        double inspection_timeout = 2.0, inspection_max_timeout = 8.0;
+        int inspection_max_attempts = 4;
+        pnh_->param<double>("inspection_timeout", inspection_timeout, inspection_timeout);
+        pnh_->param<double>("inspection_max_timeout", inspection_max_timeout, inspection_max_timeout);
+        pnh_->param<int>("inspection_max_attempts", inspection_max_attempts, inspection_max_attempts);
+        pnh_->param<std::string>("host_id", host_id_, host_id_);
+        scheduler_.reset(new InspectionScheduler(std::max(max_trucks, 1), ros::Duration(inspection_timeout),
+                                                 ros::Duration(inspection_max_timeout), inspection_max_attempts));
         mr_pub_ = nh_->advertise<cav_msgs::MobilityRequest>("mobility_request_outbound", 5);
         cav_detection_pub_ = nh_->advertise<std_msgs::String>("cav_truck_identified", 5);
-        content_pub_ = nh_->advertise<std_msgs::String>("truck_safety_info", 5);
+        // a UI subscribing after an inspection request gets the latest safety log of every truck in range
+        content_pub_ = nh_->advertise<std_msgs::String>("truck_safety_info", 5, boost::bind(&TruckInspectionPlugin::safetyInfoConnectCallback, this, _1));
+        inspection_result_pub_ = nh_->advertise<InspectionResult>("inspection_results", 20);
         mo_sub_ = nh_->subscribe("mobility_operation_inbound", 5, &TruckInspectionPlugin::mobilityOperationCallback, this);
         inspection_request_service_server_ = nh_->advertiseService("send_inspection_request", &TruckInspectionPlugin::inspectionRequestCallback, this);
-        ros::CARMANodeHandle::setSpinCallback([this]() -> bool {
-            if(!this->safety_log_.empty()) {
-                std_msgs::String msg_content;
-                msg_content.data = safety_log_;
-                content_pub_.publish(msg_content);
-            }
-            return true;
-        });
+        request_inspection_service_server_ = nh_->advertiseService("request_inspection", &TruckInspectionPlugin::requestInspectionCallback, this);
+        ros::CARMANodeHandle::setSpinCallback(std::bind(&TruckInspectionPlugin::spinCallback, this));
         ROS_INFO_STREAM("Truck inspection plugin is initialized...");
     }
 
@@ -49,12 +60,119 @@ namespace truck_inspection_plugin
 
     bool TruckInspectionPlugin::inspectionRequestCallback(std_srvs::TriggerRequest& req, std_srvs::TriggerResponse& resp)
     {
+        std::vector<std::string> plan_ids;
+        resp.success = startInspections(sessions_->vins(), plan_ids, resp.message) > 0;
+        return true;
+    }
+
+    bool TruckInspectionPlugin::requestInspectionCallback(RequestInspectionRequest& req, RequestInspectionResponse& resp)
+    {
+        resp.success = startInspections(req.vins.empty() ? sessions_->vins() : req.vins, resp.plan_ids, resp.message) > 0;
+        return true;
+    }
+
+    size_t TruckInspectionPlugin::startInspections(const std::vector<std::string>& vins, std::vector<std::string>& plan_ids, std::string& message)
+    {
+        ros::Time now = ros::Time::now();
+        size_t inspecting = 0;
+        std::vector<std::string> skipped;
+        for(const std::string& vin : vins)
+        {
+            const TruckSession* session = sessions_->find(vin);
+            if(!session)
+            {
+                plan_ids.push_back("");
+                skipped.push_back(vin);
+                continue;
+            }
+            std::optional<InspectionAttempt> attempt = scheduler_->start(vin, session->static_id, now);
+            if(attempt)
+            {
+                // the answer to this request is published even if the truck sends the same log again
+                sessions_->clearSafetyLog(vin);
+                sendInspectionRequest(*attempt);
+            }
+            // trucks already under inspection keep their running session
+            plan_ids.push_back(scheduler_->planId(vin));
+            if(plan_ids.back().empty())
+            {
+                skipped.push_back(vin);
+            } else {
+                inspecting++;
+            }
+        }
+
+        if(inspecting == 0)
+        {
+            message = vins.empty() ? "No truck in range" : "No requested truck can be inspected";
+        } else {
+            message = "Inspecting " + std::to_string(inspecting) + " trucks";
+        }
+        if(!skipped.empty())
+        {
+            message += ", not in range or too many inspections running:";
+            for(const std::string& vin : skipped)
+            {
+                message += " " + vin;
+            }
+        }
+        return inspecting;
+    }
+
+    void TruckInspectionPlugin::sendInspectionRequest(const InspectionAttempt& attempt)
+    {
+        uint64_t timestamp = ros::Time::now().toNSec() / 1000000;
         cav_msgs::MobilityRequest msg;
+        msg.header.sender_id = host_id_;
+        msg.header.recipient_id = attempt.static_id;
+        msg.header.plan_id = attempt.plan_id;
+        msg.header.timestamp = timestamp;
         msg.strategy = TruckInspectionPlugin::INSPECTION_STRATEGY;
+        msg.expiration = timestamp + attempt.timeout.toNSec() / 1000000;
         mr_pub_.publish(msg);
-        // reset safety log
-        this->safety_log_ = "";
-        resp.success = true;
+        ROS_DEBUG_STREAM("Inspection request " << attempt.attempt << " sent to " << attempt.vin << ", plan id " << attempt.plan_id);
+    }
+
+    void TruckInspectionPlugin::publishInspectionResult(const InspectionOutcome& result)
+    {
+        InspectionResult msg;
+        msg.vin = result.vin;
+        msg.static_id = result.static_id;
+        msg.plan_id = result.plan_id;
+        msg.success = result.success;
+        msg.attempts = result.attempts;
+        msg.latency = result.latency;
+        inspection_result_pub_.publish(msg);
+        if(result.success)
+        {
+            ROS_INFO_STREAM("Truck " << result.vin << " answered the inspection request after " << result.latency.toSec()
+                            << " s and " << result.attempts << " attempts");
+        } else {
+            ROS_WARN_STREAM("Truck " << result.vin << " did not answer " << result.attempts << " inspection requests");
+        }
+    }
+
+    bool TruckInspectionPlugin::spinCallback()
+    {
+        ros::Time now = ros::Time::now();
+        size_t expired = sessions_->expire(now);
+        if(expired > 0)
+        {
+            ROS_DEBUG_STREAM("Dropped " << expired << " trucks out of range, tracking " << sessions_->size());
+        }
+
+        std::vector<InspectionAttempt> retries;
+        std::vector<InspectionOutcome> failures;
+        scheduler_->poll(now, retries, failures);
+        for(const InspectionAttempt& attempt : retries)
+        {
+            sendInspectionRequest(attempt);
+        }
+        for(const InspectionOutcome& result : failures)
+        {
+            publishInspectionResult(result);
+        }
+        return true;
     }
 
     void TruckInspectionPlugin::mobilityOperationCallback(const cav_msgs::MobilityOperationConstPtr& msg)
@@ -62,11 +180,28 @@ namespace truck_inspection_plugin
         // if there is a truck around running CARMA
         if(msg->strategy == TruckInspectionPlugin::INSPECTION_STRATEGY)
         {
+            ros::Time now = ros::Time::now();
+            cpp_message::Strategy_Params_Error parse_result = safety_log_params_.parse(msg->strategy_params);
+            bool valid = isSafetyLogValid(parse_result, safety_log_params_);
+            std::string vin = truckId(*msg, safety_log_params_);
+            TruckSession& session = sessions_->touch(vin, now);
+            session.static_id = msg->header.sender_id;
             // if the incoming message contains a valid safety log
-            if(isSafetyLogValid(msg->strategy_params))
+            if(valid)
             {
-                safety_log_ = msg->strategy_params;
-                safety_log_ += ",timestamp:" + std::to_string(msg->header.timestamp);
+                // trucks repeat their log until inspected, only publish when it changes
+                if(sessions_->updateSafetyLog(vin, msg->strategy_params, now))
+                {
+                    session.safety_log_timestamp = msg->header.timestamp;
+                    std_msgs::String msg_content;
+                    msg_content.data = safetyInfo(session);
+                    content_pub_.publish(msg_content);
+                }
+                std::optional<InspectionOutcome> result = scheduler_->complete(msg->header.plan_id, vin, now);
+                if(result)
+                {
+                    publishInspectionResult(*result);
+                }
             } else {
                 std_msgs::String msg_out;
                 std::string k_v_pair = msg->strategy_params;
@@ -78,25 +213,46 @@ namespace truck_inspection_plugin
         }
     }
 
-    bool TruckInspectionPlugin::isSafetyLogValid(const std::string& log)
+    std::string TruckInspectionPlugin::safetyInfo(const TruckSession& session)
     {
-        // Check 1: if number of k-v pairs matches expectation
-        std::string temp;
-        int count = 0;
-        std::stringstream ss(log);
-        while(std::getline(ss, temp, ','))
+        return session.safety_log + ",timestamp:" + std::to_string(session.safety_log_timestamp);
+    }
+
+    void TruckInspectionPlugin::safetyInfoConnectCallback(const ros::SingleSubscriberPublisher& pub)
+    {
+        for(const std::string& vin : sessions_->vins())
         {
-            if(!temp.empty())
-            {
-                count++;
-            }
-            else
+            const TruckSession* session = sessions_->find(vin);
+            if(session && !session->safety_log.empty())
             {
-                // do not allow spaces in the safety log
-                return false;
+                std_msgs::String msg_content;
+                msg_content.data = safetyInfo(*session);
+                pub.publish(msg_content);
             }
         }
-        return count == this->number_of_entries;
+    }
+
+    std::string TruckInspectionPlugin::truckId(const cav_msgs::MobilityOperation& msg, const cpp_message::Strategy_Params& params) const
+    {
+        std::optional<std::string_view> vin = params.get("vin_number");
+        if(vin && !vin->empty())
+        {
+            return std::string(*vin);
+        }
+        return msg.header.sender_id;
+    }
+
+    bool TruckInspectionPlugin::isSafetyLogValid(cpp_message::Strategy_Params_Error parse_result, const cpp_message::Strategy_Params& params) const
+    {
+        // Check 1: if the log is a well formed list of k-v pairs, empty entries are not allowed
+        // A trailing comma or an entry without a colon, which the getline split accepted, are rejected as well, the UI
+        // cannot show such a log
+        if(parse_result != cpp_message::Strategy_Params_Error::NONE)
+        {
+            return false;
+        }
+        // Check 2: if number of k-v pairs matches expectation
+        return params.size() == static_cast<size_t>(this->number_of_entries);
     }
 
 }
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include "truck_session_table.h"
+
+namespace truck_inspection_plugin
+{
+
+    TruckSessionTable::TruckSessionTable(size_t max_sessions, const ros::Duration& timeout)
+        : max_sessions_(std::max<size_t>(max_sessions, 1)), timeout_(timeout)
+    {
+        sessions_.reserve(max_sessions_);
+    }
+
+    TruckSession& TruckSessionTable::touch(const std::string& vin, const ros::Time& now)
+    {
+        auto it = sessions_.find(vin);
+        if(it == sessions_.end())
+        {
+            // the table is small, a linear scan for the oldest session is cheaper than keeping an LRU list
+            if(sessions_.size() >= max_sessions_)
+            {
+                auto oldest = std::min_element(sessions_.begin(), sessions_.end(), [](const auto& a, const auto& b) {
+                    return a.second.last_seen < b.second.last_seen;
+                });
+                sessions_.erase(oldest);
+            }
+            it = sessions_.emplace(vin, TruckSession()).first;
+        }
+        it->second.last_seen = now;
+        return it->second;
+    }
+
+    bool TruckSessionTable::updateSafetyLog(const std::string& vin, const std::string& safety_log, const ros::Time& now)
+    {
+        TruckSession& session = touch(vin, now);
+        if(session.safety_log == safety_log)
+        {
+            return false;
+        }
+        session.safety_log = safety_log;
+        return true;
+    }
+
+    void TruckSessionTable::clearSafetyLog(const std::string& vin)
+    {
+        auto it = sessions_.find(vin);
+        if(it != sessions_.end())
+        {
+            it->second.safety_log.clear();
+        }
+    }
+
+    size_t TruckSessionTable::expire(const ros::Time& now)
+    {
+        size_t expired = 0;
+        for(auto it = sessions_.begin(); it != sessions_.end();)
+        {
+            if(now - it->second.last_seen > timeout_)
+            {
+                it = sessions_.erase(it);
+                expired++;
+            } else {
+                ++it;
+            }
+        }
+        return expired;
+    }
+
+    const TruckSession* TruckSessionTable::find(const std::string& vin) const
+    {
+        auto it = sessions_.find(vin);
+        return it == sessions_.end() ? nullptr : &it->second;
+    }
+
+    std::vector<std::string> TruckSessionTable::vins() const
+    {
+        std::vector<std::string> vins;
+        vins.reserve(sessions_.size());
+        for(const auto& entry : sessions_)
+        {
+            vins.push_back(entry.first);
+        }
+        return vins;
+    }
+
+    size_t TruckSessionTable::size() const
+    {
+        return sessions_.size();
+    }
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gtest/gtest.h>
+#include "inspection_scheduler.h"
+
+using namespace truck_inspection_plugin;
+
+TEST(InspectionSchedulerTest, TestConcurrentSessions)
+{
+    InspectionScheduler scheduler(2, ros::Duration(2.0), ros::Duration(8.0), 3);
+    auto first = scheduler.start("1FUJGBDV8CLBP8898", "USDOT-45100", ros::Time(10.0));
+    auto second = scheduler.start("1FUJGHDV0CLBP8834", "USDOT-45101", ros::Time(10.5));
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_EQ("USDOT-45100", first->static_id);
+    EXPECT_EQ(1, first->attempt);
+    EXPECT_EQ(36u, first->plan_id.size());
+    EXPECT_NE(first->plan_id, second->plan_id);
+
+    // a running inspection is not restarted and the scheduler is full
+    EXPECT_FALSE(scheduler.start("1FUJGBDV8CLBP8898", "USDOT-45100", ros::Time(11.0)));
+    EXPECT_EQ(first->plan_id, scheduler.planId("1FUJGBDV8CLBP8898"));
+    EXPECT_FALSE(scheduler.start("1FUJGHDV9CLBP8833", "USDOT-45102", ros::Time(11.0)));
+    EXPECT_EQ("", scheduler.planId("1FUJGHDV9CLBP8833"));
+
+    // answers are matched by plan id first and by VIN otherwise
+    auto result = scheduler.complete(second->plan_id, "unknown", ros::Time(11.0));
+    ASSERT_TRUE(result);
+    EXPECT_EQ("1FUJGHDV0CLBP8834", result->vin);
+    EXPECT_TRUE(result->success);
+    EXPECT_DOUBLE_EQ(0.5, result->latency.toSec());
+    result = scheduler.complete("", "1FUJGBDV8CLBP8898", ros::Time(11.5));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(first->plan_id, result->plan_id);
+    EXPECT_DOUBLE_EQ(1.5, result->latency.toSec());
+    EXPECT_FALSE(scheduler.complete("", "1FUJGBDV8CLBP8898", ros::Time(12.0)));
+    EXPECT_EQ(0u, scheduler.size());
+}
+
+TEST(InspectionSchedulerTest, TestRetriesWithBackoff)
+{
+    InspectionScheduler scheduler(4, ros::Duration(2.0), ros::Duration(3.0), 3);
+    ASSERT_TRUE(scheduler.start("A", "USDOT-A", ros::Time(0.0)));
+    std::vector<InspectionAttempt> retries;
+    std::vector<InspectionOutcome> failures;
+
+    scheduler.poll(ros::Time(1.9), retries, failures);
+    EXPECT_TRUE(retries.empty());
+    scheduler.poll(ros::Time(2.0), retries, failures);
+    ASSERT_EQ(1u, retries.size());
+    EXPECT_EQ(2, retries[0].attempt);
+    // doubled timeout capped at the maximum
+    EXPECT_DOUBLE_EQ(3.0, retries[0].timeout.toSec());
+
+    retries.clear();
+    scheduler.poll(ros::Time(4.9), retries, failures);
+    EXPECT_TRUE(retries.empty());
+    scheduler.poll(ros::Time(5.0), retries, failures);
+    ASSERT_EQ(1u, retries.size());
+    EXPECT_EQ(3, retries[0].attempt);
+    EXPECT_TRUE(failures.empty());
+
+    retries.clear();
+    scheduler.poll(ros::Time(8.0), retries, failures);
+    EXPECT_TRUE(retries.empty());
+    ASSERT_EQ(1u, failures.size());
+    EXPECT_FALSE(failures[0].success);
+    EXPECT_EQ(3, failures[0].attempts);
+    EXPECT_EQ(0u, scheduler.size());
+}
+
+TEST(InspectionSchedulerTest, TestLatencyIncludesRetries)
+{
+    InspectionScheduler scheduler(4, ros::Duration(1.0), ros::Duration(8.0), 4);
+    ASSERT_TRUE(scheduler.start("A", "USDOT-A", ros::Time(0.0)));
+    std::vector<InspectionAttempt> retries;
+    std::vector<InspectionOutcome> failures;
+    scheduler.poll(ros::Time(1.0), retries, failures);
+    ASSERT_EQ(1u, retries.size());
+    EXPECT_DOUBLE_EQ(2.0, retries[0].timeout.toSec());
+
+    auto result = scheduler.complete("", "A", ros::Time(1.5));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(2, result->attempts);
+    EXPECT_DOUBLE_EQ(1.5, result->latency.toSec());
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gtest/gtest.h>
+#include "truck_session_table.h"
+
+using truck_inspection_plugin::TruckSessionTable;
+
+TEST(TruckSessionTableTest, TestSafetyLogChanges)
+{
+    TruckSessionTable table(4, ros::Duration(60.0));
+    EXPECT_TRUE(table.updateSafetyLog("1FUJGBDV8CLBP8898", "vin_number:1FUJGBDV8CLBP8898,iss_score:75", ros::Time(1.0)));
+    EXPECT_FALSE(table.updateSafetyLog("1FUJGBDV8CLBP8898", "vin_number:1FUJGBDV8CLBP8898,iss_score:75", ros::Time(2.0)));
+    EXPECT_TRUE(table.updateSafetyLog("1FUJGHDV0CLBP8834", "vin_number:1FUJGHDV0CLBP8834,iss_score:49", ros::Time(3.0)));
+    EXPECT_TRUE(table.updateSafetyLog("1FUJGBDV8CLBP8898", "vin_number:1FUJGBDV8CLBP8898,iss_score:80", ros::Time(4.0)));
+    EXPECT_EQ(2u, table.size());
+    ASSERT_NE(nullptr, table.find("1FUJGBDV8CLBP8898"));
+    EXPECT_EQ("vin_number:1FUJGBDV8CLBP8898,iss_score:80", table.find("1FUJGBDV8CLBP8898")->safety_log);
+
+    // a new inspection request publishes unchanged logs again
+    table.clearSafetyLog("1FUJGHDV0CLBP8834");
+    EXPECT_FALSE(table.updateSafetyLog("1FUJGBDV8CLBP8898", "vin_number:1FUJGBDV8CLBP8898,iss_score:80", ros::Time(5.0)));
+    EXPECT_TRUE(table.updateSafetyLog("1FUJGHDV0CLBP8834", "vin_number:1FUJGHDV0CLBP8834,iss_score:49", ros::Time(5.0)));
+}
+
+TEST(TruckSessionTableTest, TestBoundedSize)
+{
+    TruckSessionTable table(2, ros::Duration(60.0));
+    table.touch("A", ros::Time(1.0));
+    table.touch("B", ros::Time(2.0));
+    table.touch("A", ros::Time(3.0));
+    table.touch("C", ros::Time(4.0));
+    EXPECT_EQ(2u, table.size());
+    EXPECT_NE(nullptr, table.find("A"));
+    EXPECT_EQ(nullptr, table.find("B"));
+    EXPECT_NE(nullptr, table.find("C"));
+}
+
+TEST(TruckSessionTableTest, TestExpiry)
+{
+    TruckSessionTable table(4, ros::Duration(10.0));
+    table.touch("A", ros::Time(1.0));
+    table.updateSafetyLog("B", "vin_number:B", ros::Time(5.0));
+    EXPECT_EQ(0u, table.expire(ros::Time(11.0)));
+    EXPECT_EQ(1u, table.expire(ros::Time(12.0)));
+    EXPECT_EQ(nullptr, table.find("A"));
+    EXPECT_EQ(1u, table.expire(ros::Time(20.0)));
+    EXPECT_EQ(0u, table.size());
+
+    // an expired truck coming back is a new session
+    EXPECT_TRUE(table.updateSafetyLog("B", "vin_number:B", ros::Time(21.0)));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <ros/ros.h>
+#include <std_msgs/String.h>
+#include <carma_utils/CARMAUtils.h>
+#include <j2735_convertor/RemoteVehicleSnapshot.h>
+#include <j2735_convertor/LaneSignalStateList.h>
+#include <ui_gateway/UIUpdate.h>
+#include "ui_state.h"
+
+namespace ui_gateway
+{
+
+    class UIGateway
+    {
+
+    public:
+
+        // general starting point of this node
+        void run();
+
+    private:
+
+        // node handles
+        std::shared_ptr<ros::CARMANodeHandle> nh_, pnh_;
+
+        // publisher for the decimated updates sent to the UI through rosbridge
+        ros::Publisher ui_update_pub_;
+
+        // subscribers for the full rate topics shown by the UI
+        ros::Subscriber truck_safety_info_sub_;
+        ros::Subscriber cav_truck_identified_sub_;
+        ros::Subscriber remote_vehicles_sub_;
+        ros::Subscriber signal_state_sub_;
+
+        ros::Timer update_timer_;
+
+        // initialize this node
+        void initialize();
+
+        // callbacks for the subscribers
+        void truckSafetyInfoCallback(const std_msgs::StringConstPtr& msg);
+        void cavTruckIdentifiedCallback(const std_msgs::StringConstPtr& msg);
+        void remoteVehiclesCallback(const j2735_convertor::RemoteVehicleSnapshotConstPtr& msg);
+        void signalStateCallback(const j2735_convertor::LaneSignalStateListConstPtr& msg);
+
+        // a new UI has to start from the full state
+        void uiConnectCallback(const ros::SingleSubscriberPublisher& pub);
+
+        // publish the changes collected since the previous update
+        void updateTimerCallback(const ros::TimerEvent& event);
+
+        UIState state_;
+
+        // updates between two keyframes, 0 sends only the keyframes requested by new subscribers
+        int keyframe_interval_ = 50;
+        int updates_since_keyframe_ = 0;
+
+        // seconds without a signal state of a lane connection after which the UI drops it
+        double signal_max_age_ = 2.0;
+        bool keyframe_requested_ = true;
+
+        // update reused for every publication
+        UIUpdate update_;
+
+    };
+
+}
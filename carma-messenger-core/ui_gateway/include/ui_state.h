@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ros/time.h>
+#include <j2735_convertor/RemoteVehicleSnapshot.h>
+#include <j2735_convertor/LaneSignalStateList.h>
+#include <ui_gateway/UIUpdate.h>
+
+namespace ui_gateway
+{
+
+    /**
+     * @class UIState
+     * @brief State shown by the UI widgets, collected from the full rate topics and handed out as changes
+     *
+     * Inputs only overwrite the stored state, so any number of messages between two updates cost one entry each in
+     * the next update. Vehicles and signal states are compared field by field and only the changed ones are sent.
+     * Signal states of intersections which are no longer received expire like vehicles missing from a snapshot.
+     * Safety logs are kept per truck, so the logs of several trucks between two updates are all sent.
+     */
+    class UIState
+    {
+
+    public:
+
+        // store the safety log under the VIN it carries, the logs of other trucks are kept
+        void setTruckSafetyInfo(const std::string& safety_info);
+
+        void setCavTruckIdentified(const std::string& identification);
+
+        // replace the tracked vehicles, vehicles missing from the snapshot are reported as removed
+        void setVehicles(const j2735_convertor::RemoteVehicleSnapshot& snapshot);
+
+        // update the signal states of the lane connections in the list, other connections keep their state
+        void setSignalStates(const j2735_convertor::LaneSignalStateList& states, const ros::Time& now);
+
+        // lane connections last received before oldest are reported as removed by the next update
+        void expireSignalStates(const ros::Time& oldest);
+
+        /**
+         * @brief Fill an update with the changes since the previous update
+         * @param keyframe If true the update carries the full state
+         * @param update Receives the changes. Its lists are cleared first
+         * @return false if there is nothing to send
+         */
+        bool buildUpdate(bool keyframe, UIUpdate& update);
+
+        // forget removed vehicles and expired signal states without an update, while nobody would receive it
+        void discardRemoved();
+
+        // VIN in the vin_number entry of a safety log, empty if there is none
+        static std::string safetyInfoVin(const std::string& safety_info);
+
+        // safety logs kept at most, the least recently updated truck is dropped first
+        static constexpr size_t MAX_TRUCKS = 64;
+
+    private:
+
+        struct Vehicle
+        {
+            UIVehicle state;
+            bool changed = false;
+            bool seen = false;
+        };
+
+        struct Signal
+        {
+            UISignalState state;
+            bool changed = false;
+            bool expired = false;
+            ros::Time last_seen;
+        };
+
+        struct TruckSafetyInfo
+        {
+            std::string safety_info;
+            bool changed = false;
+            uint64_t updated = 0;
+        };
+
+        // keyed by VIN
+        std::unordered_map<std::string, TruckSafetyInfo> trucks_;
+        uint64_t truck_updates_ = 0;
+        std::string cav_truck_identified_;
+        bool cav_truck_identified_changed_ = false;
+
+        // vehicles missing from the latest snapshot stay until the next update reports them as removed
+        std::unordered_map<uint32_t, Vehicle> vehicles_;
+
+        // keyed by intersection id, lane id and connecting lane id. Expired connections stay until the next update
+        // reports them as removed
+        std::unordered_map<uint32_t, Signal> signals_;
+
+        uint32_t sequence_ = 0;
+
+    };
+
+}
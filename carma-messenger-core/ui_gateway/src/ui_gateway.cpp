@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include "ui_gateway.h"
+
+namespace ui_gateway
+{
+
+    void UIGateway::initialize()
+    {
+        nh_.reset(new ros::CARMANodeHandle());
+        pnh_.reset(new ros::CARMANodeHandle("~"));
+        // the UI refreshes its pages at this interval in ms, faster updates would not be shown
+        int page_refresh_interval = 100;
+        nh_->param<int>("page_refresh_interval", page_refresh_interval, page_refresh_interval);
+        pnh_->param<int>("keyframe_interval", keyframe_interval_, keyframe_interval_);
+        pnh_->param<double>("signal_max_age", signal_max_age_, signal_max_age_);
+        ui_update_pub_ = nh_->advertise<UIUpdate>("ui_update", 1, boost::bind(&UIGateway::uiConnectCallback, this, _1));
+        truck_safety_info_sub_ = nh_->subscribe("truck_safety_info", 5, &UIGateway::truckSafetyInfoCallback, this);
+        cav_truck_identified_sub_ = nh_->subscribe("cav_truck_identified", 5, &UIGateway::cavTruckIdentifiedCallback, this);
+        remote_vehicles_sub_ = nh_->subscribe("remote_vehicles", 1, &UIGateway::remoteVehiclesCallback, this);
+        signal_state_sub_ = nh_->subscribe("incoming_lane_signal_state", 1, &UIGateway::signalStateCallback, this);
+        update_timer_ = nh_->createTimer(ros::Duration(std::max(page_refresh_interval, 1) / 1000.0), &UIGateway::updateTimerCallback, this);
+        ROS_INFO_STREAM("UI gateway is initialized...");
+    }
+
+    void UIGateway::run()
+    {
+        initialize();
+        ros::CARMANodeHandle::spin();
+    }
+
+    void UIGateway::truckSafetyInfoCallback(const std_msgs::StringConstPtr& msg)
+    {
+        state_.setTruckSafetyInfo(msg->data);
+    }
+
+    void UIGateway::cavTruckIdentifiedCallback(const std_msgs::StringConstPtr& msg)
+    {
+        state_.setCavTruckIdentified(msg->data);
+    }
+
+    void UIGateway::remoteVehiclesCallback(const j2735_convertor::RemoteVehicleSnapshotConstPtr& msg)
+    {
+        state_.setVehicles(*msg);
+    }
+
+    void UIGateway::signalStateCallback(const j2735_convertor::LaneSignalStateListConstPtr& msg)
+    {
+        state_.setSignalStates(*msg, ros::Time::now());
+    }
+
+    void UIGateway::uiConnectCallback(const ros::SingleSubscriberPublisher& pub)
+    {
+        keyframe_requested_ = true;
+    }
+
+    void UIGateway::updateTimerCallback(const ros::TimerEvent& event)
+    {
+        // lane connections of intersections out of range or no longer broadcasting
+        state_.expireSignalStates(ros::Time::now() - ros::Duration(signal_max_age_));
+        if(ui_update_pub_.getNumSubscribers() == 0)
+        {
+            // the next subscriber triggers a keyframe, so changes until then need not be kept
+            state_.discardRemoved();
+            return;
+        }
+        bool keyframe = keyframe_requested_ || (keyframe_interval_ > 0 && updates_since_keyframe_ >= keyframe_interval_);
+        if(state_.buildUpdate(keyframe, update_))
+        {
+            ui_update_pub_.publish(update_);
+            updates_since_keyframe_ = keyframe ? 0 : updates_since_keyframe_ + 1;
+            keyframe_requested_ = false;
+        }
+    }
+
+}
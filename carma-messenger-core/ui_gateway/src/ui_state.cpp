@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <j2735_convertor/vehicle_tracker.h>
+#include "ui_state.h"
+
+namespace ui_gateway
+{
+
+    namespace
+    {
+        bool sameVehicle(const UIVehicle& a, const UIVehicle& b)
+        {
+            return a.latitude == b.latitude && a.longitude == b.longitude && a.speed == b.speed &&
+                   a.heading == b.heading && a.static_id == b.static_id;
+        }
+
+        bool sameSignal(const UISignalState& a, const UISignalState& b)
+        {
+            return a.phase == b.phase && a.min_end_time == b.min_end_time && a.signal_group == b.signal_group;
+        }
+    }
+
+    std::string UIState::safetyInfoVin(const std::string& safety_info)
+    {
+        static const std::string key = "vin_number:";
+        size_t start = 0;
+        while(start <= safety_info.size())
+        {
+            size_t end = safety_info.find(',', start);
+            if(end == std::string::npos)
+            {
+                end = safety_info.size();
+            }
+            if(safety_info.compare(start, key.size(), key) == 0 && start + key.size() <= end)
+            {
+                return safety_info.substr(start + key.size(), end - start - key.size());
+            }
+            start = end + 1;
+        }
+        return "";
+    }
+
+    void UIState::setTruckSafetyInfo(const std::string& safety_info)
+    {
+        std::string vin = safetyInfoVin(safety_info);
+        auto it = trucks_.find(vin);
+        if(it == trucks_.end())
+        {
+            if(trucks_.size() >= MAX_TRUCKS)
+            {
+                trucks_.erase(std::min_element(trucks_.begin(), trucks_.end(), [](const auto& a, const auto& b) {
+                    return a.second.updated < b.second.updated;
+                }));
+            }
+            it = trucks_.emplace(vin, TruckSafetyInfo()).first;
+            it->second.changed = true;
+        } else if(it->second.safety_info != safety_info) {
+            it->second.changed = true;
+        }
+        it->second.safety_info = safety_info;
+        it->second.updated = ++truck_updates_;
+    }
+
+    void UIState::setCavTruckIdentified(const std::string& identification)
+    {
+        if(identification != cav_truck_identified_)
+        {
+            cav_truck_identified_ = identification;
+            cav_truck_identified_changed_ = true;
+        }
+    }
+
+    void UIState::setVehicles(const j2735_convertor::RemoteVehicleSnapshot& snapshot)
+    {
+        for(auto& entry : vehicles_)
+        {
+            entry.second.seen = false;
+        }
+
+        for(const j2735_convertor::RemoteVehicle& remote : snapshot.vehicles)
+        {
+            uint32_t id;
+            if(!j2735_convertor::VehicleTracker::bsmId(remote.bsm, id))
+            {
+                continue;
+            }
+            UIVehicle state;
+            state.id = id;
+            state.static_id = remote.static_id;
+            state.latitude = remote.bsm.core_data.latitude;
+            state.longitude = remote.bsm.core_data.longitude;
+            state.speed = remote.bsm.core_data.speed;
+            state.heading = remote.bsm.core_data.heading;
+
+            // a vehicle lost and back within one update was never gone for the UI
+            auto it = vehicles_.find(id);
+            if(it == vehicles_.end())
+            {
+                it = vehicles_.emplace(id, Vehicle()).first;
+                it->second.changed = true;
+            } else if(!sameVehicle(it->second.state, state)) {
+                it->second.changed = true;
+            }
+            it->second.state = state;
+            it->second.seen = true;
+        }
+
+    }
+
+    void UIState::setSignalStates(const j2735_convertor::LaneSignalStateList& states, const ros::Time& now)
+    {
+        for(const j2735_convertor::LaneSignalState& lane : states.lane_signal_state_list)
+        {
+            UISignalState state;
+            state.intersection_id = lane.intersection_id;
+            state.lane_id = lane.lane_id;
+            state.connecting_lane_id = lane.connecting_lane_id;
+            state.signal_group = lane.signal_group;
+            if(lane.movement_state_exists && !lane.movement_state.movement_event_list.empty())
+            {
+                // the first event of a movement is the current one
+                const cav_msgs::MovementEvent& event = lane.movement_state.movement_event_list.front();
+                state.phase = event.event_state.movement_phase_state;
+                state.min_end_time = event.timing_exists ? event.timing.min_end_time : 0.0;
+            }
+
+            uint32_t key = static_cast<uint32_t>(lane.intersection_id) << 16 | lane.lane_id << 8 | lane.connecting_lane_id;
+            auto it = signals_.find(key);
+            if(it == signals_.end())
+            {
+                it = signals_.emplace(key, Signal()).first;
+                it->second.changed = true;
+            } else if(!sameSignal(it->second.state, state)) {
+                it->second.changed = true;
+            }
+            it->second.state = state;
+            it->second.last_seen = now;
+            it->second.expired = false;
+        }
+    }
+
+    void UIState::expireSignalStates(const ros::Time& oldest)
+    {
+        for(auto& entry : signals_)
+        {
+            if(entry.second.last_seen < oldest)
+            {
+                entry.second.expired = true;
+            }
+        }
+    }
+
+    void UIState::discardRemoved()
+    {
+        for(auto it = vehicles_.begin(); it != vehicles_.end();)
+        {
+            it = it->second.seen ? std::next(it) : vehicles_.erase(it);
+        }
+        for(auto it = signals_.begin(); it != signals_.end();)
+        {
+            it = it->second.expired ? signals_.erase(it) : std::next(it);
+        }
+    }
+
+    bool UIState::buildUpdate(bool keyframe, UIUpdate& update)
+    {
+        update.keyframe = keyframe;
+        update.cav_truck_identified_changed = keyframe || cav_truck_identified_changed_;
+        update.cav_truck_identified = update.cav_truck_identified_changed ? cav_truck_identified_ : "";
+        cav_truck_identified_changed_ = false;
+
+        update.truck_safety_info.clear();
+        for(auto& entry : trucks_)
+        {
+            if(keyframe || entry.second.changed)
+            {
+                UITruckSafetyInfo info;
+                info.vin = entry.first;
+                info.safety_info = entry.second.safety_info;
+                update.truck_safety_info.push_back(info);
+            }
+            entry.second.changed = false;
+        }
+
+        update.vehicles.clear();
+        update.removed_vehicles.clear();
+        for(auto it = vehicles_.begin(); it != vehicles_.end();)
+        {
+            if(!it->second.seen)
+            {
+                // a keyframe replaces the whole vehicle list of the UI
+                if(!keyframe)
+                {
+                    update.removed_vehicles.push_back(it->first);
+                }
+                it = vehicles_.erase(it);
+                continue;
+            }
+            if(keyframe || it->second.changed)
+            {
+                update.vehicles.push_back(it->second.state);
+            }
+            it->second.changed = false;
+            ++it;
+        }
+
+        update.signal_states.clear();
+        update.removed_signal_states.clear();
+        for(auto it = signals_.begin(); it != signals_.end();)
+        {
+            if(it->second.expired)
+            {
+                // a keyframe replaces all signal states of the UI
+                if(!keyframe)
+                {
+                    UISignalState removed;
+                    removed.intersection_id = it->second.state.intersection_id;
+                    removed.lane_id = it->second.state.lane_id;
+                    removed.connecting_lane_id = it->second.state.connecting_lane_id;
+                    update.removed_signal_states.push_back(removed);
+                }
+                it = signals_.erase(it);
+                continue;
+            }
+            if(keyframe || it->second.changed)
+            {
+                update.signal_states.push_back(it->second.state);
+            }
+            it->second.changed = false;
+            ++it;
+        }
+
+        if(!keyframe && update.truck_safety_info.empty() && !update.cav_truck_identified_changed &&
+           update.vehicles.empty() && update.removed_vehicles.empty() && update.signal_states.empty() &&
+           update.removed_signal_states.empty())
+        {
+            return false;
+        }
+        update.sequence = ++sequence_;
+        return true;
+    }
+
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gtest/gtest.h>
+#include "ui_state.h"
+
+using ui_gateway::UIState;
+using ui_gateway::UIUpdate;
+
+j2735_convertor::RemoteVehicle makeVehicle(uint8_t id, double latitude)
+{
+    j2735_convertor::RemoteVehicle vehicle;
+    vehicle.bsm.core_data.id = {0, 0, 0, id};
+    vehicle.bsm.core_data.latitude = latitude;
+    return vehicle;
+}
+
+TEST(UIStateTest, TestStringsOnlyOnChange)
+{
+    UIState state;
+    UIUpdate update;
+    EXPECT_FALSE(state.buildUpdate(false, update));
+
+    state.setTruckSafetyInfo("vin_number:1FUJGBDV8CLBP8898,iss_score:75");
+    state.setTruckSafetyInfo("vin_number:1FUJGBDV8CLBP8898,iss_score:80");
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    EXPECT_EQ(1u, update.sequence);
+    ASSERT_EQ(1u, update.truck_safety_info.size());
+    EXPECT_EQ("1FUJGBDV8CLBP8898", update.truck_safety_info[0].vin);
+    EXPECT_EQ("vin_number:1FUJGBDV8CLBP8898,iss_score:80", update.truck_safety_info[0].safety_info);
+    EXPECT_FALSE(update.cav_truck_identified_changed);
+
+    state.setTruckSafetyInfo("vin_number:1FUJGBDV8CLBP8898,iss_score:80");
+    EXPECT_FALSE(state.buildUpdate(false, update));
+
+    // an empty identification is a change as well
+    state.setCavTruckIdentified("vin_number:1FUJGBDV8CLBP8898,license_plate:ABC123");
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    state.setCavTruckIdentified("");
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    EXPECT_TRUE(update.cav_truck_identified_changed);
+    EXPECT_TRUE(update.cav_truck_identified.empty());
+
+    state.setCavTruckIdentified("vin_number:1FUJGBDV8CLBP8898,license_plate:ABC123");
+    ASSERT_TRUE(state.buildUpdate(true, update));
+    EXPECT_EQ(4u, update.sequence);
+    EXPECT_TRUE(update.keyframe);
+    ASSERT_EQ(1u, update.truck_safety_info.size());
+    EXPECT_EQ("vin_number:1FUJGBDV8CLBP8898,iss_score:80", update.truck_safety_info[0].safety_info);
+    EXPECT_TRUE(update.cav_truck_identified_changed);
+    EXPECT_EQ("vin_number:1FUJGBDV8CLBP8898,license_plate:ABC123", update.cav_truck_identified);
+}
+
+TEST(UIStateTest, TestSafetyInfoPerTruck)
+{
+    UIState state;
+    UIUpdate update;
+    EXPECT_EQ("1FUJGBDV8CLBP8898", UIState::safetyInfoVin("iss_score:75,vin_number:1FUJGBDV8CLBP8898"));
+    EXPECT_EQ("", UIState::safetyInfoVin("iss_score:75,vin:1FUJGBDV8CLBP8898"));
+
+    // logs of two trucks between two updates are both sent
+    state.setTruckSafetyInfo("vin_number:1FUJGBDV8CLBP8898,iss_score:75");
+    state.setTruckSafetyInfo("vin_number:3AKJGLD51FSGA6042,iss_score:20");
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    EXPECT_EQ(2u, update.truck_safety_info.size());
+
+    state.setTruckSafetyInfo("vin_number:3AKJGLD51FSGA6042,iss_score:25");
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    ASSERT_EQ(1u, update.truck_safety_info.size());
+    EXPECT_EQ("3AKJGLD51FSGA6042", update.truck_safety_info[0].vin);
+
+    // the least recently updated truck is dropped once the limit is reached
+    for(size_t i = 2; i < UIState::MAX_TRUCKS + 1; i++)
+    {
+        state.setTruckSafetyInfo("vin_number:" + std::to_string(i) + ",iss_score:50");
+    }
+    ASSERT_TRUE(state.buildUpdate(true, update));
+    ASSERT_EQ(static_cast<size_t>(UIState::MAX_TRUCKS), update.truck_safety_info.size());
+    for(const ui_gateway::UITruckSafetyInfo& info : update.truck_safety_info)
+    {
+        EXPECT_NE("1FUJGBDV8CLBP8898", info.vin);
+    }
+}
+
+TEST(UIStateTest, TestVehicleChanges)
+{
+    UIState state;
+    UIUpdate update;
+    j2735_convertor::RemoteVehicleSnapshot snapshot;
+    snapshot.vehicles = {makeVehicle(1, 38.95), makeVehicle(2, 38.96)};
+    state.setVehicles(snapshot);
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    EXPECT_EQ(2u, update.vehicles.size());
+
+    // unchanged vehicles are not sent again
+    state.setVehicles(snapshot);
+    EXPECT_FALSE(state.buildUpdate(false, update));
+
+    snapshot.vehicles = {makeVehicle(2, 38.97), makeVehicle(3, 38.98)};
+    state.setVehicles(snapshot);
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    ASSERT_EQ(2u, update.vehicles.size());
+    ASSERT_EQ(1u, update.removed_vehicles.size());
+    EXPECT_EQ(1u, update.removed_vehicles[0]);
+
+    // a vehicle lost for one snapshot between two updates is not removed
+    state.setVehicles(j2735_convertor::RemoteVehicleSnapshot());
+    state.setVehicles(snapshot);
+    EXPECT_FALSE(state.buildUpdate(false, update));
+
+    ASSERT_TRUE(state.buildUpdate(true, update));
+    EXPECT_EQ(2u, update.vehicles.size());
+    EXPECT_TRUE(update.removed_vehicles.empty());
+}
+
+TEST(UIStateTest, TestSignalStateChanges)
+{
+    UIState state;
+    UIUpdate update;
+    j2735_convertor::LaneSignalStateList states;
+    states.lane_signal_state_list.resize(2);
+    states.lane_signal_state_list[0].intersection_id = 9945;
+    states.lane_signal_state_list[0].lane_id = 1;
+    states.lane_signal_state_list[0].connecting_lane_id = 5;
+    states.lane_signal_state_list[1].intersection_id = 9945;
+    states.lane_signal_state_list[1].lane_id = 2;
+    states.lane_signal_state_list[1].connecting_lane_id = 6;
+    state.setSignalStates(states, ros::Time(100.0));
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    EXPECT_EQ(2u, update.signal_states.size());
+
+    states.lane_signal_state_list[1].movement_state_exists = true;
+    states.lane_signal_state_list[1].movement_state.movement_event_list.resize(1);
+    states.lane_signal_state_list[1].movement_state.movement_event_list[0].event_state.movement_phase_state = 6;
+    state.setSignalStates(states, ros::Time(100.1));
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    ASSERT_EQ(1u, update.signal_states.size());
+    EXPECT_EQ(2u, update.signal_states[0].lane_id);
+    EXPECT_EQ(6u, update.signal_states[0].phase);
+}
+
+TEST(UIStateTest, TestSignalStateExpiry)
+{
+    UIState state;
+    UIUpdate update;
+    j2735_convertor::LaneSignalStateList first, second;
+    first.lane_signal_state_list.resize(1);
+    first.lane_signal_state_list[0].intersection_id = 9945;
+    first.lane_signal_state_list[0].lane_id = 1;
+    first.lane_signal_state_list[0].connecting_lane_id = 5;
+    second.lane_signal_state_list.resize(1);
+    second.lane_signal_state_list[0].intersection_id = 9946;
+    second.lane_signal_state_list[0].lane_id = 3;
+    state.setSignalStates(first, ros::Time(100.0));
+    state.setSignalStates(second, ros::Time(100.0));
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    EXPECT_EQ(2u, update.signal_states.size());
+
+    // only the second intersection is still received
+    state.setSignalStates(second, ros::Time(102.0));
+    state.expireSignalStates(ros::Time(101.0));
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    EXPECT_TRUE(update.signal_states.empty());
+    ASSERT_EQ(1u, update.removed_signal_states.size());
+    EXPECT_EQ(9945u, update.removed_signal_states[0].intersection_id);
+    EXPECT_EQ(1u, update.removed_signal_states[0].lane_id);
+    EXPECT_EQ(5u, update.removed_signal_states[0].connecting_lane_id);
+
+    // removed once, the keyframe only holds the second intersection
+    EXPECT_FALSE(state.buildUpdate(false, update));
+    ASSERT_TRUE(state.buildUpdate(true, update));
+    ASSERT_EQ(1u, update.signal_states.size());
+    EXPECT_EQ(9946u, update.signal_states[0].intersection_id);
+
+    // an intersection received again before the update is not removed
+    state.setSignalStates(first, ros::Time(103.0));
+    state.expireSignalStates(ros::Time(103.5));
+    state.setSignalStates(first, ros::Time(104.0));
+    ASSERT_TRUE(state.buildUpdate(false, update));
+    ASSERT_EQ(1u, update.signal_states.size());
+    EXPECT_EQ(9945u, update.signal_states[0].intersection_id);
+    ASSERT_EQ(1u, update.removed_signal_states.size());
+    EXPECT_EQ(9946u, update.removed_signal_states[0].intersection_id);
+
+    // without subscribers expired signal states are dropped unreported
+    state.expireSignalStates(ros::Time(110.0));
+    state.discardRemoved();
+    EXPECT_FALSE(state.buildUpdate(false, update));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -12,94 +12,125 @@ CarmaJS.WidgetFramework.truckInspection = (function () {
     //Therefore this needs to be hardcoded.
     var installfoldername = 'widgets/truckInspection/';
     var isTimeoutSet = false;
+    //Safety logs keyed by upper case VIN, and the VIN whose log was requested
+    var truckSafetyInfo = {};
+    var requestedVIN = null;
 
     var SafetyLogListNotify = function () {
 
-        listenerSaftyLogList = new ROSLIB.Topic({
+        listenerUIUpdate = new ROSLIB.Topic({
             ros: ros,
-            name: '/cav_truck_identified',
-            messageType: 'std_msgs/String'
+            name: '/ui_update',
+            messageType: 'ui_gateway/UIUpdate',
+            //plain JSON for now, the gateway already sends only the changes at the page refresh rate
+            compression: 'none'
         });
         try{
-                console.log("/cav_truck_identified topic called");
-                listenerSaftyLogList.subscribe(function (message) {
-                    console.log("/cav_truck_identified message.data: "+ message.data);                 
-                
-                    if (message.data != null && message.data != 'undefined' && message.data.length > 0){
-                        let rawStr = message.data;
-                        let rawArr = rawStr.split(",");
-                        let state = "";
-                        let license_plate = "";
-                        let vin_number = "";
-                        rawArr.forEach(element => {
-                            let rawElement = element.split(":");
-                            let key = rawElement[0].trim().toUpperCase();
-                            let value=rawElement[1].trim().toUpperCase();
-                            console.log(value);
-                            if(key == "VIN_NUMBER" || key == "V"){
-                                vin_number=value;
-                            }
-                            if(key=="LICENSE_PLATE" || key=="L"){
-                                license_plate=value;
-                            } 
-                            if(key=="STATE_SHORT_NAME" || key=="S"){
-                                state=value;
-                            }               
-                        });
-                        var button = document.getElementById('LogbtnId');
-                        var label =document.getElementById('lblLogbtnId');
-                        if(button != null){                       
-                            button.style.display='';  
-                            button.name = message.data;
-                        }                    
-                        if(label != null){  
-                            label.innerHTML = 'Automated Vehicle is within range.<br>'+ "VIN: " + vin_number+", License Plate: "+ state+" " + license_plate;                       
-                            label.style.display='';
-                        }   
-                        
-                        if(document.getElementById('NoMsgAvailableId') != null)               
-                            document.getElementById('NoMsgAvailableId').style.display='none'; 
-                        
-                        //refresh the log list information once and only once  every 30 seconds
-                        if(!isTimeoutSet){
-                            isTimeoutSet=true;
-                            console.log("isTimeoutSet: "+isTimeoutSet);
-                            setTimeout(() => {     
-                                let LogBtn=document.getElementById('LogbtnId'); 
-                                let LogLbl=document.getElementById('lblLogbtnId');
-                                let NoMsgAvailableLbl = document.getElementById('NoMsgAvailableId'); 
-                                if(LogBtn!=null)
-                                    LogBtn.style.display='none';
-                                if(LogLbl!=null)
-                                    LogLbl.style.display='none'; 
-                                if(NoMsgAvailableLbl!=null)
-                                    NoMsgAvailableLbl.style.display='';                                       
-                                //once timeout is called, reset isTimeout
-                                isTimeoutSet=false;
-                                console.log("log list is hide after "+CarmaJS.Config.getRefreshInterval()+" seconds." );
-                            }, CarmaJS.Config.getRefreshInterval()*1000);
+                console.log("/ui_update topic called");
+                listenerUIUpdate.subscribe(function (message) {
+                    //a keyframe carries every stored safety log
+                    let previous = truckSafetyInfo;
+                    if(message.keyframe){
+                        truckSafetyInfo = {};
+                    }
+                    message.truck_safety_info.forEach(info => {
+                        let vin_number = info.vin.toUpperCase();
+                        truckSafetyInfo[vin_number] = info.safety_info;
+                        if(vin_number == requestedVIN && previous[vin_number] != info.safety_info){
+                            ShowSafetyLogPerVIN(info.safety_info);
                         }
-                       
+                    });
+
+                    if (message.cav_truck_identified_changed){
+                        console.log("/ui_update cav_truck_identified: "+ message.cav_truck_identified);
+                        ShowCavTruckIdentified(message.cav_truck_identified);
                     }
             });
         }catch(ex){
             console.error("error");
         }
     };
-    var SubscribeToSafetyLog = function(){
-        console.log("function subscribeToSafetyLog: called");
-        listenerSaftyLogPerVIN = new ROSLIB.Topic({
-            ros: ros,
-            name: '/truck_safety_info',
-            messageType: 'std_msgs/String'
-        });       
-       
-        listenerSaftyLogPerVIN.subscribe(function (message) {
-            console.log("function subscribeToSafetyLog: "+ message);
-            if (message.data != null && message.data != 'undefined') {
-                ShowSafetyLogPerVIN(message.data);
-            }           
+
+    var ShowCavTruckIdentified = function (identification) {
+        if (identification != null && identification != 'undefined' && identification.length > 0){
+            let rawStr = identification;
+            let rawArr = rawStr.split(",");
+            let state = "";
+            let license_plate = "";
+            let vin_number = "";
+            rawArr.forEach(element => {
+                let rawElement = element.split(":");
+                let key = rawElement[0].trim().toUpperCase();
+                let value=rawElement[1].trim().toUpperCase();
+                console.log(value);
+                if(key == "VIN_NUMBER" || key == "V"){
+                    vin_number=value;
+                }
+                if(key=="LICENSE_PLATE" || key=="L"){
+                    license_plate=value;
+                } 
+                if(key=="STATE_SHORT_NAME" || key=="S"){
+                    state=value;
+                }               
+            });
+            var button = document.getElementById('LogbtnId');
+            var label =document.getElementById('lblLogbtnId');
+            if(button != null){                       
+                button.style.display='';  
+                button.name = identification;
+            }                    
+            if(label != null){  
+                label.innerHTML = 'Automated Vehicle is within range.<br>'+ "VIN: " + vin_number+", License Plate: "+ state+" " + license_plate;                       
+                label.style.display='';
+            }   
+        
+            if(document.getElementById('NoMsgAvailableId') != null)               
+                document.getElementById('NoMsgAvailableId').style.display='none'; 
+        
+            //refresh the log list information once and only once  every 30 seconds
+            if(!isTimeoutSet){
+                isTimeoutSet=true;
+                console.log("isTimeoutSet: "+isTimeoutSet);
+                setTimeout(() => {     
+                    let LogBtn=document.getElementById('LogbtnId'); 
+                    let LogLbl=document.getElementById('lblLogbtnId');
+                    let NoMsgAvailableLbl = document.getElementById('NoMsgAvailableId'); 
+                    if(LogBtn!=null)
+                        LogBtn.style.display='none';
+                    if(LogLbl!=null)
+                        LogLbl.style.display='none'; 
+                    if(NoMsgAvailableLbl!=null)
+                        NoMsgAvailableLbl.style.display='';                                       
+                    //once timeout is called, reset isTimeout
+                    isTimeoutSet=false;
+                    console.log("log list is hide after "+CarmaJS.Config.getRefreshInterval()+" seconds." );
+                }, CarmaJS.Config.getRefreshInterval()*1000);
+            }
+        }
+    };
+
+    //VIN in the vin_number entry of a safety log or identification, upper case
+    var GetVIN = function (rawStr) {
+        let vin_number = "";
+        rawStr.split(",").forEach(element => {
+            let rawElement = element.split(":");
+            if(rawElement.length > 1){
+                let key = rawElement[0].trim().toUpperCase();
+                if(key == "VIN_NUMBER" || key == "V"){
+                    vin_number = rawElement[1].trim().toUpperCase();
+                }
+            }
         });
+        return vin_number;
+    };
+
+    var SubscribeToSafetyLog = function(vin_number){
+        console.log("function subscribeToSafetyLog: called");
+        //the log is shown when it arrives with the next update, or now if the latest log of the truck is known
+        requestedVIN = vin_number;
+        if(truckSafetyInfo[requestedVIN] != null){
+            ShowSafetyLogPerVIN(truckSafetyInfo[requestedVIN]);
+        }
     }
 
     var ShowSafetyLogPerVIN = function (messageData) {    
@@ -256,7 +287,7 @@ CarmaJS.WidgetFramework.truckInspection = (function () {
                 }
                 else
                 { 
-                    SubscribeToSafetyLog();
+                    SubscribeToSafetyLog(GetVIN(btn.name));
                 }
                 
             }); 